@@ -4,3 +4,30 @@
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, DataReplay, "DataReplay" );
+
+DEFINE_LOG_CATEGORY(LogDataReplay);
+
+DEFINE_STAT(STAT_DataReplay_Load);
+DEFINE_STAT(STAT_DataReplay_Evaluate);
+DEFINE_STAT(STAT_DataReplay_Tick);
+DEFINE_STAT(STAT_DataReplay_Draw);
+DEFINE_STAT(STAT_DataReplay_DrawPathRT);
+DEFINE_STAT(STAT_DataReplay_UIUpdate);
+DEFINE_STAT(STAT_DataReplay_SpatialBuild);
+DEFINE_STAT(STAT_DataReplay_SpatialQuery);
+DEFINE_STAT(STAT_DataReplay_ChannelDecode);
+DEFINE_STAT(STAT_DataReplay_ActiveActors);
+DEFINE_STAT(STAT_DataReplay_SamplesResident);
+DEFINE_STAT(STAT_DataReplay_BatchMissionsLoading);
+DEFINE_STAT(STAT_DataReplay_SegmentsDrawn);
+DEFINE_STAT(STAT_DataReplay_Seeks);
+
+TRACE_DECLARE_INT_COUNTER(DataReplay_ActiveActors, TEXT("DataReplay/Active Actors"));
+TRACE_DECLARE_INT_COUNTER(DataReplay_SamplesResident, TEXT("DataReplay/Samples Resident"));
+TRACE_DECLARE_INT_COUNTER(DataReplay_SegmentsDrawn, TEXT("DataReplay/Path Segments Drawn"));
+TRACE_DECLARE_INT_COUNTER(DataReplay_SeeksPerSecond, TEXT("DataReplay/Seeks Per Second"));
+TRACE_DECLARE_INT_COUNTER(DataReplay_BatchReservedBytes, TEXT("DataReplay/Batch Reserved Bytes"));
+
+LLM_DEFINE_TAG(DataReplay_Samples);
+LLM_DEFINE_TAG(DataReplay_Derived);
+LLM_DEFINE_TAG(DataReplay_Geometry);
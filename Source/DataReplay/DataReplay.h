@@ -3,4 +3,48 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogDataReplay, Log, All);
+
+// ========== STATISTIQUES (stat DataReplay) ==========
+
+DECLARE_STATS_GROUP(TEXT("DataReplay"), STATGROUP_DataReplay, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load"), STAT_DataReplay_Load, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Evaluate"), STAT_DataReplay_Evaluate, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tick"), STAT_DataReplay_Tick, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Draw"), STAT_DataReplay_Draw, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Draw Path (render thread)"), STAT_DataReplay_DrawPathRT, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UI Update"), STAT_DataReplay_UIUpdate, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spatial Index Build"), STAT_DataReplay_SpatialBuild, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spatial Query"), STAT_DataReplay_SpatialQuery, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Channel Decode"), STAT_DataReplay_ChannelDecode, STATGROUP_DataReplay, DATAREPLAY_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Actors"), STAT_DataReplay_ActiveActors, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Samples Resident"), STAT_DataReplay_SamplesResident, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Batch Missions Loading"), STAT_DataReplay_BatchMissionsLoading, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Path Segments Drawn"), STAT_DataReplay_SegmentsDrawn, STATGROUP_DataReplay, DATAREPLAY_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Seeks"), STAT_DataReplay_Seeks, STATGROUP_DataReplay, DATAREPLAY_API);
+
+// ========== COMPTEURS UNREAL INSIGHTS ==========
+
+TRACE_DECLARE_INT_COUNTER_EXTERN(DataReplay_ActiveActors);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DataReplay_SamplesResident);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DataReplay_SegmentsDrawn);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DataReplay_SeeksPerSecond);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DataReplay_BatchReservedBytes);
+
+// ========== MÉMOIRE (LLM) ==========
+
+// Échantillons : buffers des acteurs, tronçons résidents, données compressées
+LLM_DECLARE_TAG_API(DataReplay_Samples, DATAREPLAY_API);
+
+// Données dérivées des échantillons : coefficients de courbe, grille rééchantillonnée, index spatio-temporel
+LLM_DECLARE_TAG_API(DataReplay_Derived, DATAREPLAY_API);
+
+// Géométrie affichée : ligne de trajectoire et instances de waypoints
+LLM_DECLARE_TAG_API(DataReplay_Geometry, DATAREPLAY_API);
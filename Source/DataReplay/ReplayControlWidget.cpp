@@ -1,22 +1,33 @@
 ﻿// Fill out your copyright notice in the Description page of Project Settings.
 
 #include "ReplayControlWidget.h"
+#include "DataReplay.h"
 #include "TrajectoryReplayActor.h"
 #include "Components/Button.h"
 #include "Components/Slider.h"
 #include "Components/TextBlock.h"
 #include "Blueprint/WidgetTree.h"
 
+UReplayControlWidget::UReplayControlWidget(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	TargetReplayActor = nullptr;
+
+	// 10 Hz suffit à un affichage au dixième de seconde sans invalider le widget à chaque frame
+	TimeRefreshRate = 10.0f;
+}
+
 void UReplayControlWidget::NativeConstruct()
 {
 	Super::NativeConstruct();
 
 	bIsUpdatingSlider = false;
+	LastTimeDisplayUpdate = 0.0;
 
 	// Vérifier que tous les widgets sont bien liés
 	if (!Btn_Play || !Btn_Pause || !Btn_Stop || !Btn_ShowTrajectory || !Slider_Timeline || !Text_TimeDisplay)
 	{
-		UE_LOG(LogTemp, Error, TEXT("[ReplayControlWidget] One or more widgets are not bound! Make sure all widgets are named correctly in the UMG Blueprint."));
+		UE_LOG(LogDataReplay, Error, TEXT("[ReplayControlWidget] One or more widgets are not bound! Make sure all widgets are named correctly in the UMG Blueprint."));
 		return;
 	}
 
@@ -28,44 +39,43 @@ void UReplayControlWidget::NativeConstruct()
 
 	// Lier l'événement du slider
 	Slider_Timeline->OnValueChanged.AddDynamic(this, &UReplayControlWidget::OnTimelineSliderValueChanged);
+	Slider_Timeline->OnMouseCaptureBegin.AddDynamic(this, &UReplayControlWidget::OnTimelineScrubStarted);
+	Slider_Timeline->OnMouseCaptureEnd.AddDynamic(this, &UReplayControlWidget::OnTimelineScrubEnded);
+	Slider_Timeline->OnControllerCaptureBegin.AddDynamic(this, &UReplayControlWidget::OnTimelineScrubStarted);
+	Slider_Timeline->OnControllerCaptureEnd.AddDynamic(this, &UReplayControlWidget::OnTimelineScrubEnded);
 
-	UE_LOG(LogTemp, Log, TEXT("[ReplayControlWidget] UI Controls initialized successfully"));
+	ShowTrajectoryLabel = Cast<UTextBlock>(Btn_ShowTrajectory->GetChildAt(0));
+
+	// S'abonner à l'acteur assigné dans le Blueprint ou avant l'ajout à l'écran
+	BindToTarget();
+	RefreshAll();
+
+	UE_LOG(LogDataReplay, Log, TEXT("[ReplayControlWidget] UI Controls initialized successfully"));
 }
 
-void UReplayControlWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+void UReplayControlWidget::NativeDestruct()
 {
-	Super::NativeTick(MyGeometry, InDeltaTime);
+	// Ne pas laisser l'acteur suspendu si le widget disparaît pendant un glissement
+	if (TargetReplayActor && TargetReplayActor->IsScrubbing())
+	{
+		TargetReplayActor->EndScrub();
+	}
 
-	// Mettre à jour l'affichage et le slider si un acteur est assigné
-	if (TargetReplayActor)
+	UnbindFromTarget();
+	if (UWorld* World = GetWorld())
 	{
-		// Mettre à jour le slider pour refléter la position actuelle
-		if (!bIsUpdatingSlider && Slider_Timeline)
-		{
-			float Progress = TargetReplayActor->GetPlaybackProgress();
-			Slider_Timeline->SetValue(Progress);
-		}
+		World->GetTimerManager().ClearTimer(TimeDisplayTimer);
+	}
 
-		// Mettre à jour l'affichage du temps
-		UpdateTimeDisplay();
+	Super::NativeDestruct();
+}
 
-		// Mettre à jour le texte du bouton Show Trajectory
-		if (Btn_ShowTrajectory)
-		{
-			UTextBlock* ButtonText = Cast<UTextBlock>(Btn_ShowTrajectory->GetChildAt(0));
-			if (ButtonText)
-			{
-				if (TargetReplayActor->bShowTrajectory)
-				{
-					ButtonText->SetText(FText::FromString(TEXT("👁 Hide Path")));
-				}
-				else
-				{
-					ButtonText->SetText(FText::FromString(TEXT("👁 Show Path")));
-				}
-			}
-		}
-	}
+void UReplayControlWidget::SetTargetReplayActor(ATrajectoryReplayActor* NewTarget)
+{
+	UnbindFromTarget();
+	TargetReplayActor = NewTarget;
+	BindToTarget();
+	RefreshAll();
 }
 
 // ========== CALLBACKS DES BOUTONS ==========
@@ -75,11 +85,11 @@ void UReplayControlWidget::OnPlayButtonClicked()
 	if (TargetReplayActor)
 	{
 		TargetReplayActor->Play();
-		UE_LOG(LogTemp, Log, TEXT("[ReplayControlWidget] Play button clicked"));
+		UE_LOG(LogDataReplay, Log, TEXT("[ReplayControlWidget] Play button clicked"));
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[ReplayControlWidget] No TargetReplayActor assigned!"));
+		UE_LOG(LogDataReplay, Warning, TEXT("[ReplayControlWidget] No TargetReplayActor assigned!"));
 	}
 }
 
@@ -88,11 +98,11 @@ void UReplayControlWidget::OnPauseButtonClicked()
 	if (TargetReplayActor)
 	{
 		TargetReplayActor->Pause();
-		UE_LOG(LogTemp, Log, TEXT("[ReplayControlWidget] Pause button clicked"));
+		UE_LOG(LogDataReplay, Log, TEXT("[ReplayControlWidget] Pause button clicked"));
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[ReplayControlWidget] No TargetReplayActor assigned!"));
+		UE_LOG(LogDataReplay, Warning, TEXT("[ReplayControlWidget] No TargetReplayActor assigned!"));
 	}
 }
 
@@ -101,11 +111,11 @@ void UReplayControlWidget::OnStopButtonClicked()
 	if (TargetReplayActor)
 	{
 		TargetReplayActor->Stop();
-		UE_LOG(LogTemp, Log, TEXT("[ReplayControlWidget] Stop button clicked"));
+		UE_LOG(LogDataReplay, Log, TEXT("[ReplayControlWidget] Stop button clicked"));
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[ReplayControlWidget] No TargetReplayActor assigned!"));
+		UE_LOG(LogDataReplay, Warning, TEXT("[ReplayControlWidget] No TargetReplayActor assigned!"));
 	}
 }
 
@@ -115,11 +125,11 @@ void UReplayControlWidget::OnShowTrajectoryButtonClicked()
 	{
 		// Toggle la visibilité de la trajectoire
 		TargetReplayActor->ToggleTrajectoryVisualization();
-		UE_LOG(LogTemp, Log, TEXT("[ReplayControlWidget] Show Trajectory button clicked"));
+		UE_LOG(LogDataReplay, Log, TEXT("[ReplayControlWidget] Show Trajectory button clicked"));
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[ReplayControlWidget] No TargetReplayActor assigned!"));
+		UE_LOG(LogDataReplay, Warning, TEXT("[ReplayControlWidget] No TargetReplayActor assigned!"));
 	}
 }
 
@@ -130,26 +140,181 @@ void UReplayControlWidget::OnTimelineSliderValueChanged(float Value)
 		// Empêcher les boucles de mise à jour
 		bIsUpdatingSlider = true;
 
-		// Convertir la valeur 0-1 en pourcentage et l'appliquer
-		TargetReplayActor->SeekToProgress(Value);
+		// Pendant un glissement, seule la dernière valeur de la frame est appliquée par l'acteur
+		TargetReplayActor->ScrubToProgress(Value);
 
 		bIsUpdatingSlider = false;
 
-		UE_LOG(LogTemp, Verbose, TEXT("[ReplayControlWidget] Slider moved to %.2f%%"), Value * 100.0f);
+		UE_LOG(LogDataReplay, Verbose, TEXT("[ReplayControlWidget] Slider moved to %.2f%%"), Value * 100.0f);
+	}
+}
+
+void UReplayControlWidget::OnTimelineScrubStarted()
+{
+	if (TargetReplayActor)
+	{
+		TargetReplayActor->BeginScrub();
 	}
 }
 
+void UReplayControlWidget::OnTimelineScrubEnded()
+{
+	if (TargetReplayActor)
+	{
+		TargetReplayActor->EndScrub();
+	}
+}
+
+// ========== ÉVÉNEMENTS DE L'ACTEUR ==========
+
+void UReplayControlWidget::HandlePlaybackTimeChanged(float CurrentTime, float TotalDuration)
+{
+	RequestTimeDisplayUpdate();
+}
+
+void UReplayControlWidget::HandlePlayStateChanged(bool bIsPlaying)
+{
+	// Afficher le temps exact de la pause sans attendre la prochaine mise à jour
+	UpdateTimeDisplay();
+}
+
+void UReplayControlWidget::HandleVisibilityChanged(bool bShowTrajectory)
+{
+	UpdateShowTrajectoryLabel();
+}
+
+void UReplayControlWidget::HandleDataReloaded()
+{
+	RefreshAll();
+}
+
 // ========== MISE À JOUR DE L'AFFICHAGE ==========
 
+void UReplayControlWidget::BindToTarget()
+{
+	if (!TargetReplayActor || !Text_TimeDisplay)
+	{
+		return;
+	}
+
+	TargetReplayActor->OnPlaybackTimeChanged.AddUniqueDynamic(this, &UReplayControlWidget::HandlePlaybackTimeChanged);
+	TargetReplayActor->OnPlayStateChanged.AddUniqueDynamic(this, &UReplayControlWidget::HandlePlayStateChanged);
+	TargetReplayActor->OnVisibilityChanged.AddUniqueDynamic(this, &UReplayControlWidget::HandleVisibilityChanged);
+	TargetReplayActor->OnDataReloaded.AddUniqueDynamic(this, &UReplayControlWidget::HandleDataReloaded);
+	BoundActor = TargetReplayActor;
+}
+
+void UReplayControlWidget::UnbindFromTarget()
+{
+	if (ATrajectoryReplayActor* Actor = BoundActor.Get())
+	{
+		Actor->OnPlaybackTimeChanged.RemoveDynamic(this, &UReplayControlWidget::HandlePlaybackTimeChanged);
+		Actor->OnPlayStateChanged.RemoveDynamic(this, &UReplayControlWidget::HandlePlayStateChanged);
+		Actor->OnVisibilityChanged.RemoveDynamic(this, &UReplayControlWidget::HandleVisibilityChanged);
+		Actor->OnDataReloaded.RemoveDynamic(this, &UReplayControlWidget::HandleDataReloaded);
+	}
+	BoundActor.Reset();
+}
+
+void UReplayControlWidget::RefreshAll()
+{
+	UpdateTimeDisplay();
+	UpdateShowTrajectoryLabel();
+}
+
+void UReplayControlWidget::RequestTimeDisplayUpdate()
+{
+	UWorld* World = GetWorld();
+	if (TimeRefreshRate <= 0.0f || !World)
+	{
+		UpdateTimeDisplay();
+		return;
+	}
+
+	// Au plus une mise à jour par intervalle ; la dernière valeur reçue est affichée à la fin de l'intervalle
+	FTimerManager& TimerManager = World->GetTimerManager();
+	if (TimerManager.IsTimerActive(TimeDisplayTimer))
+	{
+		return;
+	}
+
+	const double Interval = 1.0 / TimeRefreshRate;
+	const double Elapsed = FPlatformTime::Seconds() - LastTimeDisplayUpdate;
+	if (Elapsed >= Interval)
+	{
+		UpdateTimeDisplay();
+	}
+	else
+	{
+		TimerManager.SetTimer(TimeDisplayTimer, this, &UReplayControlWidget::UpdateTimeDisplay, static_cast<float>(Interval - Elapsed), false);
+	}
+}
+
 void UReplayControlWidget::UpdateTimeDisplay()
 {
-	if (TargetReplayActor && Text_TimeDisplay)
+	LastTimeDisplayUpdate = FPlatformTime::Seconds();
+	if (UWorld* World = GetWorld())
 	{
-		float CurrentTime = TargetReplayActor->CurrentPlaybackTime;
-		float TotalTime = TargetReplayActor->TotalDuration;
+		World->GetTimerManager().ClearTimer(TimeDisplayTimer);
+	}
 
-		// Formater le texte : "12.5 / 30.0 s"
-		FString TimeText = FString::Printf(TEXT("%.1f / %.1f s"), CurrentTime, TotalTime);
+	if (!TargetReplayActor)
+	{
+		return;
+	}
+
+	// Mettre à jour le slider pour refléter la position actuelle (pas pendant que l'utilisateur le déplace)
+	if (!bIsUpdatingSlider && Slider_Timeline && !TargetReplayActor->IsScrubbing())
+	{
+		const float Progress = TargetReplayActor->GetPlaybackProgress();
+		if (Slider_Timeline->GetValue() != Progress)
+		{
+			Slider_Timeline->SetValue(Progress);
+		}
+	}
+
+	if (!Text_TimeDisplay)
+	{
+		return;
+	}
+
+	// Formater le texte : "12.5 / 30.0 s"
+	FString TimeText = FString::Printf(TEXT("%.1f / %.1f s"), TargetReplayActor->CurrentPlaybackTime, TargetReplayActor->TotalDuration);
+
+	// Indiquer la progression pendant un chargement en arrière-plan
+	const bool bLoading = TargetReplayActor->IsTrajectoryLoading();
+	if (bLoading)
+	{
+		TimeText += FString::Printf(TEXT(" (loading %d%%)"), FMath::RoundToInt(TargetReplayActor->LoadProgress * 100.0f));
+	}
+
+	// Le texte arrondi change bien moins souvent que le temps
+	if (TimeText != DisplayedTimeText)
+	{
 		Text_TimeDisplay->SetText(FText::FromString(TimeText));
+		DisplayedTimeText = MoveTemp(TimeText);
 	}
-}
\ No newline at end of file
+
+	// La progression du chargement n'a pas d'événement : la relire jusqu'à la fin (OnDataReloaded)
+	if (bLoading)
+	{
+		if (UWorld* World = GetWorld())
+		{
+			const float Interval = TimeRefreshRate > 0.0f ? 1.0f / TimeRefreshRate : 0.1f;
+			World->GetTimerManager().SetTimer(TimeDisplayTimer, this, &UReplayControlWidget::UpdateTimeDisplay, Interval, false);
+		}
+	}
+}
+
+void UReplayControlWidget::UpdateShowTrajectoryLabel()
+{
+	if (!TargetReplayActor || !ShowTrajectoryLabel)
+	{
+		return;
+	}
+
+	// Textes construits une seule fois
+	static const FText HidePathText = FText::FromString(TEXT("👁 Hide Path"));
+	static const FText ShowPathText = FText::FromString(TEXT("👁 Show Path"));
+	ShowTrajectoryLabel->SetText(TargetReplayActor->bShowTrajectory ? HidePathText : ShowPathText);
+}
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
+#include "TimerManager.h"
 #include "ReplayControlWidget.generated.h"
 
 // Forward declarations
@@ -14,13 +15,16 @@ class ATrajectoryReplayActor;
 
 /**
  * Widget UI pour contrler la lecture de trajectoire
+ * Mis  jour par les vnements de l'acteur (pas de Tick) : seuls les lments modifis sont invalids.
  */
-UCLASS()
+UCLASS(meta = (DisableNativeTick))
 class DATAREPLAY_API UReplayControlWidget : public UUserWidget
 {
 	GENERATED_BODY()
 
 public:
+	UReplayControlWidget(const FObjectInitializer& ObjectInitializer);
+
 	// ========== WIDGETS UI (lis depuis le Blueprint) ==========
 
 	// Bouton Play
@@ -50,15 +54,23 @@ public:
 	// ========== RFRENCE  L'ACTEUR ==========
 
 	// Rfrence  l'acteur de replay  contrler
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Replay Control")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, BlueprintSetter = SetTargetReplayActor, Category = "Replay Control")
 	ATrajectoryReplayActor* TargetReplayActor;
 
+	// Frquence maximale de mise  jour du temps affich et du slider (Hz, 10 par dfaut) ; 0 :  chaque changement
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Replay Control", meta = (ClampMin = "0.0", Units = "Hz"))
+	float TimeRefreshRate;
+
+	// Changer d'acteur contrl (abonnement  ses vnements)
+	UFUNCTION(BlueprintCallable, Category = "Replay Control")
+	void SetTargetReplayActor(ATrajectoryReplayActor* NewTarget);
+
 protected:
 	// Appel lors de l'initialisation du widget
 	virtual void NativeConstruct() override;
 
-	// Appel chaque frame
-	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+	// Appel quand le widget est retir
+	virtual void NativeDestruct() override;
 
 private:
 	// ========== CALLBACKS DES BOUTONS ==========
@@ -78,11 +90,59 @@ private:
 	UFUNCTION()
 	void OnTimelineSliderValueChanged(float Value);
 
+	// Curseur saisi ou relch (souris ou manette)
+	UFUNCTION()
+	void OnTimelineScrubStarted();
+
+	UFUNCTION()
+	void OnTimelineScrubEnded();
+
+	// ========== VNEMENTS DE L'ACTEUR ==========
+
+	UFUNCTION()
+	void HandlePlaybackTimeChanged(float CurrentTime, float TotalDuration);
+
+	UFUNCTION()
+	void HandlePlayStateChanged(bool bIsPlaying);
+
+	UFUNCTION()
+	void HandleVisibilityChanged(bool bShowTrajectory);
+
+	UFUNCTION()
+	void HandleDataReloaded();
+
 	// ========== FONCTIONS INTERNES ==========
 
-	// Mettre  jour l'affichage du temps
+	// S'abonner aux vnements de TargetReplayActor, ou s'en dsabonner
+	void BindToTarget();
+	void UnbindFromTarget();
+
+	// Tout mettre  jour (nouvel acteur, nouvelles donnes)
+	void RefreshAll();
+
+	// Mettre  jour le temps et le slider maintenant, ou au plus tt selon TimeRefreshRate
+	void RequestTimeDisplayUpdate();
+
+	// Mettre  jour l'affichage du temps et le slider
 	void UpdateTimeDisplay();
 
+	// Mettre  jour le texte du bouton Show Trajectory
+	void UpdateShowTrajectoryLabel();
+
 	// Flag pour viter les boucles infinies lors du changement de slider
 	bool bIsUpdatingSlider;
+
+	// Acteur dont les vnements sont reus
+	TWeakObjectPtr<ATrajectoryReplayActor> BoundActor;
+
+	// Texte du bouton Show Trajectory (trouv une fois)
+	UPROPERTY(Transient)
+	UTextBlock* ShowTrajectoryLabel;
+
+	// Mise  jour diffre du temps affich
+	FTimerHandle TimeDisplayTimer;
+	double LastTimeDisplayUpdate;
+
+	// Dernier texte affich (SetText uniquement s'il change)
+	FString DisplayedTimeText;
 };
\ No newline at end of file
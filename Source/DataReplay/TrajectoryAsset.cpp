@@ -0,0 +1,337 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryAsset.h"
+#include "DataReplay.h"
+#include "TrajectorySampleBuffer.h"
+#include "TrajectoryResampleCache.h"
+#include "TrajectoryCompression.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Misc/ScopeLock.h"
+#include "Engine/DataTable.h"
+
+UTrajectoryAsset::UTrajectoryAsset()
+{
+	SampleCount = 0;
+	StartTime = 0.0f;
+	EndTime = 0.0f;
+	ResampleRate = 0.0f;
+	CompressionErrorBound = 0.0f;
+	CompressionTimeErrorBound = 0.0005f;
+	bIsCompressed = false;
+	CompressionRatio = 1.0f;
+
+#if WITH_EDITORONLY_DATA
+	SourceDataTable = nullptr;
+#endif
+}
+
+// ========== CONVERSION ==========
+
+bool UTrajectoryAsset::ConvertFromDataTable(UDataTable* DataTable)
+{
+	FTrajectorySampleBuffer Samples;
+	if (!Samples.AppendFromDataTable(DataTable))
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryAsset] Cannot convert %s: invalid DataTable"), DataTable ? *DataTable->GetName() : TEXT("NULL"));
+		return false;
+	}
+
+	Samples.RemoveInvalidSamples();
+	Samples.SortByTime();
+	SetSamples(Samples);
+
+	// Propriétés ajoutées à FDroneWaypointRow : canaux de télémétrie, dans l'ordre des échantillons
+	FTrajectoryChannelSet TableChannels;
+	FTrajectoryChannelSet::OpenDataTable(DataTable, SampleCount, TableChannels);
+	SetChannels(TableChannels);
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryAsset] Converted %d waypoints and %d channels from %s (%lld bytes of sample data, %lld bytes of channel data)"),
+		SampleCount, Channels.Num(), *DataTable->GetName(), SampleData.GetBulkDataSize(), ChannelData.GetBulkDataSize());
+	return true;
+}
+
+#if WITH_EDITOR
+void UTrajectoryAsset::ImportFromSourceTable()
+{
+	if (ConvertFromDataTable(SourceDataTable))
+	{
+		MarkPackageDirty();
+	}
+}
+
+void UTrajectoryAsset::ReportResampleTradeoff()
+{
+	FTrajectorySampleBuffer Samples;
+	if (!LoadSamples(Samples))
+	{
+		return;
+	}
+
+	FTrajectoryResampleCache::LogRateTradeoff(Samples, nullptr, FTrajectoryResampleCache::GetDefaultTradeoffRates(), GetName());
+}
+#endif
+
+void UTrajectoryAsset::SetSamples(const FTrajectorySampleBuffer& Samples)
+{
+	SampleCount = Samples.Num();
+	StartTime = Samples.GetStartTime();
+	EndTime = Samples.GetEndTime();
+
+	// Les canaux ne correspondent plus aux échantillons
+	SetChannels(FTrajectoryChannelSet());
+
+	const int64 ColumnBytes = static_cast<int64>(SampleCount) * sizeof(float);
+
+	// Échantillons compressés : le bloc bulk contient la structure sérialisée
+	FTrajectoryCompressedSamples Compressed;
+	if (CompressionErrorBound > 0.0f && Compressed.Compress(Samples, CompressionErrorBound, CompressionTimeErrorBound))
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		Writer << Compressed;
+		WriteBulkData(SampleData, Bytes.GetData(), Bytes.Num());
+
+		bIsCompressed = true;
+		CompressionRatio = Bytes.Num() > 0 ? static_cast<float>(static_cast<double>(ColumnBytes * 4) / Bytes.Num()) : 1.0f;
+
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryAsset] %s: %d samples compressed to %d bytes (x%.1f, position error %.3f, time error %.5f s)"),
+			*GetName(), SampleCount, Bytes.Num(), CompressionRatio, Compressed.GetErrorBound(1), Compressed.GetErrorBound(0));
+		return;
+	}
+
+	// Écrire les quatre colonnes à la suite dans le bloc bulk
+	bIsCompressed = false;
+	CompressionRatio = 1.0f;
+
+	SampleData.Lock(LOCK_READ_WRITE);
+	uint8* Dest = static_cast<uint8*>(SampleData.Realloc(ColumnBytes * 4));
+	if (ColumnBytes > 0)
+	{
+		FMemory::Memcpy(Dest, Samples.Times.GetData(), ColumnBytes);
+		FMemory::Memcpy(Dest + ColumnBytes, Samples.PosX.GetData(), ColumnBytes);
+		FMemory::Memcpy(Dest + ColumnBytes * 2, Samples.PosY.GetData(), ColumnBytes);
+		FMemory::Memcpy(Dest + ColumnBytes * 3, Samples.PosZ.GetData(), ColumnBytes);
+	}
+	SampleData.Unlock();
+}
+
+void UTrajectoryAsset::SetChannels(const FTrajectoryChannelSet& InChannels)
+{
+	Channels.Reset();
+
+	// Toutes les colonnes à la suite, une seule lecture de la source
+	TArray<int32> ChannelIndices;
+	for (int32 ChannelIndex = 0; ChannelIndex < InChannels.Num(); ChannelIndex++)
+	{
+		ChannelIndices.Add(ChannelIndex);
+	}
+	InChannels.Decode(ChannelIndices);
+
+	TArray64<uint8> Bytes;
+	for (const int32 ChannelIndex : ChannelIndices)
+	{
+		const FTrajectoryChannelColumn* Column = InChannels.GetColumn(ChannelIndex);
+		if (Column == nullptr || Column->Num() != SampleCount)
+		{
+			continue;
+		}
+
+		FTrajectoryAssetChannel& Channel = Channels.AddDefaulted_GetRef();
+		Channel.Name = InChannels.GetChannel(ChannelIndex).Name;
+		Channel.Type = Column->Type;
+		Channel.EnumNames = Column->EnumNames;
+		Channel.Offset = Bytes.Num();
+		Bytes.Append(static_cast<const uint8*>(Column->GetData()), static_cast<int64>(SampleCount) * FTrajectoryChannelColumn::GetValueSize(Column->Type));
+	}
+
+	WriteBulkData(ChannelData, Bytes.GetData(), Bytes.Num());
+}
+
+void UTrajectoryAsset::WriteBulkData(FByteBulkData& BulkData, const void* Data, int64 Size)
+{
+	BulkData.Lock(LOCK_READ_WRITE);
+	void* Dest = BulkData.Realloc(Size);
+	if (Size > 0)
+	{
+		FMemory::Memcpy(Dest, Data, Size);
+	}
+	BulkData.Unlock();
+}
+
+void UTrajectoryAsset::ReleaseBulkData(FByteBulkData& BulkData)
+{
+	if (BulkData.IsBulkDataLoaded() && BulkData.CanLoadFromDisk())
+	{
+		BulkData.UnloadBulkData();
+	}
+}
+
+bool UTrajectoryAsset::LoadSamples(FTrajectorySampleBuffer& OutSamples)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UTrajectoryAsset::LoadSamples);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+	FScopeLock Lock(&BulkDataLock);
+
+	OutSamples.Reset();
+
+	if (bIsCompressed)
+	{
+		// Désérialiser depuis le bloc, puis décoder les blocs en parallèle
+		FTrajectoryCompressedSamples Compressed;
+		const int64 Size = SampleData.GetBulkDataSize();
+		const uint8* Source = static_cast<const uint8*>(SampleData.LockReadOnly());
+		if (Source == nullptr)
+		{
+			SampleData.Unlock();
+			return false;
+		}
+
+		FMemoryReaderView Reader(MakeArrayView(Source, static_cast<int32>(Size)));
+		Reader << Compressed;
+		SampleData.Unlock();
+		ReleaseBulkData(SampleData);
+
+		if (Reader.IsError() || Compressed.Num() != SampleCount)
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryAsset] %s: invalid compressed sample data"), *GetName());
+			return false;
+		}
+		return Compressed.Decompress(OutSamples);
+	}
+
+	const int64 ColumnBytes = static_cast<int64>(SampleCount) * sizeof(float);
+	if (SampleData.GetBulkDataSize() != ColumnBytes * 4)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryAsset] %s: sample data size mismatch (%lld bytes for %d samples)"),
+			*GetName(), SampleData.GetBulkDataSize(), SampleCount);
+		return false;
+	}
+
+	if (SampleCount == 0)
+	{
+		return true;
+	}
+
+	// Une seule lecture du bloc, puis copie directe de chaque colonne
+	const uint8* Source = static_cast<const uint8*>(SampleData.LockReadOnly());
+	if (Source == nullptr)
+	{
+		SampleData.Unlock();
+		return false;
+	}
+
+	OutSamples.SetNumUninitialized(SampleCount);
+	FMemory::Memcpy(OutSamples.Times.GetData(), Source, ColumnBytes);
+	FMemory::Memcpy(OutSamples.PosX.GetData(), Source + ColumnBytes, ColumnBytes);
+	FMemory::Memcpy(OutSamples.PosY.GetData(), Source + ColumnBytes * 2, ColumnBytes);
+	FMemory::Memcpy(OutSamples.PosZ.GetData(), Source + ColumnBytes * 3, ColumnBytes);
+
+	// Les échantillons ne restent en mémoire qu'une fois : dans le buffer de l'appelant
+	SampleData.Unlock();
+	ReleaseBulkData(SampleData);
+	return true;
+}
+
+void UTrajectoryAsset::OpenChannels(int32 LoadedSampleCount, FTrajectoryChannelSet& OutChannels)
+{
+	OutChannels.Reset();
+	if (Channels.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FTrajectoryChannelDesc> Descs;
+	for (const FTrajectoryAssetChannel& Channel : Channels)
+	{
+		Descs.Add({ Channel.Name, Channel.Type });
+	}
+
+	TWeakObjectPtr<UTrajectoryAsset> WeakAsset(this);
+	OutChannels.Init(MoveTemp(Descs), LoadedSampleCount,
+		[WeakAsset](TConstArrayView<int32> ChannelIndices, TArrayView<FTrajectoryChannelColumn* const> OutColumns)
+		{
+			UTrajectoryAsset* Asset = WeakAsset.Get();
+			return Asset && Asset->ReadChannels(ChannelIndices, OutColumns);
+		});
+}
+
+bool UTrajectoryAsset::ReadChannels(TConstArrayView<int32> ChannelIndices, TArrayView<FTrajectoryChannelColumn* const> OutColumns)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UTrajectoryAsset::ReadChannels);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+	FScopeLock Lock(&BulkDataLock);
+
+	// Le bloc des canaux n'est chargé qu'ici : une lecture sans canal ne le lit jamais
+	const int64 DataSize = ChannelData.GetBulkDataSize();
+	const uint8* Source = static_cast<const uint8*>(ChannelData.LockReadOnly());
+	if (Source == nullptr)
+	{
+		ChannelData.Unlock();
+		return false;
+	}
+
+	bool bValid = true;
+	for (int32 i = 0; i < ChannelIndices.Num() && bValid; i++)
+	{
+		const FTrajectoryAssetChannel& Channel = Channels[ChannelIndices[i]];
+		const int64 Size = static_cast<int64>(SampleCount) * FTrajectoryChannelColumn::GetValueSize(Channel.Type);
+		bValid = Channel.Offset >= 0 && Channel.Offset + Size <= DataSize;
+		if (bValid)
+		{
+			FTrajectoryChannelColumn& Column = *OutColumns[i];
+			Column.EnumNames = Channel.EnumNames;
+			Column.SetNumUninitialized(SampleCount);
+			FMemory::Memcpy(Column.GetData(), Source + Channel.Offset, Size);
+		}
+	}
+	ChannelData.Unlock();
+	ReleaseBulkData(ChannelData);
+
+	if (!bValid)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryAsset] %s: invalid channel data"), *GetName());
+	}
+	return bValid;
+}
+
+// ========== UOBJECT ==========
+
+void UTrajectoryAsset::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	// Le bloc n'est lu qu'à la demande ; dans les builds cookés il peut être projeté en mémoire
+	if (Ar.IsSaving())
+	{
+		uint32 Flags = BULKDATA_Force_NOT_InlinePayload;
+		if (Ar.IsCooking())
+		{
+			Flags |= BULKDATA_MemoryMapPayload;
+		}
+		SampleData.SetBulkDataFlags(Flags);
+		ChannelData.SetBulkDataFlags(Flags);
+	}
+
+	SampleData.Serialize(Ar, this);
+
+	// Channels est déjà sérialisé par Super::Serialize : les assets sans canaux (dont les plus anciens) n'ont pas ce bloc
+	if (Channels.Num() > 0)
+	{
+		ChannelData.Serialize(Ar, this);
+	}
+}
+
+void UTrajectoryAsset::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	if (SampleData.IsBulkDataLoaded())
+	{
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(SampleData.GetBulkDataSize());
+	}
+	if (ChannelData.IsBulkDataLoaded())
+	{
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(ChannelData.GetBulkDataSize());
+	}
+}
@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Serialization/BulkData.h"
+#include "HAL/CriticalSection.h"
+#include "TrajectoryChannels.h"
+#include "TrajectoryAsset.generated.h"
+
+class UDataTable;
+struct FTrajectorySampleBuffer;
+
+/**
+ * Canal de télémétrie stocké dans un UTrajectoryAsset : SampleCount valeurs brutes à partir de Offset dans le bloc des canaux
+ */
+USTRUCT()
+struct FTrajectoryAssetChannel
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Channel")
+	FName Name;
+
+	UPROPERTY(VisibleAnywhere, Category = "Channel")
+	ETrajectoryChannelType Type = ETrajectoryChannelType::Float;
+
+	// Noms des valeurs d'un canal Enum
+	UPROPERTY(VisibleAnywhere, Category = "Channel")
+	TArray<FName> EnumNames;
+
+	UPROPERTY()
+	int64 Offset = 0;
+};
+
+/**
+ * Asset binaire compact contenant une trajectoire
+ * Les échantillons sont stockés dans un seul bloc bulk (colonnes Time, X, Y, Z à la suite, ou
+ * FTrajectoryCompressedSamples si CompressionErrorBound > 0), chargé en une lecture à la demande
+ * et projeté en mémoire dans les builds cookés si la plateforme le permet
+ */
+UCLASS(BlueprintType)
+class DATAREPLAY_API UTrajectoryAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UTrajectoryAsset();
+
+	// ========== INFORMATIONS ==========
+
+	// Nombre d'échantillons stockés
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Trajectory")
+	int32 SampleCount;
+
+	// Premier temps de la trajectoire (secondes)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Trajectory")
+	float StartTime;
+
+	// Dernier temps de la trajectoire (secondes)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Trajectory")
+	float EndTime;
+
+	// Fréquence de rééchantillonnage choisie pour cette trajectoire (Hz) ; 0 : réglage de l'acteur
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory", meta = (ClampMin = "0.0", Units = "Hz"))
+	float ResampleRate;
+
+	// Erreur de position maximale par axe des échantillons compressés ; 0 : floats bruts (appliqué à la prochaine conversion)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (ClampMin = "0.0"))
+	float CompressionErrorBound;
+
+	// Erreur maximale sur les temps des échantillons compressés (secondes)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (ClampMin = "0.000001", EditCondition = "CompressionErrorBound > 0"))
+	float CompressionTimeErrorBound;
+
+	// Vrai si le bloc bulk contient des échantillons compressés
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Compression")
+	bool bIsCompressed;
+
+	// Taille brute / taille stockée
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Compression")
+	float CompressionRatio;
+
+	// Canaux de télémétrie (propriétés ajoutées à FDroneWaypointRow par la structure du DataTable converti)
+	UPROPERTY(VisibleAnywhere, Category = "Channels")
+	TArray<FTrajectoryAssetChannel> Channels;
+
+#if WITH_EDITORONLY_DATA
+	// DataTable de FDroneWaypointRow à convertir
+	UPROPERTY(EditAnywhere, Category = "Source")
+	UDataTable* SourceDataTable;
+#endif
+
+	// ========== CONVERSION ==========
+
+	// Remplacer le contenu par les lignes d'un DataTable de FDroneWaypointRow
+	UFUNCTION(BlueprintCallable, Category = "Trajectory")
+	bool ConvertFromDataTable(UDataTable* DataTable);
+
+#if WITH_EDITOR
+	// Convertir SourceDataTable (bouton dans le panneau de détails)
+	UFUNCTION(CallInEditor, Category = "Source")
+	void ImportFromSourceTable();
+
+	// Écrire dans le log la mémoire et l'erreur de rééchantillonnage pour plusieurs fréquences
+	UFUNCTION(CallInEditor, Category = "Trajectory")
+	void ReportResampleTradeoff();
+#endif
+
+	// Remplacer le contenu par des échantillons triés (les canaux de télémétrie sont supprimés)
+	void SetSamples(const FTrajectorySampleBuffer& Samples);
+
+	// Remplacer les canaux de télémétrie, décodés en entier, dans l'ordre des échantillons passés à SetSamples
+	void SetChannels(const FTrajectoryChannelSet& InChannels);
+
+	// Copier les échantillons dans un buffer (une seule lecture du bloc bulk, libéré ensuite s'il peut être relu)
+	bool LoadSamples(FTrajectorySampleBuffer& OutSamples);
+
+	// Lister les canaux de télémétrie ; leur bloc n'est lu qu'au premier décodage (thread de jeu)
+	void OpenChannels(int32 LoadedSampleCount, FTrajectoryChannelSet& OutChannels);
+
+	// ========== UOBJECT ==========
+
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+private:
+	// Colonnes Time, X, Y, Z de SampleCount floats chacune, ou FTrajectoryCompressedSamples sérialisé (bIsCompressed)
+	FByteBulkData SampleData;
+
+	// Colonnes des canaux de télémétrie à la suite (non compressées), sérialisé seulement si Channels n'est pas vide
+	FByteBulkData ChannelData;
+
+	// Lectures concurrentes (chargements en tâche de fond de plusieurs acteurs) : un bloc n'est libéré qu'une fois lu par tous
+	FCriticalSection BulkDataLock;
+
+	// Écrire des octets dans un bloc bulk
+	static void WriteBulkData(FByteBulkData& BulkData, const void* Data, int64 Size);
+
+	// Libérer la copie chargée d'un bloc une fois ses données copiées, s'il peut être relu depuis le paquet
+	// (sinon, par exemple dans un asset converti mais pas encore enregistré, c'est la seule copie)
+	static void ReleaseBulkData(FByteBulkData& BulkData);
+
+	// Copier des canaux depuis le bloc des canaux
+	bool ReadChannels(TConstArrayView<int32> ChannelIndices, TArrayView<FTrajectoryChannelColumn* const> OutColumns);
+};
@@ -0,0 +1,419 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryBatchLoader.h"
+#include "DataReplay.h"
+#include "TrajectoryAsset.h"
+#include "Engine/DataTable.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace TrajectoryBatchLoader
+{
+	// Taille d'un échantillon en mémoire (temps et trois coordonnées)
+	static constexpr int64 BytesPerSample = 4 * sizeof(float);
+}
+
+// ========== CONSTRUCTION ==========
+
+FTrajectoryBatchLoader::FTrajectoryBatchLoader(const FSettings& InSettings)
+	: Settings(InSettings)
+{
+	MaxConcurrentLoads = Settings.MaxConcurrentLoads > 0 ? Settings.MaxConcurrentLoads : FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+}
+
+FTrajectoryBatchLoader::~FTrajectoryBatchLoader()
+{
+	CancelAndWait();
+}
+
+void FTrajectoryBatchLoader::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObjects(ReferencedObjects);
+}
+
+int32 FTrajectoryBatchLoader::FindMissionFiles(const FString& Directory, bool bRecursive, TArray<FTrajectoryLoadRequest>& OutRequests)
+{
+	TArray<FString> FilePaths;
+	auto Visitor = [&FilePaths](const TCHAR* Path, bool bIsDirectory)
+		{
+			if (!bIsDirectory)
+			{
+				const FString Extension = FPaths::GetExtension(Path);
+				if (Extension.Equals(TEXT("csv"), ESearchCase::IgnoreCase) || Extension.Equals(TEXT("dtraj"), ESearchCase::IgnoreCase))
+				{
+					FilePaths.Add(Path);
+				}
+			}
+			return true;
+		};
+
+	if (bRecursive)
+	{
+		IFileManager::Get().IterateDirectoryRecursively(*Directory, Visitor);
+	}
+	else
+	{
+		IFileManager::Get().IterateDirectory(*Directory, Visitor);
+	}
+
+	// Ordre stable d'un appel à l'autre (l'ordre du système de fichiers ne l'est pas)
+	FilePaths.Sort();
+
+	for (const FString& FilePath : FilePaths)
+	{
+		FTrajectoryLoadRequest& Request = OutRequests.AddDefaulted_GetRef();
+		Request.Source = FPaths::GetExtension(FilePath).Equals(TEXT("dtraj"), ESearchCase::IgnoreCase) ? ETrajectorySourceType::PagedFile : ETrajectorySourceType::CsvFile;
+		Request.FilePath = FilePath;
+	}
+
+	if (FilePaths.Num() == 0)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryBatchLoader] No CSV or paged trajectory file found in %s"), *Directory);
+	}
+	return FilePaths.Num();
+}
+
+int64 FTrajectoryBatchLoader::EstimateMissionBytes(const FTrajectoryLoadRequest& Request, int64& OutSourceBytes)
+{
+	using namespace TrajectoryBatchLoader;
+
+	OutSourceBytes = 0;
+	switch (Request.Source)
+	{
+	case ETrajectorySourceType::CsvFile:
+		// Texte lu en entier, plus les échantillons analysés (une ligne CSV fait bien plus de 16 octets)
+		OutSourceBytes = FMath::Max<int64>(IFileManager::Get().FileSize(*Request.FilePath), 0);
+		return OutSourceBytes + OutSourceBytes / 2;
+
+	case ETrajectorySourceType::PagedFile:
+		// Tronçons compressés, puis échantillons décodés
+		OutSourceBytes = FMath::Max<int64>(IFileManager::Get().FileSize(*Request.FilePath), 0);
+		return OutSourceBytes * 4;
+
+	case ETrajectorySourceType::Asset:
+		// Bloc de données de l'asset, puis échantillons
+		OutSourceBytes = Request.Asset ? Request.Asset->SampleCount * BytesPerSample : 0;
+		return OutSourceBytes * 2;
+
+	case ETrajectorySourceType::DataTable:
+		// Les lignes sont déjà en mémoire : seuls les échantillons sont alloués
+		OutSourceBytes = Request.DataTable ? Request.DataTable->GetRowMap().Num() * BytesPerSample : 0;
+		return OutSourceBytes;
+
+	default:
+		return 0;
+	}
+}
+
+// ========== MISSIONS ==========
+
+int32 FTrajectoryBatchLoader::AddMission(const FTrajectoryLoadRequest& Request)
+{
+	TUniquePtr<FMission> Mission = MakeUnique<FMission>();
+	Mission->Request = Request;
+	if (Request.DataTable)
+	{
+		ReferencedObjects.Add(const_cast<UDataTable*>(Request.DataTable));
+	}
+	if (Request.Asset)
+	{
+		ReferencedObjects.Add(Request.Asset);
+	}
+	Mission->ReservedBytes = EstimateMissionBytes(Request, Mission->Stats.SourceBytes);
+
+	if (!Request.FilePath.IsEmpty())
+	{
+		Mission->Name = FPaths::GetCleanFilename(Request.FilePath);
+	}
+	else if (Request.Asset)
+	{
+		Mission->Name = Request.Asset->GetName();
+	}
+	else if (Request.DataTable)
+	{
+		Mission->Name = Request.DataTable->GetName();
+	}
+	Mission->Stats.Name = Mission->Name;
+
+	FScopeLock ScopeLock(&Lock);
+	const int32 MissionIndex = Missions.Add(MoveTemp(Mission));
+	LaunchPendingMissions();
+	return MissionIndex;
+}
+
+void FTrajectoryBatchLoader::LaunchPendingMissions()
+{
+	while (!bCancelled && NextMissionToLaunch < Missions.Num() && RunningCount < MaxConcurrentLoads)
+	{
+		FMission* Mission = Missions[NextMissionToLaunch].Get();
+		if (Mission->State == EMissionState::Cancelled)
+		{
+			NextMissionToLaunch++;
+			continue;
+		}
+
+		// Attendre que des missions se terminent ou que des résultats soient récupérés, sauf si rien n'est réservé
+		if (ReservedBytes > 0 && ReservedBytes + Mission->ReservedBytes > Settings.MemoryBudgetBytes)
+		{
+			break;
+		}
+
+		NextMissionToLaunch++;
+		RunningCount++;
+		ReservedBytes += Mission->ReservedBytes;
+		PeakReservedBytes = FMath::Max(PeakReservedBytes, ReservedBytes);
+		Mission->State = EMissionState::Running;
+
+		if (FirstLaunchTime == 0.0)
+		{
+			FirstLaunchTime = FPlatformTime::Seconds();
+		}
+
+		INC_DWORD_STAT(STAT_DataReplay_BatchMissionsLoading);
+		TRACE_COUNTER_SET(DataReplay_BatchReservedBytes, ReservedBytes);
+
+		// Le destructeur attend toutes les tâches : le pointeur brut reste valide
+		Mission->Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Mission]()
+			{
+				RunMission(*Mission);
+			},
+			UE::Tasks::ETaskPriority::BackgroundNormal);
+	}
+}
+
+void FTrajectoryBatchLoader::RunMission(FMission& Mission)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTrajectoryBatchLoader::RunMission);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Lecture, validation et tri, sans verrou
+	FTrajectorySampleBuffer Samples;
+	const bool bLoaded = FTrajectoryLoader::LoadSamples(Mission.Request, Samples);
+	const double EndTime = FPlatformTime::Seconds();
+
+	FScopeLock ScopeLock(&Lock);
+
+	Mission.bSucceeded = bLoaded;
+	Mission.Stats.bSucceeded = bLoaded;
+	Mission.Stats.SampleCount = Samples.Num();
+	Mission.Stats.LoadSeconds = EndTime - StartTime;
+
+	// Le résultat remplace l'estimation dans le budget jusqu'à sa récupération
+	const int64 ResultBytes = Samples.GetAllocatedSize();
+	ReservedBytes += ResultBytes - Mission.ReservedBytes;
+	PeakReservedBytes = FMath::Max(PeakReservedBytes, ReservedBytes);
+	Mission.ReservedBytes = ResultBytes;
+	Mission.Samples = MoveTemp(Samples);
+	Mission.State = EMissionState::Done;
+
+	RunningCount--;
+	FinishedCount++;
+	LastFinishTime = EndTime;
+
+	DEC_DWORD_STAT(STAT_DataReplay_BatchMissionsLoading);
+	TRACE_COUNTER_SET(DataReplay_BatchReservedBytes, ReservedBytes);
+
+	LaunchPendingMissions();
+}
+
+void FTrajectoryBatchLoader::CancelMission(int32 MissionIndex)
+{
+	UE::Tasks::FTask RunningTask;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (!Missions.IsValidIndex(MissionIndex))
+		{
+			return;
+		}
+
+		FMission& Mission = *Missions[MissionIndex];
+		if (Mission.State == EMissionState::Pending)
+		{
+			Mission.State = EMissionState::Cancelled;
+			FinishedCount++;
+			return;
+		}
+		if (Mission.State == EMissionState::Running)
+		{
+			RunningTask = Mission.Task;
+		}
+	}
+
+	// La tâche prend le verrou pour se terminer : l'attendre sans le tenir
+	if (RunningTask.IsValid())
+	{
+		RunningTask.Wait();
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	FMission& Mission = *Missions[MissionIndex];
+	if (Mission.State == EMissionState::Done)
+	{
+		ReservedBytes -= Mission.ReservedBytes;
+		Mission.ReservedBytes = 0;
+		Mission.Samples.Empty();
+		Mission.State = EMissionState::Cancelled;
+		TRACE_COUNTER_SET(DataReplay_BatchReservedBytes, ReservedBytes);
+		LaunchPendingMissions();
+	}
+}
+
+void FTrajectoryBatchLoader::CancelAndWait()
+{
+	TArray<UE::Tasks::FTask> RunningTasks;
+	{
+		FScopeLock ScopeLock(&Lock);
+		bCancelled = true;
+		for (const TUniquePtr<FMission>& Mission : Missions)
+		{
+			if (Mission->State == EMissionState::Running)
+			{
+				RunningTasks.Add(Mission->Task);
+			}
+		}
+	}
+
+	// Plus aucune mission n'est lancée : attendre celles en cours suffit
+	UE::Tasks::Wait(RunningTasks);
+}
+
+// ========== RÉSULTATS ==========
+
+bool FTrajectoryBatchLoader::DequeueResult(FTrajectoryBatchResult& OutResult)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	while (NextMissionToDeliver < Missions.Num() && Missions[NextMissionToDeliver]->State == EMissionState::Cancelled)
+	{
+		NextMissionToDeliver++;
+	}
+	if (bCancelled || NextMissionToDeliver >= Missions.Num() || Missions[NextMissionToDeliver]->State != EMissionState::Done)
+	{
+		return false;
+	}
+
+	FMission& Mission = *Missions[NextMissionToDeliver];
+	OutResult.MissionIndex = NextMissionToDeliver;
+	OutResult.bSucceeded = Mission.bSucceeded;
+	OutResult.Samples = MoveTemp(Mission.Samples);
+	OutResult.Stats = Mission.Stats;
+	FileStats.Add(Mission.Stats);
+
+	// Le résultat appartient maintenant à l'appelant : libérer sa part du budget
+	ReservedBytes -= Mission.ReservedBytes;
+	Mission.ReservedBytes = 0;
+	Mission.State = EMissionState::Delivered;
+	NextMissionToDeliver++;
+
+	TRACE_COUNTER_SET(DataReplay_BatchReservedBytes, ReservedBytes);
+	LaunchPendingMissions();
+	return true;
+}
+
+bool FTrajectoryBatchLoader::WaitForResult(FTrajectoryBatchResult& OutResult)
+{
+	while (!DequeueResult(OutResult))
+	{
+		if (IsDone())
+		{
+			return false;
+		}
+
+		// Les missions sont lancées dans l'ordre d'ajout : la prochaine à rendre est déjà lancée
+		UE::Tasks::FTask NextTask;
+		{
+			FScopeLock ScopeLock(&Lock);
+			for (int32 MissionIndex = NextMissionToDeliver; MissionIndex < Missions.Num(); MissionIndex++)
+			{
+				if (Missions[MissionIndex]->State != EMissionState::Cancelled)
+				{
+					NextTask = Missions[MissionIndex]->Task;
+					break;
+				}
+			}
+		}
+
+		if (!NextTask.IsValid())
+		{
+			return false;
+		}
+		NextTask.Wait();
+	}
+	return true;
+}
+
+bool FTrajectoryBatchLoader::IsDone() const
+{
+	FScopeLock ScopeLock(&Lock);
+	if (bCancelled)
+	{
+		return true;
+	}
+
+	for (int32 MissionIndex = NextMissionToDeliver; MissionIndex < Missions.Num(); MissionIndex++)
+	{
+		if (Missions[MissionIndex]->State != EMissionState::Cancelled)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+float FTrajectoryBatchLoader::GetProgress() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Missions.Num() > 0 ? static_cast<float>(FinishedCount) / Missions.Num() : 1.0f;
+}
+
+// ========== BILAN ==========
+
+FTrajectoryBatchStats FTrajectoryBatchLoader::GetStats() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FTrajectoryBatchStats Stats;
+	Stats.MissionCount = Missions.Num();
+	for (const TUniquePtr<FMission>& Mission : Missions)
+	{
+		if (Mission->State == EMissionState::Done || Mission->State == EMissionState::Delivered)
+		{
+			(Mission->bSucceeded ? Stats.SucceededCount : Stats.FailedCount)++;
+			Stats.SourceBytes += Mission->Stats.SourceBytes;
+			Stats.SampleCount += Mission->Stats.SampleCount;
+		}
+	}
+
+	if (FirstLaunchTime > 0.0)
+	{
+		const double EndTime = RunningCount > 0 ? FPlatformTime::Seconds() : LastFinishTime;
+		Stats.WallSeconds = FMath::Max(EndTime - FirstLaunchTime, 0.0);
+	}
+	Stats.PeakReservedBytes = PeakReservedBytes;
+	return Stats;
+}
+
+void FTrajectoryBatchLoader::LogSummary() const
+{
+	for (const FTrajectoryBatchFileStats& File : FileStats)
+	{
+		if (File.bSucceeded)
+		{
+			UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryBatchLoader] %s: %d samples, %.2f MB in %.2f ms (%.1f MB/s)"),
+				*File.Name, File.SampleCount, File.SourceBytes / (1024.0 * 1024.0), File.LoadSeconds * 1000.0, File.GetThroughputMBs());
+		}
+		else
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryBatchLoader] %s could not be loaded"), *File.Name);
+		}
+	}
+
+	const FTrajectoryBatchStats Stats = GetStats();
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryBatchLoader] %d/%d missions loaded (%lld samples, %.1f MB) in %.2f s on up to %d workers: %.1f MB/s, peak %.1f MB reserved (budget %.1f MB)"),
+		Stats.SucceededCount, Stats.MissionCount, Stats.SampleCount, Stats.SourceBytes / (1024.0 * 1024.0), Stats.WallSeconds, MaxConcurrentLoads,
+		Stats.GetThroughputMBs(), Stats.PeakReservedBytes / (1024.0 * 1024.0), Settings.MemoryBudgetBytes / (1024.0 * 1024.0));
+}
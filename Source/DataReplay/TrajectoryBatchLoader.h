@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Tasks/Task.h"
+#include "TrajectorySampleBuffer.h"
+#include "TrajectoryLoader.h"
+
+/**
+ * Bilan du chargement d'une mission
+ */
+struct FTrajectoryBatchFileStats
+{
+	// Fichier ou objet source
+	FString Name;
+
+	// Octets lus (taille du fichier, ou des échantillons pour un DataTable ou un asset)
+	int64 SourceBytes = 0;
+
+	int32 SampleCount = 0;
+
+	// Durée de la lecture, de la validation et du tri dans sa tâche (secondes)
+	double LoadSeconds = 0.0;
+
+	bool bSucceeded = false;
+
+	double GetThroughputMBs() const { return LoadSeconds > 0.0 ? SourceBytes / (1024.0 * 1024.0) / LoadSeconds : 0.0; }
+};
+
+/**
+ * Bilan d'un chargement par lots
+ */
+struct FTrajectoryBatchStats
+{
+	int32 MissionCount = 0;
+	int32 SucceededCount = 0;
+	int32 FailedCount = 0;
+	int64 SourceBytes = 0;
+	int64 SampleCount = 0;
+
+	// Du premier lancement à la fin de la dernière mission (secondes)
+	double WallSeconds = 0.0;
+
+	// Pic de mémoire réservée par les missions en cours et les résultats non récupérés (octets)
+	int64 PeakReservedBytes = 0;
+
+	double GetThroughputMBs() const { return WallSeconds > 0.0 ? SourceBytes / (1024.0 * 1024.0) / WallSeconds : 0.0; }
+};
+
+/**
+ * Résultat d'une mission, récupéré sur le thread de jeu
+ */
+struct FTrajectoryBatchResult
+{
+	// Index renvoyé par AddMission
+	int32 MissionIndex = INDEX_NONE;
+
+	bool bSucceeded = false;
+
+	// Échantillons validés et triés
+	FTrajectorySampleBuffer Samples;
+
+	FTrajectoryBatchFileStats Stats;
+};
+
+/**
+ * Chargement par lots de nombreuses missions (tous les vols d'une journée d'essais)
+ * Chaque mission est lue, validée et triée dans sa propre tâche ; les tâches s'exécutent sur tous les cœurs,
+ * dans la limite de MaxConcurrentLoads et d'un budget mémoire : une mission n'est lancée que si son estimation
+ * tient dans le budget avec les missions en cours et les résultats pas encore récupérés (la première passe toujours).
+ * Les résultats sont rendus dans l'ordre d'ajout des missions ; récupérer un résultat libère sa part du budget.
+ * Les DataTable et assets des requêtes sont référencés auprès du ramasse-miettes tant que le lot existe.
+ */
+class DATAREPLAY_API FTrajectoryBatchLoader : public FGCObject
+{
+public:
+	struct FSettings
+	{
+		// Mémoire maximale des missions en cours et des résultats non récupérés (octets)
+		int64 MemoryBudgetBytes = 1024ll * 1024 * 1024;
+
+		// Nombre maximal de missions chargées en même temps ; 0 : une par thread de travail
+		int32 MaxConcurrentLoads = 0;
+	};
+
+	explicit FTrajectoryBatchLoader(const FSettings& InSettings);
+	virtual ~FTrajectoryBatchLoader() override;
+
+	// ========== FGCOBJECT ==========
+
+	// Les missions ne sont ajoutées que sur le thread de jeu, arrêté pendant la collecte
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override { return TEXT("FTrajectoryBatchLoader"); }
+
+	/**
+	 * Requêtes de chargement des fichiers CSV et paginés (.dtraj, chargés en entier) d'un dossier, triées par nom
+	 * Renvoie le nombre de fichiers trouvés.
+	 */
+	static int32 FindMissionFiles(const FString& Directory, bool bRecursive, TArray<FTrajectoryLoadRequest>& OutRequests);
+
+	// ========== MISSIONS (THREAD DE JEU) ==========
+
+	// Ajouter une mission (lancée dès que le budget le permet) ; renvoie son index
+	int32 AddMission(const FTrajectoryLoadRequest& Request);
+
+	// Ne plus charger une mission : attend sa tâche si elle est déjà lancée, son résultat ne sera pas rendu
+	void CancelMission(int32 MissionIndex);
+
+	// Tout annuler et attendre les tâches en cours
+	void CancelAndWait();
+
+	// Récupérer le résultat de la prochaine mission dans l'ordre d'ajout, s'il est prêt
+	bool DequeueResult(FTrajectoryBatchResult& OutResult);
+
+	// Attendre puis récupérer le résultat de la prochaine mission ; faux s'il n'en reste aucune
+	bool WaitForResult(FTrajectoryBatchResult& OutResult);
+
+	// Toutes les missions ajoutées ont été rendues ou annulées
+	bool IsDone() const;
+
+	// Part des missions terminées, entre 0 et 1
+	float GetProgress() const;
+
+	// Bilan de chaque mission rendue, dans l'ordre de récupération
+	const TArray<FTrajectoryBatchFileStats>& GetFileStats() const { return FileStats; }
+
+	FTrajectoryBatchStats GetStats() const;
+
+	// Journaliser le débit de chaque mission et le bilan global
+	void LogSummary() const;
+
+private:
+	enum class EMissionState : uint8
+	{
+		Pending,
+		Running,
+		Done,
+		Delivered,
+		Cancelled
+	};
+
+	struct FMission
+	{
+		// Lue par la tâche ; ses objets sont référencés par ReferencedObjects
+		FTrajectoryLoadRequest Request;
+		FString Name;
+
+		// Estimation avant le chargement, puis taille réelle du résultat
+		int64 ReservedBytes = 0;
+
+		EMissionState State = EMissionState::Pending;
+		UE::Tasks::FTask Task;
+
+		bool bSucceeded = false;
+		FTrajectorySampleBuffer Samples;
+		FTrajectoryBatchFileStats Stats;
+	};
+
+	// Estimer la mémoire d'une mission en cours de chargement (octets) et la taille lue depuis la source
+	static int64 EstimateMissionBytes(const FTrajectoryLoadRequest& Request, int64& OutSourceBytes);
+
+	// Lancer les missions en attente qui tiennent dans le budget (Lock tenu)
+	void LaunchPendingMissions();
+
+	// Corps de la tâche d'une mission
+	void RunMission(FMission& Mission);
+
+	FSettings Settings;
+	int32 MaxConcurrentLoads = 1;
+
+	mutable FCriticalSection Lock;
+
+	// Pointeurs stables : les tâches gardent une référence sur leur mission
+	TArray<TUniquePtr<FMission>> Missions;
+
+	// DataTable et assets des requêtes ajoutées, gardés en vie pour les tâches
+	TArray<TObjectPtr<UObject>> ReferencedObjects;
+
+	// Prochaine mission à lancer et à rendre (ordre d'ajout)
+	int32 NextMissionToLaunch = 0;
+	int32 NextMissionToDeliver = 0;
+
+	int32 RunningCount = 0;
+	int32 FinishedCount = 0;
+	int64 ReservedBytes = 0;
+	int64 PeakReservedBytes = 0;
+	bool bCancelled = false;
+
+	// Du premier lancement à la fin de la dernière mission
+	double FirstLaunchTime = 0.0;
+	double LastFinishTime = 0.0;
+
+	TArray<FTrajectoryBatchFileStats> FileStats;
+};
@@ -0,0 +1,521 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryChannels.h"
+#include "DataReplay.h"
+#include "DroneWaypointStruct.h"
+#include "Engine/DataTable.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/UnrealType.h"
+
+namespace TrajectoryChannels
+{
+	// Type de canal d'une propriété de ligne ; false si la propriété ne peut pas devenir un canal
+	static bool GetPropertyChannelType(const FProperty* Property, ETrajectoryChannelType& OutType, const UEnum*& OutEnum)
+	{
+		OutEnum = nullptr;
+		if (Property->ArrayDim != 1)
+		{
+			return false;
+		}
+
+		if (Property->IsA<FFloatProperty>())
+		{
+			OutType = ETrajectoryChannelType::Float;
+			return true;
+		}
+		if (Property->IsA<FDoubleProperty>())
+		{
+			OutType = ETrajectoryChannelType::Double;
+			return true;
+		}
+		if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+		{
+			OutEnum = EnumProperty->GetEnum();
+			OutType = ETrajectoryChannelType::Enum;
+			return OutEnum != nullptr;
+		}
+		if (const FByteProperty* ByteProperty = CastField<FByteProperty>(Property))
+		{
+			OutEnum = ByteProperty->Enum;
+			OutType = OutEnum ? ETrajectoryChannelType::Enum : ETrajectoryChannelType::Int;
+			return true;
+		}
+		if (const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property))
+		{
+			OutType = ETrajectoryChannelType::Int;
+			return NumericProperty->IsInteger();
+		}
+		if (Property->IsA<FBoolProperty>())
+		{
+			OutType = ETrajectoryChannelType::Int;
+			return true;
+		}
+		return false;
+	}
+
+	// Copier la valeur de la propriété d'une ligne dans la colonne
+	static void ReadProperty(const FProperty* Property, const UEnum* Enum, const uint8* Row, FTrajectoryChannelColumn& Column, int32 Index)
+	{
+		const void* Value = Property->ContainerPtrToValuePtr<void>(Row);
+		switch (Column.Type)
+		{
+		case ETrajectoryChannelType::Float:
+			Column.Floats[Index] = CastFieldChecked<FFloatProperty>(Property)->GetPropertyValue(Value);
+			break;
+
+		case ETrajectoryChannelType::Double:
+			Column.Doubles[Index] = CastFieldChecked<FDoubleProperty>(Property)->GetPropertyValue(Value);
+			break;
+
+		case ETrajectoryChannelType::Enum:
+		{
+			const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property);
+			const int64 EnumValue = EnumProperty
+				? EnumProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(Value)
+				: CastFieldChecked<FByteProperty>(Property)->GetPropertyValue(Value);
+			Column.Ints[Index] = Enum->GetIndexByValue(EnumValue);
+			break;
+		}
+
+		case ETrajectoryChannelType::Int:
+		default:
+			if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+			{
+				Column.Ints[Index] = BoolProperty->GetPropertyValue(Value) ? 1 : 0;
+			}
+			else
+			{
+				Column.Ints[Index] = static_cast<int32>(CastFieldChecked<FNumericProperty>(Property)->GetSignedIntPropertyValue(Value));
+			}
+			break;
+		}
+	}
+}
+
+// ========== COLONNE ==========
+
+int32 FTrajectoryChannelColumn::Num() const
+{
+	switch (Type)
+	{
+	case ETrajectoryChannelType::Float:
+		return Floats.Num();
+	case ETrajectoryChannelType::Double:
+		return Doubles.Num();
+	default:
+		return Ints.Num();
+	}
+}
+
+SIZE_T FTrajectoryChannelColumn::GetValueSize(ETrajectoryChannelType InType)
+{
+	return InType == ETrajectoryChannelType::Double ? sizeof(double) : sizeof(int32);
+}
+
+void* FTrajectoryChannelColumn::GetData()
+{
+	switch (Type)
+	{
+	case ETrajectoryChannelType::Float:
+		return Floats.GetData();
+	case ETrajectoryChannelType::Double:
+		return Doubles.GetData();
+	default:
+		return Ints.GetData();
+	}
+}
+
+void FTrajectoryChannelColumn::SetNumUninitialized(int32 Count)
+{
+	switch (Type)
+	{
+	case ETrajectoryChannelType::Float:
+		Floats.SetNumUninitialized(Count);
+		break;
+	case ETrajectoryChannelType::Double:
+		Doubles.SetNumUninitialized(Count);
+		break;
+	default:
+		Ints.SetNumUninitialized(Count);
+		break;
+	}
+}
+
+double FTrajectoryChannelColumn::Evaluate(const FTrajectorySampleLocation& Location) const
+{
+	switch (Type)
+	{
+	case ETrajectoryChannelType::Float:
+		return FMath::Lerp(Floats[Location.Lower], Floats[Location.Upper], Location.Alpha);
+	case ETrajectoryChannelType::Double:
+		return FMath::Lerp(Doubles[Location.Lower], Doubles[Location.Upper], static_cast<double>(Location.Alpha));
+	default:
+		return EvaluateIndex(Location);
+	}
+}
+
+SIZE_T FTrajectoryChannelColumn::GetAllocatedSize() const
+{
+	return Floats.GetAllocatedSize() + Doubles.GetAllocatedSize() + Ints.GetAllocatedSize() + EnumNames.GetAllocatedSize();
+}
+
+// ========== CANAUX ==========
+
+void FTrajectoryChannelSet::Init(TArray<FTrajectoryChannelDesc>&& InChannels, int32 InSampleCount, FDecodeChannels&& InDecoder, bool bInBackgroundDecode)
+{
+	Channels = MoveTemp(InChannels);
+	SampleCount = InSampleCount;
+	Decoder = MoveTemp(InDecoder);
+	bBackgroundDecode = bInBackgroundDecode;
+
+	Columns.Reset();
+	Columns.SetNum(Channels.Num());
+	FailedChannels.Init(false, Channels.Num());
+	PendingChannels.Init(false, Channels.Num());
+	AsyncDecodes.Reset();
+}
+
+void FTrajectoryChannelSet::Reset()
+{
+	Channels.Reset();
+	SampleCount = 0;
+	Decoder = nullptr;
+	bBackgroundDecode = false;
+	Columns.Reset();
+	FailedChannels.Reset();
+	PendingChannels.Reset();
+	AsyncDecodes.Reset();
+}
+
+int32 FTrajectoryChannelSet::FindChannel(FName Name) const
+{
+	return Channels.IndexOfByPredicate([Name](const FTrajectoryChannelDesc& Channel)
+		{
+			return Channel.Name == Name;
+		});
+}
+
+void FTrajectoryChannelSet::GetChannelNames(TArray<FName>& OutNames) const
+{
+	OutNames.Reset(Channels.Num());
+	for (const FTrajectoryChannelDesc& Channel : Channels)
+	{
+		OutNames.Add(Channel.Name);
+	}
+}
+
+bool FTrajectoryChannelSet::Decode(TConstArrayView<int32> ChannelIndices) const
+{
+	// Canaux demandés qui restent à décoder
+	bool bAllDecoded = true;
+	TArray<int32, TInlineAllocator<16>> Pending;
+	for (const int32 ChannelIndex : ChannelIndices)
+	{
+		if (!Channels.IsValidIndex(ChannelIndex) || FailedChannels[ChannelIndex])
+		{
+			bAllDecoded = false;
+		}
+		else if (!Columns[ChannelIndex].IsValid())
+		{
+			Pending.AddUnique(ChannelIndex);
+		}
+	}
+	if (Pending.Num() == 0)
+	{
+		return bAllDecoded;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTrajectoryChannelSet::Decode);
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_ChannelDecode);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<TUniquePtr<FTrajectoryChannelColumn>> NewColumns;
+	TArray<FTrajectoryChannelColumn*, TInlineAllocator<16>> Outputs;
+	for (const int32 ChannelIndex : Pending)
+	{
+		TUniquePtr<FTrajectoryChannelColumn>& Column = NewColumns.Add_GetRef(MakeUnique<FTrajectoryChannelColumn>());
+		Column->Type = Channels[ChannelIndex].Type;
+		Outputs.Add(Column.Get());
+	}
+
+	// Une seule lecture de la source pour tous les canaux demandés
+	const bool bDecoded = Decoder && Decoder(Pending, Outputs);
+	bAllDecoded &= AcceptColumns(Pending, NewColumns, bDecoded);
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryChannels] Decoded %d channels of %d samples in %.2f ms"),
+		Pending.Num(), SampleCount, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return bAllDecoded;
+}
+
+bool FTrajectoryChannelSet::DecodeAsync(TConstArrayView<int32> ChannelIndices) const
+{
+	if (!bBackgroundDecode)
+	{
+		return Decode(ChannelIndices);
+	}
+
+	CollectAsyncDecodes();
+
+	// Canaux demandés qui ne sont ni décodés ni déjà en cours
+	bool bAllKnown = true;
+	TArray<int32> Pending;
+	for (const int32 ChannelIndex : ChannelIndices)
+	{
+		if (!Channels.IsValidIndex(ChannelIndex) || FailedChannels[ChannelIndex])
+		{
+			bAllKnown = false;
+		}
+		else if (!Columns[ChannelIndex].IsValid() && !PendingChannels[ChannelIndex])
+		{
+			Pending.AddUnique(ChannelIndex);
+		}
+	}
+	if (Pending.Num() == 0)
+	{
+		return bAllKnown;
+	}
+
+	TSharedPtr<FAsyncDecode, ESPMode::ThreadSafe> AsyncDecode = MakeShared<FAsyncDecode, ESPMode::ThreadSafe>();
+	AsyncDecode->ChannelIndices = Pending;
+	for (const int32 ChannelIndex : Pending)
+	{
+		TUniquePtr<FTrajectoryChannelColumn>& Column = AsyncDecode->Columns.Add_GetRef(MakeUnique<FTrajectoryChannelColumn>());
+		Column->Type = Channels[ChannelIndex].Type;
+		PendingChannels[ChannelIndex] = true;
+	}
+
+	// La tâche lit la source avec sa propre copie du décodeur : le jeu de canaux peut être réinitialisé entre-temps
+	FPendingDecode& PendingDecode = AsyncDecodes.AddDefaulted_GetRef();
+	PendingDecode.State = AsyncDecode;
+	PendingDecode.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [AsyncDecode, ChannelDecoder = Decoder, ChannelCount = SampleCount]()
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(FTrajectoryChannelSet::DecodeAsync);
+			SCOPE_CYCLE_COUNTER(STAT_DataReplay_ChannelDecode);
+			LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+			const double StartTime = FPlatformTime::Seconds();
+
+			TArray<FTrajectoryChannelColumn*, TInlineAllocator<16>> Outputs;
+			for (const TUniquePtr<FTrajectoryChannelColumn>& Column : AsyncDecode->Columns)
+			{
+				Outputs.Add(Column.Get());
+			}
+			AsyncDecode->bDecoded = ChannelDecoder && ChannelDecoder(AsyncDecode->ChannelIndices, Outputs);
+
+			UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryChannels] Decoded %d channels of %d samples in background in %.2f ms"),
+				AsyncDecode->ChannelIndices.Num(), ChannelCount, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		},
+		UE::Tasks::ETaskPriority::BackgroundNormal);
+
+	return bAllKnown;
+}
+
+void FTrajectoryChannelSet::CollectAsyncDecodes() const
+{
+	for (int32 i = AsyncDecodes.Num() - 1; i >= 0; i--)
+	{
+		if (!AsyncDecodes[i].Task.IsCompleted())
+		{
+			continue;
+		}
+
+		FAsyncDecode& AsyncDecode = *AsyncDecodes[i].State;
+		for (const int32 ChannelIndex : AsyncDecode.ChannelIndices)
+		{
+			PendingChannels[ChannelIndex] = false;
+		}
+		AcceptColumns(AsyncDecode.ChannelIndices, AsyncDecode.Columns, AsyncDecode.bDecoded);
+		AsyncDecodes.RemoveAtSwap(i);
+	}
+}
+
+bool FTrajectoryChannelSet::AcceptColumns(TConstArrayView<int32> ChannelIndices, TArray<TUniquePtr<FTrajectoryChannelColumn>>& NewColumns, bool bDecoded) const
+{
+	bool bAllDecoded = true;
+	for (int32 i = 0; i < ChannelIndices.Num(); i++)
+	{
+		const int32 ChannelIndex = ChannelIndices[i];
+		if (Columns[ChannelIndex].IsValid())
+		{
+			// Déjà décodé entre-temps par un appel synchrone
+			continue;
+		}
+
+		if (bDecoded && NewColumns[i]->Num() == SampleCount)
+		{
+			Columns[ChannelIndex] = MoveTemp(NewColumns[i]);
+		}
+		else
+		{
+			FailedChannels[ChannelIndex] = true;
+			bAllDecoded = false;
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryChannels] Cannot decode channel %s (source changed or unavailable)"), *Channels[ChannelIndex].Name.ToString());
+		}
+	}
+	return bAllDecoded;
+}
+
+const FTrajectoryChannelColumn* FTrajectoryChannelSet::GetColumn(int32 ChannelIndex) const
+{
+	if (!Columns.IsValidIndex(ChannelIndex))
+	{
+		return nullptr;
+	}
+
+	if (!AsyncDecodes.IsEmpty())
+	{
+		CollectAsyncDecodes();
+	}
+
+	// Source décodable en tâche de fond : jamais de relecture sur le thread appelant, la colonne arrive à un appel suivant
+	if (!Columns[ChannelIndex].IsValid() && !FailedChannels[ChannelIndex])
+	{
+		if (bBackgroundDecode)
+		{
+			DecodeAsync(MakeArrayView(&ChannelIndex, 1));
+		}
+		else
+		{
+			Decode(MakeArrayView(&ChannelIndex, 1));
+		}
+	}
+	return Columns[ChannelIndex].Get();
+}
+
+bool FTrajectoryChannelSet::Evaluate(int32 ChannelIndex, const FTrajectorySampleLocation& Location, double& OutValue) const
+{
+	const FTrajectoryChannelColumn* Column = GetColumn(ChannelIndex);
+	if (Column == nullptr || Location.Upper >= Column->Num())
+	{
+		return false;
+	}
+
+	OutValue = Column->Evaluate(Location);
+	return true;
+}
+
+bool FTrajectoryChannelSet::EvaluateEnum(int32 ChannelIndex, const FTrajectorySampleLocation& Location, FName& OutValue) const
+{
+	const FTrajectoryChannelColumn* Column = GetColumn(ChannelIndex);
+	if (Column == nullptr || Column->Type != ETrajectoryChannelType::Enum || Location.Upper >= Column->Num())
+	{
+		return false;
+	}
+
+	const int32 ValueIndex = Column->EvaluateIndex(Location);
+	OutValue = Column->EnumNames.IsValidIndex(ValueIndex) ? Column->EnumNames[ValueIndex] : NAME_None;
+	return true;
+}
+
+void FTrajectoryChannelSet::ReleaseDecoded()
+{
+	for (TUniquePtr<FTrajectoryChannelColumn>& Column : Columns)
+	{
+		Column.Reset();
+	}
+
+	// Les tâches en cours se terminent seules ; leurs colonnes ne seront pas intégrées
+	AsyncDecodes.Reset();
+	PendingChannels.Init(false, Channels.Num());
+}
+
+SIZE_T FTrajectoryChannelSet::GetAllocatedSize() const
+{
+	SIZE_T Size = 0;
+	for (const TUniquePtr<FTrajectoryChannelColumn>& Column : Columns)
+	{
+		Size += Column.IsValid() ? Column->GetAllocatedSize() : 0;
+	}
+	return Size;
+}
+
+// ========== SOURCES ==========
+
+void FTrajectoryChannelSet::OpenDataTable(const UDataTable* DataTable, int32 InSampleCount, FTrajectoryChannelSet& OutChannels)
+{
+	using namespace TrajectoryChannels;
+
+	OutChannels.Reset();
+
+	const UScriptStruct* RowStruct = DataTable ? DataTable->GetRowStruct() : nullptr;
+	if (RowStruct == nullptr || RowStruct == FDroneWaypointRow::StaticStruct() || !RowStruct->IsChildOf(FDroneWaypointRow::StaticStruct()))
+	{
+		return;
+	}
+
+	// Une colonne par propriété ajoutée à FDroneWaypointRow par la structure dérivée
+	TArray<FTrajectoryChannelDesc> TableChannels;
+	TArray<const FProperty*> Properties;
+	TArray<const UEnum*> Enums;
+	for (TFieldIterator<FProperty> It(RowStruct); It; ++It)
+	{
+		const FProperty* Property = *It;
+		ETrajectoryChannelType Type;
+		const UEnum* Enum;
+		if (Property->GetOwnerStruct() == FDroneWaypointRow::StaticStruct() || !GetPropertyChannelType(Property, Type, Enum))
+		{
+			continue;
+		}
+
+		TableChannels.Add({ Property->GetFName(), Type });
+		Properties.Add(Property);
+		Enums.Add(Enum);
+	}
+	if (TableChannels.Num() == 0)
+	{
+		return;
+	}
+
+	TWeakObjectPtr<const UDataTable> WeakTable(DataTable);
+	TWeakObjectPtr<const UScriptStruct> WeakRowStruct(RowStruct);
+	OutChannels.Init(MoveTemp(TableChannels), InSampleCount,
+		[WeakTable, WeakRowStruct, Properties = MoveTemp(Properties), Enums = MoveTemp(Enums)](TConstArrayView<int32> ChannelIndices, TArrayView<FTrajectoryChannelColumn* const> OutColumns)
+		{
+			const UDataTable* Table = WeakTable.Get();
+			if (Table == nullptr || !WeakRowStruct.IsValid() || Table->GetRowStruct() != WeakRowStruct.Get())
+			{
+				return false;
+			}
+
+			// Lignes dans l'ordre de AppendFromDataTable, puis ordre final du chargement (validation et tri)
+			FTrajectorySampleBuffer Samples;
+			Samples.AppendFromDataTable(Table);
+			TArray<int32> Order;
+			Samples.GetLoadOrder(Order);
+
+			TArray<const uint8*> Rows;
+			Rows.Reserve(Table->GetRowMap().Num());
+			for (const TPair<FName, uint8*>& RowPair : Table->GetRowMap())
+			{
+				if (RowPair.Value)
+				{
+					Rows.Add(RowPair.Value);
+				}
+			}
+
+			for (int32 i = 0; i < ChannelIndices.Num(); i++)
+			{
+				const FProperty* Property = Properties[ChannelIndices[i]];
+				const UEnum* Enum = Enums[ChannelIndices[i]];
+				FTrajectoryChannelColumn& Column = *OutColumns[i];
+
+				if (Enum)
+				{
+					const int32 EnumCount = Enum->ContainsExistingMax() ? Enum->NumEnums() - 1 : Enum->NumEnums();
+					for (int32 EnumIndex = 0; EnumIndex < EnumCount; EnumIndex++)
+					{
+						Column.EnumNames.Add(FName(*Enum->GetNameStringByIndex(EnumIndex)));
+					}
+				}
+
+				Column.SetNumUninitialized(Order.Num());
+				for (int32 Sample = 0; Sample < Order.Num(); Sample++)
+				{
+					ReadProperty(Property, Enum, Rows[Order[Sample]], Column, Sample);
+				}
+			}
+			return true;
+		});
+}
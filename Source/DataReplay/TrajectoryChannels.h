@@ -0,0 +1,189 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "TrajectorySampleBuffer.h"
+#include "TrajectoryChannels.generated.h"
+
+class UDataTable;
+
+/**
+ * Type des valeurs d'un canal de télémétrie
+ */
+UENUM(BlueprintType)
+enum class ETrajectoryChannelType : uint8
+{
+	// Flottant simple précision (tension batterie, vitesse air...), interpolé entre deux échantillons
+	Float UMETA(DisplayName = "Float"),
+
+	// Flottant double précision (latitude, longitude), interpolé entre deux échantillons
+	Double UMETA(DisplayName = "Double"),
+
+	// Entier (qualité du fix GPS, satellites, drapeaux) : valeur du dernier échantillon atteint
+	Int UMETA(DisplayName = "Int"),
+
+	// Valeur nommée (mode de vol) : index dans les noms du canal, valeur du dernier échantillon atteint
+	Enum UMETA(DisplayName = "Enum")
+};
+
+/**
+ * Description d'un canal : nom dans la source et type des valeurs
+ */
+struct FTrajectoryChannelDesc
+{
+	FName Name;
+	ETrajectoryChannelType Type = ETrajectoryChannelType::Float;
+};
+
+/**
+ * Valeurs décodées d'un canal, une par échantillon dans l'ordre du FTrajectorySampleBuffer
+ * Seule la colonne du type du canal est remplie
+ */
+struct DATAREPLAY_API FTrajectoryChannelColumn
+{
+	ETrajectoryChannelType Type = ETrajectoryChannelType::Float;
+
+	FTrajectorySampleBuffer::FAlignedFloatArray Floats;
+	TArray<double> Doubles;
+
+	// Int, ou index dans EnumNames (Enum)
+	TArray<int32> Ints;
+
+	// Noms des valeurs d'un canal Enum
+	TArray<FName> EnumNames;
+
+	int32 Num() const;
+
+	// Taille d'une valeur stockée pour un type de canal (octets)
+	static SIZE_T GetValueSize(ETrajectoryChannelType InType);
+
+	// Données de la colonne du type
+	void* GetData();
+	const void* GetData() const { return const_cast<FTrajectoryChannelColumn*>(this)->GetData(); }
+
+	// Redimensionner la colonne du type sans initialiser les valeurs
+	void SetNumUninitialized(int32 Count);
+
+	// Valeur à l'emplacement donné : interpolée (Float, Double) ou en escalier (Int, Enum)
+	double Evaluate(const FTrajectorySampleLocation& Location) const;
+
+	// Index de la valeur d'un canal Int ou Enum à l'emplacement donné
+	int32 EvaluateIndex(const FTrajectorySampleLocation& Location) const
+	{
+		return Ints[Location.Alpha >= 1.0f ? Location.Upper : Location.Lower];
+	}
+
+	SIZE_T GetAllocatedSize() const;
+};
+
+/**
+ * Canaux de télémétrie d'une trajectoire (attitude, batterie, qualité GPS, mode...), en plus de la position
+ * Chaque canal est une colonne typée identifiée par son nom. Seule la liste des canaux est lue au chargement :
+ * une colonne n'est décodée depuis la source qu'au premier accès, puis conservée jusqu'à ReleaseDecoded.
+ * L'évaluation reçoit l'emplacement déjà calculé pour la position (FTrajectorySampleBuffer::Locate) :
+ * la lecture sans canal ne coûte rien de plus, quel que soit le nombre de canaux de la source.
+ * Accès depuis un seul thread à la fois (le décodage d'un DataTable doit avoir lieu sur le thread de jeu).
+ * Une source décodable en tâche de fond (fichier CSV) n'est jamais relue sur le thread appelant par l'évaluation :
+ * le premier accès lance le décodage et l'évaluation renvoie false jusqu'à ce qu'il soit terminé.
+ */
+class DATAREPLAY_API FTrajectoryChannelSet
+{
+public:
+	/**
+	 * Décoder des canaux depuis la source : OutColumns[i] (Type déjà renseigné) reçoit le canal ChannelIndices[i],
+	 * dans l'ordre des échantillons chargés. Renvoie false si la source a changé ou n'est plus lisible.
+	 */
+	using FDecodeChannels = TFunction<bool(TConstArrayView<int32> ChannelIndices, TArrayView<FTrajectoryChannelColumn* const> OutColumns)>;
+
+	// Remplacer les canaux ; SampleCount : nombre d'échantillons chargés que chaque colonne décodée doit contenir
+	// bInBackgroundDecode : le décodeur peut être appelé depuis une tâche de fond
+	void Init(TArray<FTrajectoryChannelDesc>&& InChannels, int32 InSampleCount, FDecodeChannels&& InDecoder, bool bInBackgroundDecode = false);
+
+	void Reset();
+
+	int32 Num() const { return Channels.Num(); }
+	bool IsEmpty() const { return Channels.Num() == 0; }
+
+	// Index du canal, ou INDEX_NONE
+	int32 FindChannel(FName Name) const;
+
+	const FTrajectoryChannelDesc& GetChannel(int32 ChannelIndex) const { return Channels[ChannelIndex]; }
+	void GetChannelNames(TArray<FName>& OutNames) const;
+
+	bool IsDecoded(int32 ChannelIndex) const { return Columns[ChannelIndex].IsValid(); }
+
+	// Décodage en tâche de fond en cours pour ce canal
+	bool IsDecodePending(int32 ChannelIndex) const { return PendingChannels.IsValidIndex(ChannelIndex) && PendingChannels[ChannelIndex]; }
+
+	/**
+	 * Décoder en une seule lecture de la source les canaux demandés qui ne le sont pas encore
+	 * Renvoie false si l'un d'eux ne peut pas être décodé (il ne sera pas redemandé à la source).
+	 */
+	bool Decode(TConstArrayView<int32> ChannelIndices) const;
+
+	/**
+	 * Lancer en une seule tâche de fond le décodage des canaux demandés qui ne sont ni décodés ni en cours
+	 * Source qui ne se décode que sur le thread appelant (DataTable) : décodage immédiat, comme Decode.
+	 * Renvoie false si l'un d'eux est inconnu ou a déjà échoué.
+	 */
+	bool DecodeAsync(TConstArrayView<int32> ChannelIndices) const;
+
+	// Colonne du canal, décodée au premier accès ; nullptr si le décodage a échoué ou est en cours en tâche de fond
+	const FTrajectoryChannelColumn* GetColumn(int32 ChannelIndex) const;
+
+	// Valeur du canal à l'emplacement donné (Enum : index de la valeur)
+	bool Evaluate(int32 ChannelIndex, const FTrajectorySampleLocation& Location, double& OutValue) const;
+
+	// Nom de la valeur d'un canal Enum à l'emplacement donné
+	bool EvaluateEnum(int32 ChannelIndex, const FTrajectorySampleLocation& Location, FName& OutValue) const;
+
+	// Libérer les colonnes décodées et abandonner les décodages en cours (ils seront relancés au prochain accès)
+	void ReleaseDecoded();
+
+	// Mémoire allouée par les colonnes décodées (octets)
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * Canaux d'un DataTable dont la structure de lignes dérive de FDroneWaypointRow : une colonne par propriété ajoutée
+	 * (float, double, entier, booléen ou énumération). InSampleCount : échantillons chargés depuis ce DataTable.
+	 */
+	static void OpenDataTable(const UDataTable* DataTable, int32 InSampleCount, FTrajectoryChannelSet& OutChannels);
+
+private:
+	// Résultat d'un décodage en tâche de fond ; la tâche le garde en vie même si le jeu de canaux l'abandonne
+	struct FAsyncDecode
+	{
+		TArray<int32> ChannelIndices;
+		TArray<TUniquePtr<FTrajectoryChannelColumn>> Columns;
+		bool bDecoded = false;
+	};
+
+	struct FPendingDecode
+	{
+		TSharedPtr<FAsyncDecode, ESPMode::ThreadSafe> State;
+		UE::Tasks::FTask Task;
+	};
+
+	// Intégrer les colonnes des décodages en tâche de fond terminés
+	void CollectAsyncDecodes() const;
+
+	// Conserver les colonnes décodées de bonne taille, marquer les autres canaux en échec ; renvoie false si l'un a échoué
+	bool AcceptColumns(TConstArrayView<int32> ChannelIndices, TArray<TUniquePtr<FTrajectoryChannelColumn>>& NewColumns, bool bDecoded) const;
+
+	TArray<FTrajectoryChannelDesc> Channels;
+	int32 SampleCount = 0;
+	FDecodeChannels Decoder;
+	bool bBackgroundDecode = false;
+
+	// Colonnes décodées (nulles tant que le canal n'a pas été demandé)
+	mutable TArray<TUniquePtr<FTrajectoryChannelColumn>> Columns;
+
+	// Canaux dont le décodage a échoué
+	mutable TBitArray<> FailedChannels;
+
+	// Canaux en cours de décodage en tâche de fond et décodages lancés
+	mutable TBitArray<> PendingChannels;
+	mutable TArray<FPendingDecode> AsyncDecodes;
+};
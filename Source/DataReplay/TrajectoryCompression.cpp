@@ -0,0 +1,471 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryCompression.h"
+#include "DataReplay.h"
+#include "TrajectorySampleBuffer.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Math/VectorRegister.h"
+#include "Templates/IntegerSequence.h"
+
+namespace TrajectoryCompression
+{
+	// Version du format sérialisé
+	constexpr uint32 FormatVersion = 1;
+
+	// Plus grande valeur quantifiée : exactement représentable par un float
+	constexpr uint32 MaxQuantized = (1u << 24) - 1;
+
+	// Groupes de 4 échantillons par bloc
+	constexpr int32 GroupCount = FTrajectoryCompressedSamples::BlockSize / 4;
+
+	// 32 valeurs de BitWidth bits occupent exactement BitWidth mots par voie : le déballage se fait par séries de 32 groupes
+	constexpr int32 GroupsPerRun = 32;
+
+	/**
+	 * Déballer les groupes Group..31 d'une série, cumuler les différences et écrire les floats
+	 * Positions de bits connues à la compilation : aucun décalage variable, aucune branche
+	 */
+	template<uint32 BitWidth, uint32 Group>
+	FORCEINLINE void UnpackRun(const uint32* RESTRICT Words, VectorRegister4Int& Accumulator, const VectorRegister4Int& MinDelta,
+		const VectorRegister4Float& Origin, const VectorRegister4Float& Step, float* RESTRICT Out)
+	{
+		if constexpr (Group < GroupsPerRun)
+		{
+			VectorRegister4Int Value = GlobalVectorConstants::IntZero;
+			if constexpr (BitWidth > 0)
+			{
+				constexpr uint32 BitPosition = Group * BitWidth;
+				constexpr uint32 WordIndex = BitPosition / 32;
+				constexpr uint32 Shift = BitPosition % 32;
+
+				Value = VectorShiftRightImmLogical(VectorIntLoad(Words + WordIndex * 4), Shift);
+				if constexpr (Shift + BitWidth > 32)
+				{
+					// La valeur déborde sur le mot suivant de la même voie
+					Value = VectorIntOr(Value, VectorShiftLeftImm(VectorIntLoad(Words + (WordIndex + 1) * 4), 32 - Shift));
+				}
+				if constexpr (BitWidth < 32)
+				{
+					Value = VectorIntAnd(Value, VectorIntSet1(static_cast<int32>((1u << BitWidth) - 1)));
+				}
+			}
+
+			// Somme cumulée verticale (chaque voie porte une suite sur quatre), puis Origin + q * Step
+			Accumulator = VectorIntAdd(Accumulator, VectorIntAdd(Value, MinDelta));
+			VectorStore(VectorMultiplyAdd(VectorIntToFloat(Accumulator), Step, Origin), Out + Group * 4);
+
+			UnpackRun<BitWidth, Group + 1>(Words, Accumulator, MinDelta, Origin, Step, Out);
+		}
+	}
+
+	// Décoder une colonne d'un bloc empaquetée sur BitWidth bits
+	template<uint32 BitWidth>
+	void UnpackBlockChannel(const uint32* RESTRICT Words, uint32 Base, int32 MinDelta, float Origin, float Step, float* RESTRICT Out)
+	{
+		VectorRegister4Int Accumulator = VectorIntSet1(static_cast<int32>(Base));
+		const VectorRegister4Int MinDeltaVector = VectorIntSet1(MinDelta);
+		const VectorRegister4Float OriginVector = VectorSetFloat1(Origin);
+		const VectorRegister4Float StepVector = VectorSetFloat1(Step);
+
+		for (int32 Run = 0; Run < GroupCount / GroupsPerRun; Run++)
+		{
+			UnpackRun<BitWidth, 0>(Words + Run * BitWidth * 4, Accumulator, MinDeltaVector, OriginVector, StepVector, Out + Run * GroupsPerRun * 4);
+		}
+	}
+
+	using FUnpackFunction = void (*)(const uint32*, uint32, int32, float, float, float*);
+
+	template<uint32... BitWidths>
+	const FUnpackFunction* MakeUnpackTable(TIntegerSequence<uint32, BitWidths...>)
+	{
+		static const FUnpackFunction Table[] = { &UnpackBlockChannel<BitWidths>... };
+		return Table;
+	}
+
+	// Une fonction de déballage par largeur, de 0 à 32 bits
+	const FUnpackFunction* GetUnpackTable()
+	{
+		return MakeUnpackTable(TMakeIntegerSequence<uint32, 33>());
+	}
+
+	uint32 GetBitWidth(uint32 Value)
+	{
+		return Value == 0 ? 0 : 32 - FMath::CountLeadingZeros(Value);
+	}
+}
+
+// ========== COMPRESSION ==========
+
+void FTrajectoryCompressedSamples::Reset()
+{
+	SampleCount = 0;
+	for (int32 Channel = 0; Channel < ChannelCount; Channel++)
+	{
+		Origins[Channel] = 0.0f;
+		Steps[Channel] = 0.0f;
+	}
+	Blocks.Reset();
+	Words.Reset();
+}
+
+int64 FTrajectoryCompressedSamples::GetCompressedSize() const
+{
+	return sizeof(SampleCount) + sizeof(Origins) + sizeof(Steps)
+		+ static_cast<int64>(Blocks.Num()) * sizeof(FBlock)
+		+ static_cast<int64>(Words.Num()) * sizeof(uint32);
+}
+
+bool FTrajectoryCompressedSamples::Compress(const FTrajectorySampleBuffer& Samples, float PositionErrorBound, float TimeErrorBound)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TrajectoryCompression::Compress);
+	using namespace TrajectoryCompression;
+
+	Reset();
+
+	if (!(PositionErrorBound > 0.0f) || !(TimeErrorBound > 0.0f))
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryCompression] Error bounds must be positive (position %f, time %f)"), PositionErrorBound, TimeErrorBound);
+		return false;
+	}
+
+	const int32 Count = Samples.Num();
+	const float* Columns[ChannelCount] = { Samples.Times.GetData(), Samples.PosX.GetData(), Samples.PosY.GetData(), Samples.PosZ.GetData() };
+	const float ErrorBounds[ChannelCount] = { TimeErrorBound, PositionErrorBound, PositionErrorBound, PositionErrorBound };
+
+	// Quantification sur la boîte englobante de chaque colonne
+	for (int32 Channel = 0; Channel < ChannelCount; Channel++)
+	{
+		float MinValue = 0.0f;
+		float MaxValue = 0.0f;
+		if (Count > 0)
+		{
+			MinValue = MaxValue = Columns[Channel][0];
+			for (int32 i = 1; i < Count; i++)
+			{
+				MinValue = FMath::Min(MinValue, Columns[Channel][i]);
+				MaxValue = FMath::Max(MaxValue, Columns[Channel][i]);
+			}
+		}
+
+		const float RangeStep = static_cast<float>((static_cast<double>(MaxValue) - MinValue) / MaxQuantized);
+		Origins[Channel] = MinValue;
+		Steps[Channel] = FMath::Max(2.0f * ErrorBounds[Channel], RangeStep);
+
+		if (RangeStep > 2.0f * ErrorBounds[Channel])
+		{
+			UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryCompression] Channel %d spans more than 2^24 steps, error bound raised from %f to %f"),
+				Channel, ErrorBounds[Channel], GetErrorBound(Channel));
+		}
+	}
+
+	SampleCount = Count;
+	const int32 BlockCount = FMath::DivideAndRoundUp(Count, BlockSize);
+	Blocks.SetNum(BlockCount);
+
+	uint32 Quantized[BlockSize];
+	int32 Deltas[BlockSize];
+
+	for (int32 BlockIndex = 0; BlockIndex < BlockCount; BlockIndex++)
+	{
+		const int32 First = BlockIndex * BlockSize;
+
+		for (int32 Channel = 0; Channel < ChannelCount; Channel++)
+		{
+			// Quantifier (le dernier bloc est complété en répétant le dernier échantillon : différences nulles)
+			const double Origin = Origins[Channel];
+			const double InvStep = 1.0 / Steps[Channel];
+			for (int32 i = 0; i < BlockSize; i++)
+			{
+				const float Value = Columns[Channel][FMath::Min(First + i, Count - 1)];
+				const int64 Level = FMath::RoundToInt64((Value - Origin) * InvStep);
+				Quantized[i] = static_cast<uint32>(FMath::Clamp<int64>(Level, 0, MaxQuantized));
+			}
+
+			// Différences à pas de 4, décalées par la plus petite
+			FBlockChannel& Header = Blocks[BlockIndex].Channels[Channel];
+			Header.Base = Quantized[0];
+
+			int32 MinDelta = MAX_int32;
+			for (int32 i = 0; i < BlockSize; i++)
+			{
+				const uint32 Previous = (i < 4) ? Header.Base : Quantized[i - 4];
+				Deltas[i] = static_cast<int32>(Quantized[i]) - static_cast<int32>(Previous);
+				MinDelta = FMath::Min(MinDelta, Deltas[i]);
+			}
+
+			uint32 AllBits = 0;
+			for (int32 i = 0; i < BlockSize; i++)
+			{
+				Deltas[i] -= MinDelta;
+				AllBits |= static_cast<uint32>(Deltas[i]);
+			}
+
+			Header.MinDelta = MinDelta;
+			Header.BitWidth = GetBitWidth(AllBits);
+			Header.WordOffset = Words.Num();
+
+			const int32 BitWidth = Header.BitWidth;
+			if (BitWidth == 0)
+			{
+				continue;
+			}
+
+			// Empaquetage vertical : la voie k du groupe g va dans le flux de bits de la voie k
+			Words.AddZeroed(GroupCount / GroupsPerRun * BitWidth * 4);
+			uint32* Dest = Words.GetData() + Header.WordOffset;
+			for (int32 Group = 0; Group < GroupCount; Group++)
+			{
+				const int32 BitPosition = (Group % GroupsPerRun) * BitWidth;
+				const int32 WordIndex = (Group / GroupsPerRun) * BitWidth + BitPosition / 32;
+				const int32 Shift = BitPosition % 32;
+
+				for (int32 Lane = 0; Lane < 4; Lane++)
+				{
+					const uint32 Value = static_cast<uint32>(Deltas[Group * 4 + Lane]);
+					Dest[WordIndex * 4 + Lane] |= Value << Shift;
+					if (Shift + BitWidth > 32)
+					{
+						Dest[(WordIndex + 1) * 4 + Lane] |= Value >> (32 - Shift);
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+// ========== DÉCOMPRESSION ==========
+
+void FTrajectoryCompressedSamples::DecodeBlock(int32 BlockIndex, float* RESTRICT OutTimes, float* RESTRICT OutX, float* RESTRICT OutY, float* RESTRICT OutZ) const
+{
+	const TrajectoryCompression::FUnpackFunction* UnpackTable = TrajectoryCompression::GetUnpackTable();
+	float* Outputs[ChannelCount] = { OutTimes, OutX, OutY, OutZ };
+
+	const FBlock& Block = Blocks[BlockIndex];
+	for (int32 Channel = 0; Channel < ChannelCount; Channel++)
+	{
+		const FBlockChannel& Header = Block.Channels[Channel];
+		UnpackTable[Header.BitWidth](Words.GetData() + Header.WordOffset, Header.Base, Header.MinDelta, Origins[Channel], Steps[Channel], Outputs[Channel]);
+	}
+}
+
+bool FTrajectoryCompressedSamples::Decompress(FTrajectorySampleBuffer& OutSamples) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TrajectoryCompression::Decompress);
+	OutSamples.Reset();
+	if (SampleCount == 0)
+	{
+		return true;
+	}
+
+	OutSamples.SetNumUninitialized(SampleCount);
+
+	// Blocs complets décodés directement dans les colonnes
+	const int32 FullBlockCount = SampleCount / BlockSize;
+	ParallelFor(TEXT("TrajectoryCompression.Decode"), FullBlockCount, 16, [this, &OutSamples](int32 BlockIndex)
+		{
+			const int32 First = BlockIndex * BlockSize;
+			DecodeBlock(BlockIndex, OutSamples.Times.GetData() + First, OutSamples.PosX.GetData() + First,
+				OutSamples.PosY.GetData() + First, OutSamples.PosZ.GetData() + First);
+		});
+
+	// Dernier bloc incomplet : décodé à part puis copié
+	const int32 Remaining = SampleCount - FullBlockCount * BlockSize;
+	if (Remaining > 0)
+	{
+		alignas(16) float Decoded[ChannelCount][BlockSize];
+		DecodeBlock(FullBlockCount, Decoded[0], Decoded[1], Decoded[2], Decoded[3]);
+
+		const int32 First = FullBlockCount * BlockSize;
+		FMemory::Memcpy(OutSamples.Times.GetData() + First, Decoded[0], Remaining * sizeof(float));
+		FMemory::Memcpy(OutSamples.PosX.GetData() + First, Decoded[1], Remaining * sizeof(float));
+		FMemory::Memcpy(OutSamples.PosY.GetData() + First, Decoded[2], Remaining * sizeof(float));
+		FMemory::Memcpy(OutSamples.PosZ.GetData() + First, Decoded[3], Remaining * sizeof(float));
+	}
+
+	return true;
+}
+
+// ========== SÉRIALISATION ==========
+
+FArchive& operator<<(FArchive& Ar, FTrajectoryCompressedSamples& Compressed)
+{
+	uint32 Version = TrajectoryCompression::FormatVersion;
+	Ar << Version;
+	if (Ar.IsLoading() && Version != TrajectoryCompression::FormatVersion)
+	{
+		Ar.SetError();
+		Compressed.Reset();
+		return Ar;
+	}
+
+	Ar << Compressed.SampleCount;
+	for (int32 Channel = 0; Channel < FTrajectoryCompressedSamples::ChannelCount; Channel++)
+	{
+		Ar << Compressed.Origins[Channel];
+		Ar << Compressed.Steps[Channel];
+	}
+
+	int32 BlockCount = Compressed.Blocks.Num();
+	Ar << BlockCount;
+	if (Ar.IsLoading())
+	{
+		if (Compressed.SampleCount < 0 || BlockCount != FMath::DivideAndRoundUp(Compressed.SampleCount, FTrajectoryCompressedSamples::BlockSize))
+		{
+			Ar.SetError();
+			Compressed.Reset();
+			return Ar;
+		}
+		Compressed.Blocks.SetNum(BlockCount);
+	}
+
+	for (FTrajectoryCompressedSamples::FBlock& Block : Compressed.Blocks)
+	{
+		for (FTrajectoryCompressedSamples::FBlockChannel& Channel : Block.Channels)
+		{
+			Ar << Channel.Base;
+			Ar << Channel.MinDelta;
+			Ar << Channel.WordOffset;
+			Ar << Channel.BitWidth;
+		}
+	}
+
+	Compressed.Words.BulkSerialize(Ar);
+
+	// Un bloc ne doit jamais lire au-delà des mots chargés
+	if (Ar.IsLoading())
+	{
+		for (const FTrajectoryCompressedSamples::FBlock& Block : Compressed.Blocks)
+		{
+			for (const FTrajectoryCompressedSamples::FBlockChannel& Channel : Block.Channels)
+			{
+				const int64 WordEnd = static_cast<int64>(Channel.WordOffset) + TrajectoryCompression::GroupCount / TrajectoryCompression::GroupsPerRun * Channel.BitWidth * 4;
+				if (Channel.BitWidth > 32 || WordEnd > Compressed.Words.Num())
+				{
+					Ar.SetError();
+					Compressed.Reset();
+					return Ar;
+				}
+			}
+		}
+	}
+
+	return Ar;
+}
+
+// ========== MESURE ==========
+
+FTrajectoryCompressionStats FTrajectoryCompressedSamples::Measure(const FTrajectorySampleBuffer& Samples, float PositionErrorBound, float TimeErrorBound)
+{
+	FTrajectoryCompressionStats Stats;
+	Stats.SampleCount = Samples.Num();
+	Stats.RawBytes = static_cast<int64>(Samples.Num()) * ChannelCount * sizeof(float);
+
+	FTrajectoryCompressedSamples Compressed;
+	const double EncodeStart = FPlatformTime::Seconds();
+	if (!Compressed.Compress(Samples, PositionErrorBound, TimeErrorBound))
+	{
+		return Stats;
+	}
+	Stats.EncodeMilliseconds = (FPlatformTime::Seconds() - EncodeStart) * 1000.0;
+	Stats.CompressedBytes = Compressed.GetCompressedSize();
+
+	// Décodage sur un seul thread, bloc par bloc, pour mesurer le déballage lui-même
+	FTrajectorySampleBuffer Decoded;
+	Decoded.SetNumUninitialized(Compressed.GetNumBlocks() * BlockSize);
+
+	const double DecodeStart = FPlatformTime::Seconds();
+	for (int32 BlockIndex = 0; BlockIndex < Compressed.GetNumBlocks(); BlockIndex++)
+	{
+		const int32 First = BlockIndex * BlockSize;
+		Compressed.DecodeBlock(BlockIndex, Decoded.Times.GetData() + First, Decoded.PosX.GetData() + First,
+			Decoded.PosY.GetData() + First, Decoded.PosZ.GetData() + First);
+	}
+	Stats.DecodeMilliseconds = (FPlatformTime::Seconds() - DecodeStart) * 1000.0;
+
+	for (int32 i = 0; i < Samples.Num(); i++)
+	{
+		Stats.MaxTimeError = FMath::Max(Stats.MaxTimeError, FMath::Abs(Decoded.Times[i] - Samples.Times[i]));
+		Stats.MaxPositionError = FMath::Max(Stats.MaxPositionError, FMath::Abs(Decoded.PosX[i] - Samples.PosX[i]));
+		Stats.MaxPositionError = FMath::Max(Stats.MaxPositionError, FMath::Abs(Decoded.PosY[i] - Samples.PosY[i]));
+		Stats.MaxPositionError = FMath::Max(Stats.MaxPositionError, FMath::Abs(Decoded.PosZ[i] - Samples.PosZ[i]));
+	}
+
+	return Stats;
+}
+
+void FTrajectoryCompressedSamples::MakeSyntheticFlight(int32 Count, float SampleRate, int32 Seed, FTrajectorySampleBuffer& OutSamples)
+{
+	FRandomStream Random(Seed);
+
+	OutSamples.Reset();
+	OutSamples.Reserve(Count);
+
+	const double Interval = 1.0 / SampleRate;
+	const int32 ManeuverSamples = FMath::Max(1, FMath::RoundToInt(20.0f * SampleRate));
+	const double Speed = 1500.0;
+
+	double Time = 0.0;
+	double Heading = Random.FRandRange(0.0f, UE_TWO_PI);
+	double TurnRate = 0.0;
+	double ClimbRate = 0.0;
+	double TargetTurnRate = 0.0;
+	double TargetClimbRate = 0.0;
+	FVector Position(0.0, 0.0, 10000.0);
+
+	for (int32 i = 0; i < Count; i++)
+	{
+		// Nouvelle manœuvre toutes les 20 secondes, atteinte progressivement
+		if (i % ManeuverSamples == 0)
+		{
+			TargetTurnRate = Random.FRandRange(-0.15f, 0.15f);
+			TargetClimbRate = Random.FRandRange(-200.0f, 200.0f);
+		}
+		TurnRate += (TargetTurnRate - TurnRate) * FMath::Min(1.0, 0.5 * Interval);
+		ClimbRate += (TargetClimbRate - ClimbRate) * FMath::Min(1.0, 0.5 * Interval);
+
+		Heading += TurnRate * Interval;
+		Position += FVector(FMath::Cos(Heading) * Speed, FMath::Sin(Heading) * Speed, ClimbRate) * Interval;
+
+		OutSamples.Add(static_cast<float>(Time), Position.X, Position.Y, Position.Z);
+
+		// Horodatage quasi régulier (gigue de 0.1 %)
+		Time += Interval * (1.0 + Random.FRandRange(-0.001f, 0.001f));
+	}
+}
+
+namespace TrajectoryCompression
+{
+	// Taux de compression et débit de décodage sur des vols synthétiques de 100k à 10M échantillons
+	static void RunBenchmark(const TArray<FString>& Args)
+	{
+		const float PositionErrorBound = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 0.5f;
+		const float TimeErrorBound = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 0.0005f;
+		const int32 SampleCounts[] = { 100 * 1000, 1000 * 1000, 10 * 1000 * 1000 };
+
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryCompression] Benchmark: position error %.3f, time error %.5f s, synthetic flights at 100 Hz"),
+			PositionErrorBound, TimeErrorBound);
+
+		for (const int32 Count : SampleCounts)
+		{
+			FTrajectorySampleBuffer Samples;
+			FTrajectoryCompressedSamples::MakeSyntheticFlight(Count, 100.0f, Count, Samples);
+
+			const FTrajectoryCompressionStats Stats = FTrajectoryCompressedSamples::Measure(Samples, PositionErrorBound, TimeErrorBound);
+			const double DecodeSeconds = FMath::Max(Stats.DecodeMilliseconds / 1000.0, UE_DOUBLE_SMALL_NUMBER);
+			UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryCompression]   %9d samples: %10.1f KB -> %9.1f KB (x%.1f, %.2f bits/sample), max error %.4f / %.5f s, encode %.1f ms, decode %.1f ms (%.0f M samples/s, %.2f GB/s)"),
+				Stats.SampleCount, Stats.RawBytes / 1024.0, Stats.CompressedBytes / 1024.0, Stats.GetRatio(),
+				Stats.CompressedBytes * 8.0 / FMath::Max(Stats.SampleCount, 1), Stats.MaxPositionError, Stats.MaxTimeError,
+				Stats.EncodeMilliseconds, Stats.DecodeMilliseconds, Stats.SampleCount / DecodeSeconds / 1.0e6, Stats.RawBytes / DecodeSeconds / 1.0e9);
+		}
+	}
+
+	static FAutoConsoleCommand BenchmarkCommand(
+		TEXT("DataReplay.Compression.Benchmark"),
+		TEXT("Mesure le taux de compression et le débit de décodage sur des vols synthétiques de 100k à 10M échantillons.\n")
+		TEXT("Arguments optionnels : erreur de position (défaut 0.5) et erreur de temps en secondes (défaut 0.0005)."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmark));
+}
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FTrajectorySampleBuffer;
+
+/**
+ * Bilan d'une compression : taille, erreur mesurée et débits d'encodage / de décodage
+ */
+struct FTrajectoryCompressionStats
+{
+	int32 SampleCount = 0;
+
+	// Taille des échantillons bruts (16 octets par échantillon) et compressés (octets)
+	int64 RawBytes = 0;
+	int64 CompressedBytes = 0;
+
+	// Écart maximal mesuré après décodage, par axe (unités du monde) et sur le temps (secondes)
+	float MaxPositionError = 0.0f;
+	float MaxTimeError = 0.0f;
+
+	// Durées d'encodage et de décodage (sur un seul thread, millisecondes)
+	double EncodeMilliseconds = 0.0;
+	double DecodeMilliseconds = 0.0;
+
+	float GetRatio() const { return CompressedBytes > 0 ? static_cast<float>(static_cast<double>(RawBytes) / CompressedBytes) : 0.0f; }
+};
+
+/**
+ * Trajectoire compressée avec une erreur bornée
+ *
+ * Chaque colonne (Time, X, Y, Z) est quantifiée sur la boîte englobante de la trajectoire avec un pas
+ * de deux fois l'erreur demandée, puis découpée en blocs de BlockSize échantillons indépendants :
+ *   - différences à pas de 4 (q[i] - q[i-4]) : quatre suites entrelacées, une par voie SIMD ;
+ *   - décalage par la plus petite différence du bloc, puis empaquetage sur le nombre de bits minimal,
+ *     chaque voie dans ses propres mots de 32 bits (mots des quatre voies entrelacés).
+ * Le décodage d'un bloc n'a donc que des opérations verticales sur 4 entiers : décalages à nombre de bits
+ * constant (une fonction par largeur), somme cumulée par voie et conversion en float.
+ *
+ * Les temps quasi réguliers tiennent sur 0 ou 1 bit par échantillon, les positions lisses sur quelques bits.
+ * L'erreur est garantie par axe, à l'arrondi float près. Au plus 2^24 pas par colonne : au-delà, le pas
+ * est agrandi (la précision d'un float serait de toute façon dépassée) et GetErrorBound le rapporte.
+ */
+struct DATAREPLAY_API FTrajectoryCompressedSamples
+{
+	// Échantillons par bloc (64 groupes de 4)
+	static constexpr int32 BlockSize = 256;
+
+	// Nombre de colonnes : Time, X, Y, Z
+	static constexpr int32 ChannelCount = 4;
+
+	/**
+	 * Compresser des échantillons triés
+	 * PositionErrorBound : écart maximal par axe (unités du monde) ; TimeErrorBound : écart maximal sur le temps (secondes)
+	 */
+	bool Compress(const FTrajectorySampleBuffer& Samples, float PositionErrorBound, float TimeErrorBound);
+
+	// Décompresser toute la trajectoire (blocs décodés en parallèle)
+	bool Decompress(FTrajectorySampleBuffer& OutSamples) const;
+
+	/**
+	 * Décoder un bloc : BlockSize valeurs par colonne (les échantillons au-delà de Num() répètent le dernier)
+	 * Utilisable depuis plusieurs threads.
+	 */
+	void DecodeBlock(int32 BlockIndex, float* RESTRICT OutTimes, float* RESTRICT OutX, float* RESTRICT OutY, float* RESTRICT OutZ) const;
+
+	void Reset();
+
+	int32 Num() const { return SampleCount; }
+	int32 GetNumBlocks() const { return Blocks.Num(); }
+
+	// Erreur maximale garantie pour une colonne (0 : temps, 1 à 3 : X, Y, Z)
+	float GetErrorBound(int32 Channel) const { return Steps[Channel] * 0.5f; }
+
+	// Taille des données compressées (octets)
+	int64 GetCompressedSize() const;
+
+	friend FArchive& operator<<(FArchive& Ar, FTrajectoryCompressedSamples& Compressed);
+
+	// ========== MESURE ==========
+
+	// Compresser puis décompresser, en mesurant taille, erreur et durées
+	static FTrajectoryCompressionStats Measure(const FTrajectorySampleBuffer& Samples, float PositionErrorBound, float TimeErrorBound);
+
+	// Trajectoire synthétique de vol lisse (virages, montées, horodatage quasi régulier à SampleRate Hz)
+	static void MakeSyntheticFlight(int32 Count, float SampleRate, int32 Seed, FTrajectorySampleBuffer& OutSamples);
+
+private:
+	// En-tête d'une colonne dans un bloc
+	struct FBlockChannel
+	{
+		// Première valeur quantifiée du bloc (référence des quatre premières différences)
+		uint32 Base = 0;
+
+		// Plus petite différence du bloc, retirée avant empaquetage
+		int32 MinDelta = 0;
+
+		// Premier mot de la colonne dans Words (8 * BitWidth mots)
+		uint32 WordOffset = 0;
+
+		uint32 BitWidth = 0;
+	};
+
+	struct FBlock
+	{
+		FBlockChannel Channels[ChannelCount];
+	};
+
+	int32 SampleCount = 0;
+
+	// Quantification : valeur = Origin + q * Step
+	float Origins[ChannelCount] = {};
+	float Steps[ChannelCount] = {};
+
+	TArray<FBlock> Blocks;
+	TArray<uint32> Words;
+};
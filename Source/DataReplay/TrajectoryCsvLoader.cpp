@@ -0,0 +1,1169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryCsvLoader.h"
+#include "DataReplay.h"
+#include "TrajectorySampleBuffer.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include <limits>
+
+namespace TrajectoryCsv
+{
+	// Taille minimale d'un bloc analysé par une tâche
+	static constexpr int64 MinChunkBytes = 1024 * 1024;
+
+	// Taille d'un lot de lignes entre deux notifications de progression
+	static constexpr int64 BatchBytes = 64 * 1024 * 1024;
+
+	// Octets lus au début du fichier pour trouver les colonnes de télémétrie
+	static constexpr int64 HeaderBytes = 64 * 1024;
+
+	// Puissances de 10 représentables exactement en double
+	static constexpr double PowersOf10[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	static FORCEINLINE bool IsDigit(ANSICHAR C)
+	{
+		return C >= '0' && C <= '9';
+	}
+
+	static FORCEINLINE bool IsBlank(ANSICHAR C)
+	{
+		return C == ' ' || C == '\t' || C == '\r' || C == '"';
+	}
+
+	static FORCEINLINE const ANSICHAR* FindChar(const ANSICHAR* Begin, const ANSICHAR* End, ANSICHAR C)
+	{
+		const void* Found = memchr(Begin, C, End - Begin);
+		return Found ? static_cast<const ANSICHAR*>(Found) : End;
+	}
+
+	static bool IsBlankLine(const ANSICHAR* Begin, const ANSICHAR* End)
+	{
+		for (const ANSICHAR* P = Begin; P < End; ++P)
+		{
+			if (!IsBlank(*P))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static void TrimField(const ANSICHAR*& Begin, const ANSICHAR*& End)
+	{
+		while (Begin < End && IsBlank(*Begin))
+		{
+			++Begin;
+		}
+		while (End > Begin && IsBlank(End[-1]))
+		{
+			--End;
+		}
+	}
+
+	static bool FieldEquals(const ANSICHAR* Begin, const ANSICHAR* End, const ANSICHAR* Name)
+	{
+		TrimField(Begin, End);
+
+		const int32 Length = FCStringAnsi::Strlen(Name);
+		return (End - Begin) == Length && FCStringAnsi::Strnicmp(Begin, Name, Length) == 0;
+	}
+
+	/**
+	 * Lire le nom et le type d'une colonne de télémétrie ("Battery", "Lat:double", "Mode:enum")
+	 * Renvoie false pour une colonne sans nom ou pour la colonne des noms de lignes d'un export DataTable
+	 */
+	static bool ParseChannelColumn(const ANSICHAR* Begin, const ANSICHAR* End, FTrajectoryChannelDesc& OutDesc)
+	{
+		TrimField(Begin, End);
+		if (Begin == End || FieldEquals(Begin, End, "---"))
+		{
+			return false;
+		}
+
+		const ANSICHAR* NameEnd = FindChar(Begin, End, ':');
+		OutDesc.Type = ETrajectoryChannelType::Float;
+		if (NameEnd < End)
+		{
+			const ANSICHAR* TypeBegin = NameEnd + 1;
+			if (FieldEquals(TypeBegin, End, "double"))
+			{
+				OutDesc.Type = ETrajectoryChannelType::Double;
+			}
+			else if (FieldEquals(TypeBegin, End, "int"))
+			{
+				OutDesc.Type = ETrajectoryChannelType::Int;
+			}
+			else if (FieldEquals(TypeBegin, End, "enum"))
+			{
+				OutDesc.Type = ETrajectoryChannelType::Enum;
+			}
+		}
+
+		const ANSICHAR* NameBegin = Begin;
+		TrimField(NameBegin, NameEnd);
+		if (NameBegin == NameEnd)
+		{
+			return false;
+		}
+		OutDesc.Name = FName(static_cast<int32>(NameEnd - NameBegin), NameBegin);
+		return true;
+	}
+
+	/**
+	 * Fichier projeté en mémoire, ou lu en entier si la plateforme ne le permet pas
+	 */
+	struct FCsvFileView
+	{
+		TUniquePtr<IMappedFileHandle> MappedFile;
+		TUniquePtr<IMappedFileRegion> MappedRegion;
+		TArray64<uint8> FileBytes;
+
+		const ANSICHAR* Data = nullptr;
+		int64 Size = 0;
+
+		bool Open(IPlatformFile& PlatformFile, const FString& FilePath)
+		{
+			FOpenMappedResult MapResult = PlatformFile.OpenMappedEx(*FilePath);
+			if (MapResult.HasValue())
+			{
+				MappedFile = MapResult.StealValue();
+				if (MappedFile->GetFileSize() > 0)
+				{
+					MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+				}
+			}
+
+			if (MappedRegion)
+			{
+				Data = reinterpret_cast<const ANSICHAR*>(MappedRegion->GetMappedPtr());
+				Size = MappedRegion->GetMappedSize();
+				return true;
+			}
+
+			if (!FFileHelper::LoadFileToArray(FileBytes, *FilePath))
+			{
+				return false;
+			}
+			Data = reinterpret_cast<const ANSICHAR*>(FileBytes.GetData());
+			Size = FileBytes.Num();
+			return true;
+		}
+	};
+
+	// Découper les données en blocs qui commencent toujours en début de ligne ; Bounds reçoit ChunkCount + 1 bornes
+	static int32 SplitChunks(const ANSICHAR* Data, int64 Size, TArray<const ANSICHAR*>& Bounds)
+	{
+		const int32 MaxChunks = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads() * 4);
+		const int32 ChunkCount = static_cast<int32>(FMath::Clamp<int64>(Size / MinChunkBytes, 1, MaxChunks));
+
+		const ANSICHAR* End = Data + Size;
+		Bounds.SetNumUninitialized(ChunkCount + 1);
+		Bounds[0] = Data;
+		Bounds[ChunkCount] = End;
+
+		for (int32 Chunk = 1; Chunk < ChunkCount; Chunk++)
+		{
+			const ANSICHAR* Split = FMath::Max(Data + (Size * Chunk) / ChunkCount, Bounds[Chunk - 1]);
+			const ANSICHAR* NewLine = FindChar(Split, End, '\n');
+			Bounds[Chunk] = (NewLine < End) ? NewLine + 1 : End;
+		}
+		return ChunkCount;
+	}
+
+	/**
+	 * Analyser toutes les lignes d'un bloc
+	 * Slots associe chaque colonne à une composante (0 = Time, 1..3 = X/Y/Z) ou INDEX_NONE ;
+	 * AddSample reçoit les quatre composantes de chaque ligne valide, en double.
+	 * Renvoie le nombre de lignes non vides ignorées
+	 */
+	template <typename FAddSample>
+	static int32 ParseChunk(const ANSICHAR* Begin, const ANSICHAR* End, const TArray<int32>& Slots, FAddSample&& AddSample)
+	{
+		int32 SkippedLines = 0;
+		const int32 ColumnCount = Slots.Num();
+
+		const ANSICHAR* Line = Begin;
+		while (Line < End)
+		{
+			const ANSICHAR* LineEnd = FindChar(Line, End, '\n');
+
+			double Values[4];
+			uint32 FoundMask = 0;
+			bool bValid = true;
+
+			const ANSICHAR* Field = Line;
+			for (int32 Column = 0; Column < ColumnCount; Column++)
+			{
+				if (Field > LineEnd)
+				{
+					bValid = false;
+					break;
+				}
+
+				const ANSICHAR* FieldEnd = FindChar(Field, LineEnd, ',');
+				const int32 Slot = Slots[Column];
+				if (Slot != INDEX_NONE)
+				{
+					if (!FTrajectoryCsvLoader::ParseDouble(Field, FieldEnd, Values[Slot]))
+					{
+						bValid = false;
+						break;
+					}
+					FoundMask |= 1u << Slot;
+				}
+				Field = FieldEnd + 1;
+			}
+
+			if (bValid && FoundMask == 0xF)
+			{
+				AddSample(Values);
+			}
+			else if (!IsBlankLine(Line, LineEnd))
+			{
+				SkippedLines++;
+			}
+
+			Line = LineEnd + 1;
+		}
+
+		return SkippedLines;
+	}
+
+	// Composante associée à chaque colonne de position (0 = Time, 1..3 = X/Y/Z)
+	static void MakePositionSlots(const FTrajectoryCsvLayout& Layout, TArray<int32>& OutSlots)
+	{
+		OutSlots.Init(INDEX_NONE, Layout.GetLastColumn() + 1);
+		OutSlots[Layout.TimeColumn] = 0;
+		OutSlots[Layout.XColumn] = 1;
+		OutSlots[Layout.YColumn] = 2;
+		OutSlots[Layout.ZColumn] = 3;
+	}
+
+	/**
+	 * Échantillons géodésiques d'un bloc : latitude, longitude et altitude gardées en double jusqu'à la conversion
+	 * (en float, deux latitudes distantes de moins d'un mètre environ se confondent)
+	 */
+	struct FGeodeticChunk
+	{
+		TArray<float> Times;
+		TArray<double> Latitudes;
+		TArray<double> Longitudes;
+		TArray<double> Altitudes;
+
+		int32 Num() const { return Times.Num(); }
+
+		void Reserve(int32 Count)
+		{
+			Times.Reserve(Count);
+			Latitudes.Reserve(Count);
+			Longitudes.Reserve(Count);
+			Altitudes.Reserve(Count);
+		}
+
+		void Add(const double* Values)
+		{
+			Times.Add(static_cast<float>(Values[0]));
+			Latitudes.Add(Values[1]);
+			Longitudes.Add(Values[2]);
+			Altitudes.Add(Values[3]);
+		}
+	};
+
+	/**
+	 * Repère des positions géodésiques : celui demandé, sinon origine au premier échantillon valide des données
+	 * bComplete : la dernière ligne des données est complète même sans fin de ligne.
+	 * Renvoie false si aucune ligne complète ne permet encore de choisir l'origine.
+	 */
+	static bool ResolveGeoReference(const ANSICHAR* Data, int64 Size, bool bComplete, const FTrajectoryGeoReference& Requested, FTrajectoryCsvLayout& InOutLayout)
+	{
+		if (Requested.IsValid())
+		{
+			InOutLayout.GeoReference = Requested;
+			return true;
+		}
+
+		TArray<int32> Slots;
+		MakePositionSlots(InOutLayout, Slots);
+
+		const ANSICHAR* End = Data + Size;
+		const ANSICHAR* Line = Data;
+		while (Line < End)
+		{
+			const ANSICHAR* LineEnd = FindChar(Line, End, '\n');
+			if (LineEnd == End && !bComplete)
+			{
+				// Ligne peut-être incomplète
+				return false;
+			}
+
+			FTrajectoryGeoPosition Origin;
+			bool bFound = false;
+			ParseChunk(Line, FMath::Min(LineEnd + 1, End), Slots, [&Origin, &bFound](const double* Values)
+				{
+					Origin.Latitude = Values[1];
+					Origin.Longitude = Values[2];
+					Origin.Altitude = Values[3];
+					bFound = FMath::IsFinite(Values[1]) && FMath::IsFinite(Values[2]) && FMath::IsFinite(Values[3]);
+				});
+
+			if (bFound)
+			{
+				InOutLayout.GeoReference = FTrajectoryGeoReference(Origin);
+				return InOutLayout.GeoReference.IsValid();
+			}
+			Line = LineEnd + 1;
+		}
+		return false;
+	}
+
+	// Lire le début d'un fichier (en-tête et premières lignes)
+	static bool ReadHead(const FString& FilePath, TArray<uint8>& OutHead, int64& OutFileSize)
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+		if (!Reader)
+		{
+			return false;
+		}
+
+		OutFileSize = Reader->TotalSize();
+		OutHead.SetNumUninitialized(static_cast<int32>(FMath::Min(OutFileSize, HeaderBytes)));
+		Reader->Serialize(OutHead.GetData(), OutHead.Num());
+		return !Reader->IsError();
+	}
+
+	/**
+	 * Colonnes de télémétrie relues dans un bloc, pour les lignes retenues par ParseChunk
+	 * Values : un tableau par canal numérique demandé ; Names : un tableau par canal Enum demandé
+	 */
+	struct FChannelChunk
+	{
+		FTrajectorySampleBuffer Samples;
+		TArray<TArray<double>> Values;
+		TArray<TArray<FName>> Names;
+	};
+
+	/**
+	 * Relire les lignes d'un bloc avec les règles de ParseChunk en gardant aussi les colonnes de télémétrie demandées
+	 * ChannelSlots associe chaque colonne au canal demandé ou INDEX_NONE. Une valeur absente ou invalide
+	 * donne NaN (Float, Double), 0 (Int) ou None (Enum) sans invalider la ligne.
+	 */
+	static void ParseChannelChunk(const ANSICHAR* Begin, const ANSICHAR* End, const TArray<int32>& Slots, const TArray<int32>& ChannelSlots,
+		TConstArrayView<ETrajectoryChannelType> Types, FChannelChunk& Out)
+	{
+		const int32 PositionColumnCount = Slots.Num();
+		const int32 ColumnCount = FMath::Max(PositionColumnCount, ChannelSlots.Num());
+		const int32 ChannelCount = Types.Num();
+
+		TArray<double, TInlineAllocator<32>> LineValues;
+		TArray<FName, TInlineAllocator<32>> LineNames;
+		LineValues.SetNumUninitialized(ChannelCount);
+		LineNames.SetNumUninitialized(ChannelCount);
+
+		const ANSICHAR* Line = Begin;
+		while (Line < End)
+		{
+			const ANSICHAR* LineEnd = FindChar(Line, End, '\n');
+
+			for (int32 Channel = 0; Channel < ChannelCount; Channel++)
+			{
+				LineValues[Channel] = Types[Channel] == ETrajectoryChannelType::Int ? 0.0 : std::numeric_limits<double>::quiet_NaN();
+				LineNames[Channel] = NAME_None;
+			}
+
+			float Values[4];
+			uint32 FoundMask = 0;
+			bool bValid = true;
+
+			const ANSICHAR* Field = Line;
+			for (int32 Column = 0; Column < ColumnCount; Column++)
+			{
+				if (Field > LineEnd)
+				{
+					// Seule une colonne de position manquante invalide la ligne
+					bValid = Column >= PositionColumnCount;
+					break;
+				}
+
+				const ANSICHAR* FieldEnd = FindChar(Field, LineEnd, ',');
+				const int32 Slot = Column < PositionColumnCount ? Slots[Column] : INDEX_NONE;
+				if (Slot != INDEX_NONE)
+				{
+					if (!FTrajectoryCsvLoader::ParseFloat(Field, FieldEnd, Values[Slot]))
+					{
+						bValid = false;
+						break;
+					}
+					FoundMask |= 1u << Slot;
+				}
+
+				const int32 Channel = Column < ChannelSlots.Num() ? ChannelSlots[Column] : INDEX_NONE;
+				if (Channel != INDEX_NONE)
+				{
+					if (Types[Channel] == ETrajectoryChannelType::Enum)
+					{
+						const ANSICHAR* NameBegin = Field;
+						const ANSICHAR* NameEnd = FieldEnd;
+						TrimField(NameBegin, NameEnd);
+						if (NameBegin < NameEnd)
+						{
+							LineNames[Channel] = FName(static_cast<int32>(NameEnd - NameBegin), NameBegin);
+						}
+					}
+					else
+					{
+						FTrajectoryCsvLoader::ParseDouble(Field, FieldEnd, LineValues[Channel]);
+					}
+				}
+				Field = FieldEnd + 1;
+			}
+
+			if (bValid && FoundMask == 0xF)
+			{
+				Out.Samples.Add(Values[0], Values[1], Values[2], Values[3]);
+				for (int32 Channel = 0; Channel < ChannelCount; Channel++)
+				{
+					if (Types[Channel] == ETrajectoryChannelType::Enum)
+					{
+						Out.Names[Channel].Add(LineNames[Channel]);
+					}
+					else
+					{
+						Out.Values[Channel].Add(LineValues[Channel]);
+					}
+				}
+			}
+
+			Line = LineEnd + 1;
+		}
+	}
+
+	/**
+	 * Décoder des colonnes de télémétrie d'un fichier déjà chargé, dans l'ordre final des échantillons
+	 * Le fichier est relu en entier (projection mémoire, blocs en parallèle) ; il doit être inchangé depuis le chargement.
+	 */
+	static bool DecodeChannels(const FString& FilePath, const FTrajectoryCsvLayout& Layout, int64 ExpectedSize, const FDateTime& ExpectedTimeStamp,
+		TConstArrayView<int32> ChannelIndices, TArrayView<FTrajectoryChannelColumn* const> OutColumns)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(TrajectoryCsvLoader::DecodeChannels);
+
+		if (IFileManager::Get().FileSize(*FilePath) != ExpectedSize || IFileManager::Get().GetTimeStamp(*FilePath) != ExpectedTimeStamp)
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryCsvLoader] %s changed since it was loaded, reload it to read its channels"), *FilePath);
+			return false;
+		}
+
+		FCsvFileView File;
+		if (!File.Open(FPlatformFileManager::Get().GetPlatformFile(), FilePath))
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryCsvLoader] Cannot read file: %s"), *FilePath);
+			return false;
+		}
+
+		FTrajectoryCsvLayout FileLayout;
+		const int64 HeaderSize = FTrajectoryCsvLoader::ParseHeader(File.Data, File.Size, FileLayout);
+		if (HeaderSize == INDEX_NONE)
+		{
+			return false;
+		}
+
+		// Colonne et type de chaque canal demandé
+		TArray<int32> Slots;
+		MakePositionSlots(Layout, Slots);
+
+		TArray<int32> ChannelSlots;
+		TArray<ETrajectoryChannelType> Types;
+		for (int32 i = 0; i < ChannelIndices.Num(); i++)
+		{
+			const FTrajectoryCsvChannelColumn& Channel = Layout.Channels[ChannelIndices[i]];
+			while (ChannelSlots.Num() <= Channel.Column)
+			{
+				ChannelSlots.Add(INDEX_NONE);
+			}
+			ChannelSlots[Channel.Column] = i;
+			Types.Add(Channel.Desc.Type);
+		}
+
+		// Relire les lignes par blocs parallèles
+		TArray<const ANSICHAR*> Bounds;
+		const int32 ChunkCount = SplitChunks(File.Data + HeaderSize, File.Size - HeaderSize, Bounds);
+
+		TArray<FChannelChunk> Chunks;
+		Chunks.SetNum(ChunkCount);
+		ParallelFor(ChunkCount, [&](int32 Chunk)
+			{
+				Chunks[Chunk].Values.SetNum(Types.Num());
+				Chunks[Chunk].Names.SetNum(Types.Num());
+				ParseChannelChunk(Bounds[Chunk], Bounds[Chunk + 1], Slots, ChannelSlots, Types, Chunks[Chunk]);
+			});
+
+		// Même validation et même tri que le chargement des positions
+		FTrajectorySampleBuffer Samples;
+		for (const FChannelChunk& Chunk : Chunks)
+		{
+			Samples.Append(Chunk.Samples);
+		}
+		TArray<int32> Order;
+		Samples.GetLoadOrder(Order);
+
+		for (int32 i = 0; i < Types.Num(); i++)
+		{
+			FTrajectoryChannelColumn& Column = *OutColumns[i];
+			Column.SetNumUninitialized(Order.Num());
+
+			if (Types[i] == ETrajectoryChannelType::Enum)
+			{
+				TArray<FName> Names;
+				for (const FChannelChunk& Chunk : Chunks)
+				{
+					Names.Append(Chunk.Names[i]);
+				}
+
+				// Valeurs numérotées dans leur ordre d'apparition
+				TMap<FName, int32> NameIndices;
+				for (int32 Sample = 0; Sample < Order.Num(); Sample++)
+				{
+					const FName Name = Names[Order[Sample]];
+					int32 NameIndex = INDEX_NONE;
+					if (!Name.IsNone())
+					{
+						const int32* Found = NameIndices.Find(Name);
+						NameIndex = Found ? *Found : NameIndices.Add(Name, Column.EnumNames.Add(Name));
+					}
+					Column.Ints[Sample] = NameIndex;
+				}
+				continue;
+			}
+
+			TArray<double> Values;
+			for (const FChannelChunk& Chunk : Chunks)
+			{
+				Values.Append(Chunk.Values[i]);
+			}
+
+			for (int32 Sample = 0; Sample < Order.Num(); Sample++)
+			{
+				const double Value = Values[Order[Sample]];
+				switch (Types[i])
+				{
+				case ETrajectoryChannelType::Float:
+					Column.Floats[Sample] = static_cast<float>(Value);
+					break;
+				case ETrajectoryChannelType::Double:
+					Column.Doubles[Sample] = Value;
+					break;
+				default:
+					Column.Ints[Sample] = static_cast<int32>(FMath::Clamp(Value, static_cast<double>(MIN_int32), static_cast<double>(MAX_int32)));
+					break;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+// ========== ANALYSE ==========
+
+bool FTrajectoryCsvLoader::ParseFloat(const ANSICHAR* Begin, const ANSICHAR* End, float& OutValue)
+{
+	double Value;
+	if (!ParseDouble(Begin, End, Value))
+	{
+		return false;
+	}
+
+	OutValue = static_cast<float>(Value);
+	return true;
+}
+
+bool FTrajectoryCsvLoader::ParseDouble(const ANSICHAR* Begin, const ANSICHAR* End, double& OutValue)
+{
+	using namespace TrajectoryCsv;
+
+	// Ignorer les espaces et guillemets autour de la valeur
+	while (Begin < End && IsBlank(*Begin))
+	{
+		++Begin;
+	}
+	while (End > Begin && IsBlank(End[-1]))
+	{
+		--End;
+	}
+
+	const ANSICHAR* P = Begin;
+	bool bNegative = false;
+	if (P < End && (*P == '-' || *P == '+'))
+	{
+		bNegative = (*P == '-');
+		++P;
+	}
+
+	// Mantisse sur 19 chiffres significatifs au plus, le reste ne fait que décaler l'exposant
+	uint64 Mantissa = 0;
+	int32 SignificantDigits = 0;
+	int32 Exponent = 0;
+	bool bHasDigits = false;
+
+	while (P < End && IsDigit(*P))
+	{
+		if (SignificantDigits < 19)
+		{
+			Mantissa = Mantissa * 10 + (*P - '0');
+			SignificantDigits += (Mantissa != 0) ? 1 : 0;
+		}
+		else
+		{
+			Exponent++;
+		}
+		bHasDigits = true;
+		++P;
+	}
+
+	if (P < End && *P == '.')
+	{
+		++P;
+		while (P < End && IsDigit(*P))
+		{
+			if (SignificantDigits < 19)
+			{
+				Mantissa = Mantissa * 10 + (*P - '0');
+				SignificantDigits += (Mantissa != 0) ? 1 : 0;
+				Exponent--;
+			}
+			bHasDigits = true;
+			++P;
+		}
+	}
+
+	if (!bHasDigits)
+	{
+		return false;
+	}
+
+	if (P < End && (*P == 'e' || *P == 'E'))
+	{
+		++P;
+		bool bNegativeExponent = false;
+		if (P < End && (*P == '-' || *P == '+'))
+		{
+			bNegativeExponent = (*P == '-');
+			++P;
+		}
+
+		if (P == End || !IsDigit(*P))
+		{
+			return false;
+		}
+
+		int32 ExplicitExponent = 0;
+		while (P < End && IsDigit(*P))
+		{
+			ExplicitExponent = FMath::Min(ExplicitExponent * 10 + (*P - '0'), 1000);
+			++P;
+		}
+		Exponent += bNegativeExponent ? -ExplicitExponent : ExplicitExponent;
+	}
+
+	// Caractères inattendus en fin de champ
+	if (P != End)
+	{
+		return false;
+	}
+
+	double Value = static_cast<double>(Mantissa);
+	if (Exponent > 0)
+	{
+		Value *= (Exponent <= 22) ? PowersOf10[Exponent] : FMath::Pow(10.0, static_cast<double>(Exponent));
+	}
+	else if (Exponent < 0)
+	{
+		Value /= (Exponent >= -22) ? PowersOf10[-Exponent] : FMath::Pow(10.0, static_cast<double>(-Exponent));
+	}
+
+	OutValue = bNegative ? -Value : Value;
+	return true;
+}
+
+int64 FTrajectoryCsvLoader::ParseHeader(const ANSICHAR* Data, int64 Size, FTrajectoryCsvLayout& OutLayout)
+{
+	using namespace TrajectoryCsv;
+
+	OutLayout = FTrajectoryCsvLayout();
+
+	const ANSICHAR* End = Data + Size;
+	const ANSICHAR* Line = Data;
+
+	// Ignorer le BOM UTF-8 éventuel
+	if (Size >= 3 && static_cast<uint8>(Data[0]) == 0xEF && static_cast<uint8>(Data[1]) == 0xBB && static_cast<uint8>(Data[2]) == 0xBF)
+	{
+		Line += 3;
+	}
+
+	const ANSICHAR* LineEnd = FindChar(Line, End, '\n');
+
+	// Première ligne numérique : fichier sans en-tête (Time,X,Y,Z)
+	{
+		float Unused;
+		const ANSICHAR* FirstFieldEnd = FindChar(Line, LineEnd, ',');
+		if (ParseFloat(Line, FirstFieldEnd, Unused))
+		{
+			return Line - Data;
+		}
+	}
+
+	// Sinon, repérer les colonnes par leur nom
+	FTrajectoryCsvLayout Layout;
+	Layout.TimeColumn = Layout.XColumn = Layout.YColumn = Layout.ZColumn = INDEX_NONE;
+
+	// Colonnes géodésiques : positions si le fichier n'a pas de colonnes X, Y, Z, canaux sinon
+	int32 GeoColumns[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };
+	TArray<FTrajectoryCsvChannelColumn, TInlineAllocator<3>> GeoChannels;
+
+	const ANSICHAR* Field = Line;
+	for (int32 Column = 0; Field <= LineEnd; Column++)
+	{
+		const ANSICHAR* FieldEnd = FindChar(Field, LineEnd, ',');
+
+		const int32 GeoAxis =
+			(FieldEquals(Field, FieldEnd, "Latitude") || FieldEquals(Field, FieldEnd, "Lat")) ? 0 :
+			(FieldEquals(Field, FieldEnd, "Longitude") || FieldEquals(Field, FieldEnd, "Lon") || FieldEquals(Field, FieldEnd, "Lng")) ? 1 :
+			(FieldEquals(Field, FieldEnd, "Altitude") || FieldEquals(Field, FieldEnd, "Alt")) ? 2 : INDEX_NONE;
+
+		if (GeoAxis != INDEX_NONE)
+		{
+			GeoColumns[GeoAxis] = Column;
+			FTrajectoryCsvChannelColumn& Channel = GeoChannels.AddDefaulted_GetRef();
+			Channel.Column = Column;
+			ParseChannelColumn(Field, FieldEnd, Channel.Desc);
+			Channel.Desc.Type = ETrajectoryChannelType::Double;
+		}
+		else if (FieldEquals(Field, FieldEnd, "Time"))
+		{
+			Layout.TimeColumn = Column;
+		}
+		else if (FieldEquals(Field, FieldEnd, "X"))
+		{
+			Layout.XColumn = Column;
+		}
+		else if (FieldEquals(Field, FieldEnd, "Y"))
+		{
+			Layout.YColumn = Column;
+		}
+		else if (FieldEquals(Field, FieldEnd, "Z"))
+		{
+			Layout.ZColumn = Column;
+		}
+		else
+		{
+			// Toute autre colonne nommée est un canal de télémétrie
+			FTrajectoryCsvChannelColumn Channel;
+			Channel.Column = Column;
+			if (ParseChannelColumn(Field, FieldEnd, Channel.Desc))
+			{
+				Layout.Channels.Add(Channel);
+			}
+		}
+
+		Field = FieldEnd + 1;
+	}
+
+	const bool bHasGeoColumns = GeoColumns[0] != INDEX_NONE && GeoColumns[1] != INDEX_NONE && GeoColumns[2] != INDEX_NONE;
+	if (Layout.XColumn == INDEX_NONE && Layout.YColumn == INDEX_NONE && Layout.ZColumn == INDEX_NONE && bHasGeoColumns)
+	{
+		Layout.XColumn = GeoColumns[0];
+		Layout.YColumn = GeoColumns[1];
+		Layout.ZColumn = GeoColumns[2];
+		Layout.bGeodetic = true;
+	}
+	else
+	{
+		Layout.Channels.Append(GeoChannels);
+	}
+
+	if (Layout.TimeColumn == INDEX_NONE || Layout.XColumn == INDEX_NONE || Layout.YColumn == INDEX_NONE || Layout.ZColumn == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	OutLayout = Layout;
+	return FMath::Min<int64>(LineEnd + 1 - Data, Size);
+}
+
+void FTrajectoryCsvLoader::ParseLines(const ANSICHAR* Data, int64 Size, const FTrajectoryCsvLayout& Layout, FTrajectorySampleBuffer& OutSamples, FTrajectoryCsvLoadStats& OutStats)
+{
+	using namespace TrajectoryCsv;
+
+	if (Size <= 0)
+	{
+		return;
+	}
+
+	// Composante associée à chaque colonne (les colonnes de télémétrie ne sont pas lues)
+	TArray<int32> Slots;
+	MakePositionSlots(Layout, Slots);
+
+	// Découper les données en blocs qui commencent toujours en début de ligne
+	TArray<const ANSICHAR*> Bounds;
+	const int32 ChunkCount = SplitChunks(Data, Size, Bounds);
+
+	// Analyser chaque bloc dans son propre buffer (positions géodésiques gardées en double jusqu'à leur conversion)
+	TArray<FTrajectorySampleBuffer> ChunkSamples;
+	TArray<FGeodeticChunk> GeodeticChunks;
+	if (Layout.bGeodetic)
+	{
+		GeodeticChunks.SetNum(ChunkCount);
+	}
+	else
+	{
+		ChunkSamples.SetNum(ChunkCount);
+	}
+	TArray<int32> ChunkSkipped;
+	ChunkSkipped.SetNumZeroed(ChunkCount);
+
+	ParallelFor(ChunkCount, [&](int32 Chunk)
+		{
+			// Estimation grossière : une vingtaine d'octets par ligne
+			const int32 EstimatedCount = static_cast<int32>((Bounds[Chunk + 1] - Bounds[Chunk]) / 20);
+			if (Layout.bGeodetic)
+			{
+				FGeodeticChunk& Geodetic = GeodeticChunks[Chunk];
+				Geodetic.Reserve(EstimatedCount);
+				ChunkSkipped[Chunk] = ParseChunk(Bounds[Chunk], Bounds[Chunk + 1], Slots, [&Geodetic](const double* Values)
+					{
+						Geodetic.Add(Values);
+					});
+			}
+			else
+			{
+				FTrajectorySampleBuffer& Samples = ChunkSamples[Chunk];
+				Samples.Reserve(EstimatedCount);
+				ChunkSkipped[Chunk] = ParseChunk(Bounds[Chunk], Bounds[Chunk + 1], Slots, [&Samples](const double* Values)
+					{
+						Samples.Add(static_cast<float>(Values[0]), static_cast<float>(Values[1]), static_cast<float>(Values[2]), static_cast<float>(Values[3]));
+					});
+			}
+		});
+
+	// Concaténer les blocs dans l'ordre du fichier
+	TArray<int32> Offsets;
+	Offsets.SetNumUninitialized(ChunkCount);
+
+	const int32 BaseCount = OutSamples.Num();
+	int32 TotalCount = 0;
+	for (int32 Chunk = 0; Chunk < ChunkCount; Chunk++)
+	{
+		Offsets[Chunk] = BaseCount + TotalCount;
+		TotalCount += Layout.bGeodetic ? GeodeticChunks[Chunk].Num() : ChunkSamples[Chunk].Num();
+		OutStats.SkippedLines += ChunkSkipped[Chunk];
+	}
+
+	OutSamples.SetNumUninitialized(BaseCount + TotalCount);
+
+	ParallelFor(ChunkCount, [&](int32 Chunk)
+		{
+			const int32 Offset = Offsets[Chunk];
+
+			// Conversion en double vers le repère local, écrite directement dans les colonnes de position
+			if (Layout.bGeodetic)
+			{
+				const FGeodeticChunk& Geodetic = GeodeticChunks[Chunk];
+				FMemory::Memcpy(OutSamples.Times.GetData() + Offset, Geodetic.Times.GetData(), Geodetic.Num() * sizeof(float));
+				Layout.GeoReference.GeoToLocal(Geodetic.Latitudes.GetData(), Geodetic.Longitudes.GetData(), Geodetic.Altitudes.GetData(), Geodetic.Num(),
+					OutSamples.PosX.GetData() + Offset, OutSamples.PosY.GetData() + Offset, OutSamples.PosZ.GetData() + Offset);
+				return;
+			}
+
+			const FTrajectorySampleBuffer& Source = ChunkSamples[Chunk];
+			const int32 Count = Source.Num();
+
+			FMemory::Memcpy(OutSamples.Times.GetData() + Offset, Source.Times.GetData(), Count * sizeof(float));
+			FMemory::Memcpy(OutSamples.PosX.GetData() + Offset, Source.PosX.GetData(), Count * sizeof(float));
+			FMemory::Memcpy(OutSamples.PosY.GetData() + Offset, Source.PosY.GetData(), Count * sizeof(float));
+			FMemory::Memcpy(OutSamples.PosZ.GetData() + Offset, Source.PosZ.GetData(), Count * sizeof(float));
+		});
+
+	OutStats.BytesParsed += Size;
+	OutStats.SampleCount += TotalCount;
+	OutStats.ChunkCount += ChunkCount;
+}
+
+// ========== CHARGEMENT ==========
+
+bool FTrajectoryCsvLoader::LoadFile(const FString& FilePath, FTrajectorySampleBuffer& OutSamples, FTrajectoryCsvLoadStats* OutStats, const FOnBatchParsed& OnBatchParsed,
+	const FTrajectoryGeoReference& GeoReference)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TrajectoryCsvLoader::LoadFile);
+	using namespace TrajectoryCsv;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	OutSamples.Reset();
+	FTrajectoryCsvLoadStats Stats;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*FilePath))
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryCsvLoader] File not found: %s"), *FilePath);
+		return false;
+	}
+
+	// Projeter le fichier en mémoire ; lecture complète si la plateforme ne le permet pas
+	FCsvFileView File;
+	if (!File.Open(PlatformFile, FilePath))
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryCsvLoader] Cannot read file: %s"), *FilePath);
+		return false;
+	}
+
+	const ANSICHAR* Data = File.Data;
+	const int64 Size = File.Size;
+
+	// Lire l'en-tête puis analyser le reste du fichier
+	FTrajectoryCsvLayout Layout;
+	const int64 HeaderSize = ParseHeader(Data, Size, Layout);
+	if (HeaderSize == INDEX_NONE)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryCsvLoader] Invalid header in %s (expected columns Time, X, Y, Z or Time, Latitude, Longitude, Altitude)"), *FilePath);
+		return false;
+	}
+
+	// Latitude, longitude, altitude : convertis vers le repère local pendant l'analyse
+	if (Layout.bGeodetic)
+	{
+		if (!ResolveGeoReference(Data + HeaderSize, Size - HeaderSize, true, GeoReference, Layout))
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryCsvLoader] No valid geodetic sample in %s"), *FilePath);
+			return false;
+		}
+
+		const FTrajectoryGeoPosition& Origin = Layout.GeoReference.GetOrigin();
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryCsvLoader] Geodetic positions in %s converted around %.8f, %.8f, %.2f m%s"),
+			*FilePath, Origin.Latitude, Origin.Longitude, Origin.Altitude, GeoReference.IsValid() ? TEXT("") : TEXT(" (first sample)"));
+	}
+
+	// Analyser le fichier par lots, chacun découpé en blocs parallèles
+	const ANSICHAR* End = Data + Size;
+	const ANSICHAR* BatchBegin = Data + HeaderSize;
+	while (BatchBegin < End)
+	{
+		const ANSICHAR* BatchEnd = End;
+		if (End - BatchBegin > BatchBytes)
+		{
+			const ANSICHAR* NewLine = FindChar(BatchBegin + BatchBytes, End, '\n');
+			BatchEnd = (NewLine < End) ? NewLine + 1 : End;
+		}
+
+		ParseLines(BatchBegin, BatchEnd - BatchBegin, Layout, OutSamples, Stats);
+		BatchBegin = BatchEnd;
+
+		if (OnBatchParsed && !OnBatchParsed(BatchEnd - Data, Size))
+		{
+			UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryCsvLoader] Loading of %s cancelled"), *FilePath);
+			return false;
+		}
+	}
+
+	OutSamples.SortByTime();
+
+	Stats.BytesParsed += HeaderSize;
+	Stats.LoadSeconds = FPlatformTime::Seconds() - StartTime;
+
+	if (Stats.SkippedLines > 0)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryCsvLoader] %d invalid lines skipped in %s"), Stats.SkippedLines, *FilePath);
+	}
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryCsvLoader] Parsed %d samples from %s (%.1f MB in %.3f s, %.1f MB/s, %d chunks)"),
+		Stats.SampleCount, *FilePath, Stats.BytesParsed / (1024.0 * 1024.0), Stats.LoadSeconds, Stats.GetThroughputMBs(), Stats.ChunkCount);
+
+	if (OutStats)
+	{
+		*OutStats = Stats;
+	}
+	return true;
+}
+
+// ========== CANAUX DE TÉLÉMÉTRIE ==========
+
+void FTrajectoryCsvLoader::OpenChannels(const FString& FilePath, int32 SampleCount, FTrajectoryChannelSet& OutChannels)
+{
+	using namespace TrajectoryCsv;
+
+	OutChannels.Reset();
+
+	// Seul le début du fichier est lu : les canaux sont décrits par la ligne d'en-tête
+	TArray<uint8> HeadBytes;
+	int64 FileSize = 0;
+	if (!ReadHead(FilePath, HeadBytes, FileSize))
+	{
+		return;
+	}
+
+	FTrajectoryCsvLayout Layout;
+	const int64 HeaderSize = ParseHeader(reinterpret_cast<const ANSICHAR*>(HeadBytes.GetData()), HeadBytes.Num(), Layout);
+	if (HeaderSize == INDEX_NONE || Layout.Channels.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FTrajectoryChannelDesc> Channels;
+	for (const FTrajectoryCsvChannelColumn& Channel : Layout.Channels)
+	{
+		Channels.Add(Channel.Desc);
+	}
+
+	// Taille et date identifient le fichier chargé : une colonne n'est relue que s'il n'a pas changé
+	const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*FilePath);
+	OutChannels.Init(MoveTemp(Channels), SampleCount,
+		[FilePath, Layout = MoveTemp(Layout), FileSize, TimeStamp](TConstArrayView<int32> ChannelIndices, TArrayView<FTrajectoryChannelColumn* const> OutColumns)
+		{
+			return DecodeChannels(FilePath, Layout, FileSize, TimeStamp, ChannelIndices, OutColumns);
+		},
+		true);
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryCsvLoader] %d telemetry channels available in %s"), OutChannels.Num(), *FilePath);
+}
+
+// ========== POSITIONS GÉODÉSIQUES ==========
+
+bool FTrajectoryCsvLoader::FindGeoOrigin(const FString& FilePath, FTrajectoryGeoPosition& OutOrigin)
+{
+	using namespace TrajectoryCsv;
+
+	TArray<uint8> HeadBytes;
+	int64 FileSize = 0;
+	if (!ReadHead(FilePath, HeadBytes, FileSize))
+	{
+		return false;
+	}
+
+	const ANSICHAR* Data = reinterpret_cast<const ANSICHAR*>(HeadBytes.GetData());
+	FTrajectoryCsvLayout Layout;
+	const int64 HeaderSize = ParseHeader(Data, HeadBytes.Num(), Layout);
+	if (HeaderSize == INDEX_NONE || !Layout.bGeodetic)
+	{
+		return false;
+	}
+
+	const bool bComplete = HeadBytes.Num() == FileSize;
+	if (!ResolveGeoReference(Data + HeaderSize, HeadBytes.Num() - HeaderSize, bComplete, FTrajectoryGeoReference(), Layout))
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryCsvLoader] No valid geodetic sample at the beginning of %s"), *FilePath);
+		return false;
+	}
+
+	OutOrigin = Layout.GeoReference.GetOrigin();
+	return true;
+}
+
+// ========== LECTURE INCRÉMENTALE ==========
+
+FTrajectoryCsvTailReader::FTrajectoryCsvTailReader(const FString& InFilePath, const FTrajectoryGeoReference& InGeoReference)
+	: FilePath(InFilePath)
+	, GeoReference(InGeoReference)
+{
+}
+
+void FTrajectoryCsvTailReader::Restart()
+{
+	// Un journal réécrit garde le repère déjà résolu : les positions restent dans le repère de l'acteur
+	if (Layout.GeoReference.IsValid())
+	{
+		GeoReference = Layout.GeoReference;
+	}
+
+	Offset = 0;
+	bHeaderParsed = false;
+	Layout = FTrajectoryCsvLayout();
+	Stats = FTrajectoryCsvLoadStats();
+	NewSamples.Reset();
+}
+
+void FTrajectoryCsvTailReader::TakeSamples(FTrajectorySampleBuffer& OutSamples)
+{
+	OutSamples = MoveTemp(NewSamples);
+	NewSamples.Reset();
+}
+
+FTrajectoryCsvTailReader::EReadResult FTrajectoryCsvTailReader::ReadNewLines()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TrajectoryCsvTailReader::ReadNewLines);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+	using namespace TrajectoryCsv;
+
+	const int64 FileSize = IFileManager::Get().FileSize(*FilePath);
+	if (FileSize < 0)
+	{
+		return EReadResult::Failed;
+	}
+	if (FileSize < Offset)
+	{
+		return EReadResult::Truncated;
+	}
+	if (FileSize == Offset)
+	{
+		return EReadResult::NoChange;
+	}
+
+	// Lire uniquement la fin ajoutée ; le fichier peut rester ouvert en écriture par l'enregistreur
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath, FILEREAD_AllowWrite));
+	if (!Reader)
+	{
+		return EReadResult::Failed;
+	}
+
+	const int64 NewBytes = FileSize - Offset;
+	ReadBuffer.SetNumUninitialized(NewBytes, EAllowShrinking::No);
+	Reader->Seek(Offset);
+	Reader->Serialize(ReadBuffer.GetData(), NewBytes);
+	if (Reader->IsError())
+	{
+		return EReadResult::Failed;
+	}
+
+	// S'arrêter à la dernière fin de ligne : la ligne suivante est peut-être en cours d'écriture
+	const ANSICHAR* Data = reinterpret_cast<const ANSICHAR*>(ReadBuffer.GetData());
+	int64 CompleteBytes = NewBytes;
+	while (CompleteBytes > 0 && Data[CompleteBytes - 1] != '\n')
+	{
+		CompleteBytes--;
+	}
+	if (CompleteBytes == 0)
+	{
+		return EReadResult::NoChange;
+	}
+
+	// L'en-tête éventuel est lu avec la première ligne complète
+	int64 HeaderSize = 0;
+	if (!bHeaderParsed)
+	{
+		HeaderSize = FTrajectoryCsvLoader::ParseHeader(Data, CompleteBytes, Layout);
+		if (HeaderSize == INDEX_NONE)
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryCsvLoader] Invalid header in %s (expected columns Time, X, Y, Z or Time, Latitude, Longitude, Altitude)"), *FilePath);
+			return EReadResult::Failed;
+		}
+
+		// Sans origine configurée, attendre le premier échantillon complet pour fixer le repère
+		if (Layout.bGeodetic && !ResolveGeoReference(Data + HeaderSize, CompleteBytes - HeaderSize, false, GeoReference, Layout))
+		{
+			return EReadResult::NoChange;
+		}
+		bHeaderParsed = true;
+	}
+
+	const int32 OldCount = NewSamples.Num();
+	ParseLines(Data + HeaderSize, CompleteBytes - HeaderSize, Layout, NewSamples, Stats);
+	Offset += CompleteBytes;
+
+	return NewSamples.Num() > OldCount ? EReadResult::Appended : EReadResult::NoChange;
+}
@@ -0,0 +1,177 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrajectorySampleBuffer.h"
+#include "TrajectoryChannels.h"
+#include "TrajectoryGeodetic.h"
+
+/**
+ * Colonne de télémétrie d'un CSV : toute colonne nommée autre que Time, X, Y, Z
+ * Le type est donné par un suffixe dans l'en-tête ("Battery:float", "Lat:double", "Sats:int", "Mode:enum") ; float par défaut
+ */
+struct FTrajectoryCsvChannelColumn
+{
+	int32 Column = INDEX_NONE;
+	FTrajectoryChannelDesc Desc;
+};
+
+/**
+ * Position des colonnes utiles dans une ligne CSV
+ * Par défaut : Time,X,Y,Z sans en-tête
+ */
+struct FTrajectoryCsvLayout
+{
+	int32 TimeColumn = 0;
+	int32 XColumn = 1;
+	int32 YColumn = 2;
+	int32 ZColumn = 3;
+
+	// Colonnes de télémétrie (fichiers avec en-tête uniquement), jamais lues par le chargement des positions
+	TArray<FTrajectoryCsvChannelColumn> Channels;
+
+	// Colonnes X, Y, Z lues comme latitude, longitude (degrés) et altitude WGS84 (mètres), converties dans GeoReference
+	bool bGeodetic = false;
+	FTrajectoryGeoReference GeoReference;
+
+	int32 GetLastColumn() const
+	{
+		return FMath::Max(FMath::Max(TimeColumn, XColumn), FMath::Max(YColumn, ZColumn));
+	}
+};
+
+/**
+ * Statistiques d'un chargement CSV
+ */
+struct FTrajectoryCsvLoadStats
+{
+	// Taille des données analysées (octets)
+	int64 BytesParsed = 0;
+
+	// Nombre d'échantillons valides
+	int32 SampleCount = 0;
+
+	// Lignes non vides ignorées car invalides
+	int32 SkippedLines = 0;
+
+	// Nombre de blocs analysés en parallèle
+	int32 ChunkCount = 0;
+
+	// Durée totale du chargement (secondes)
+	double LoadSeconds = 0.0;
+
+	// Débit d'analyse en Mo/s
+	double GetThroughputMBs() const
+	{
+		return LoadSeconds > 0.0 ? (BytesParsed / (1024.0 * 1024.0)) / LoadSeconds : 0.0;
+	}
+};
+
+/**
+ * Chargeur CSV d'exécution qui remplit directement un FTrajectorySampleBuffer, sans passer par un UDataTable
+ * Formats acceptés :
+ *   - export DataTable : "---,Time,X,Y,Z" puis "Row0,0,0,0,100"
+ *   - en-tête quelconque contenant les colonnes Time, X, Y, Z
+ *   - en-tête Time, Latitude (Lat), Longitude (Lon, Lng), Altitude (Alt) sans X, Y, Z : positions WGS84 lues en double
+ *     et converties par lots dans un repère local ENU (FTrajectoryGeoReference)
+ *   - sans en-tête : Time,X,Y,Z
+ * Le fichier est projeté en mémoire, découpé en blocs sur des fins de ligne et analysé en parallèle
+ */
+class DATAREPLAY_API FTrajectoryCsvLoader
+{
+public:
+	// Appelé après chaque lot analysé (octets traités, taille du fichier) ; renvoyer false annule le chargement
+	using FOnBatchParsed = TFunction<bool(int64 BytesDone, int64 BytesTotal)>;
+
+	/**
+	 * Charger un fichier CSV complet. Les échantillons sont triés par temps.
+	 * GeoReference : repère des positions géodésiques ; invalide : origine au premier échantillon du fichier
+	 */
+	static bool LoadFile(const FString& FilePath, FTrajectorySampleBuffer& OutSamples, FTrajectoryCsvLoadStats* OutStats = nullptr, const FOnBatchParsed& OnBatchParsed = nullptr,
+		const FTrajectoryGeoReference& GeoReference = FTrajectoryGeoReference());
+
+	/**
+	 * Lire la ligne d'en-tête éventuelle au début des données
+	 * Renvoie le nombre d'octets à ignorer (0 si pas d'en-tête), ou INDEX_NONE si l'en-tête est invalide
+	 */
+	static int64 ParseHeader(const ANSICHAR* Data, int64 Size, FTrajectoryCsvLayout& OutLayout);
+
+	// Analyser des lignes CSV complètes en parallèle et les ajouter à la fin de OutSamples (sans tri)
+	static void ParseLines(const ANSICHAR* Data, int64 Size, const FTrajectoryCsvLayout& Layout, FTrajectorySampleBuffer& OutSamples, FTrajectoryCsvLoadStats& OutStats);
+
+	/**
+	 * Canaux de télémétrie d'un fichier déjà chargé : seul l'en-tête est lu maintenant
+	 * Chaque colonne est relue depuis le fichier au premier accès (projection mémoire, analyse parallèle) ;
+	 * le fichier ne doit pas changer entre-temps. SampleCount : échantillons chargés depuis ce fichier.
+	 */
+	static void OpenChannels(const FString& FilePath, int32 SampleCount, FTrajectoryChannelSet& OutChannels);
+
+	// Premier échantillon d'un fichier en latitude/longitude/altitude (seul le début du fichier est lu) ; false si le fichier n'est pas géodésique
+	static bool FindGeoOrigin(const FString& FilePath, FTrajectoryGeoPosition& OutOrigin);
+
+	// Analyser un nombre décimal ASCII (signe, partie fractionnaire, exposant) entre Begin et End
+	static bool ParseFloat(const ANSICHAR* Begin, const ANSICHAR* End, float& OutValue);
+	static bool ParseDouble(const ANSICHAR* Begin, const ANSICHAR* End, double& OutValue);
+};
+
+/**
+ * Lecture incrémentale d'un fichier CSV qui grandit (journal écrit pendant la mission)
+ * Chaque appel ne lit que les octets ajoutés depuis le précédent, jusqu'à la dernière fin de ligne :
+ * une ligne en cours d'écriture est reprise à l'appel suivant. Un seul appel à la fois (thread quelconque).
+ */
+class DATAREPLAY_API FTrajectoryCsvTailReader
+{
+public:
+	enum class EReadResult : uint8
+	{
+		// Aucune ligne complète ajoutée
+		NoChange,
+
+		// Nouvelles lignes analysées (TakeSamples)
+		Appended,
+
+		// Le fichier a raccourci (remplacé ou tronqué) : Restart puis tout relire
+		Truncated,
+
+		// Fichier introuvable, illisible ou en-tête invalide
+		Failed
+	};
+
+	// InGeoReference : repère d'un journal géodésique ; invalide : origine au premier échantillon
+	explicit FTrajectoryCsvTailReader(const FString& InFilePath, const FTrajectoryGeoReference& InGeoReference = FTrajectoryGeoReference());
+
+	// Lire et analyser les lignes complètes ajoutées depuis le dernier appel
+	EReadResult ReadNewLines();
+
+	// Récupérer les échantillons analysés par ReadNewLines (dans l'ordre du fichier, non triés)
+	void TakeSamples(FTrajectorySampleBuffer& OutSamples);
+
+	// Reprendre au début du fichier (avec le repère géodésique déjà résolu)
+	void Restart();
+
+	const FString& GetFilePath() const { return FilePath; }
+
+	// Octets déjà analysés
+	int64 GetOffset() const { return Offset; }
+
+	// Lignes ignorées depuis l'ouverture
+	int32 GetSkippedLines() const { return Stats.SkippedLines; }
+
+	// Repère des positions d'un journal géodésique, celui demandé ou celui du premier échantillon ;
+	// invalide tant que l'en-tête et ce premier échantillon n'ont pas été lus, ou pour un journal en X, Y, Z
+	const FTrajectoryGeoReference& GetGeoReference() const { return Layout.GeoReference; }
+
+private:
+	FString FilePath;
+	FTrajectoryGeoReference GeoReference;
+	int64 Offset = 0;
+
+	bool bHeaderParsed = false;
+	FTrajectoryCsvLayout Layout;
+	FTrajectoryCsvLoadStats Stats;
+
+	// Octets lus (réutilisés d'un appel à l'autre) et échantillons analysés en attente
+	TArray64<uint8> ReadBuffer;
+	FTrajectorySampleBuffer NewSamples;
+};
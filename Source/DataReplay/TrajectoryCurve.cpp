@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryCurve.h"
+#include "DataReplay.h"
+#include "TrajectorySampleBuffer.h"
+#include "Algo/BinarySearch.h"
+
+namespace TrajectoryCurve
+{
+	// Tangente monotone d'un axe (Fritsch-Butland) à partir des pentes des deux segments voisins
+	static float MonotoneTangent(float SlopeBefore, float SlopeAfter, float DurationBefore, float DurationAfter)
+	{
+		// Extremum local : tangente nulle pour ne pas dépasser les échantillons
+		if (SlopeBefore * SlopeAfter <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		// Moyenne harmonique pondérée par la durée des segments
+		return 3.0f * (DurationBefore + DurationAfter)
+			/ ((2.0f * DurationAfter + DurationBefore) / SlopeBefore + (DurationAfter + 2.0f * DurationBefore) / SlopeAfter);
+	}
+
+	// Coefficients de Hermite d'un axe pour u entre 0 et 1 (tangentes exprimées par seconde)
+	static FVector4f HermiteCoefficients(float P0, float P1, float M0, float M1, float Duration)
+	{
+		const float T0 = M0 * Duration;
+		const float T1 = M1 * Duration;
+		return FVector4f(
+			2.0f * P0 - 2.0f * P1 + T0 + T1,
+			-3.0f * P0 + 3.0f * P1 - 2.0f * T0 - T1,
+			T0,
+			P0);
+	}
+
+	static float EvaluateCoefficients(const FVector4f& C, float U)
+	{
+		return ((C.X * U + C.Y) * U + C.Z) * U + C.W;
+	}
+}
+
+void FTrajectoryCurve::Reset()
+{
+	Segments.Reset();
+	ArcLengths.Reset();
+	ArcStepsPerSegment = 0;
+}
+
+SIZE_T FTrajectoryCurve::GetAllocatedSize() const
+{
+	return Segments.GetAllocatedSize() + ArcLengths.GetAllocatedSize();
+}
+
+void FTrajectoryCurve::Build(const FTrajectorySampleBuffer& Samples, ETrajectoryInterpolationMode InMode)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TrajectoryCurve::Build);
+	Reset();
+	Mode = InMode;
+
+	const int32 Count = Samples.Num();
+	if (Count < 2)
+	{
+		return;
+	}
+
+	const float* Times = Samples.Times.GetData();
+	auto GetPoint = [&Samples](int32 Index)
+		{
+			return FVector3f(Samples.PosX[Index], Samples.PosY[Index], Samples.PosZ[Index]);
+		};
+
+	// Pente (par seconde) de chaque segment ; nulle pour deux échantillons au même temps
+	TArray<FVector3f> Slopes;
+	Slopes.SetNumUninitialized(Count - 1);
+	for (int32 i = 0; i < Count - 1; i++)
+	{
+		const float Duration = Times[i + 1] - Times[i];
+		Slopes[i] = Duration > 0.0f ? (GetPoint(i + 1) - GetPoint(i)) / Duration : FVector3f::ZeroVector;
+	}
+
+	// Tangente à chaque échantillon ; pente du segment unique aux extrémités
+	TArray<FVector3f> Tangents;
+	Tangents.SetNumUninitialized(Count);
+	Tangents[0] = Slopes[0];
+	Tangents[Count - 1] = Slopes[Count - 2];
+
+	for (int32 i = 1; i < Count - 1; i++)
+	{
+		switch (Mode)
+		{
+		case ETrajectoryInterpolationMode::CatmullRom:
+		{
+			const float Duration = Times[i + 1] - Times[i - 1];
+			Tangents[i] = Duration > 0.0f ? (GetPoint(i + 1) - GetPoint(i - 1)) / Duration : FVector3f::ZeroVector;
+			break;
+		}
+
+		case ETrajectoryInterpolationMode::CubicHermite:
+		{
+			const float DurationBefore = Times[i] - Times[i - 1];
+			const float DurationAfter = Times[i + 1] - Times[i];
+			const FVector3f& Before = Slopes[i - 1];
+			const FVector3f& After = Slopes[i];
+			Tangents[i] = FVector3f(
+				TrajectoryCurve::MonotoneTangent(Before.X, After.X, DurationBefore, DurationAfter),
+				TrajectoryCurve::MonotoneTangent(Before.Y, After.Y, DurationBefore, DurationAfter),
+				TrajectoryCurve::MonotoneTangent(Before.Z, After.Z, DurationBefore, DurationAfter));
+			break;
+		}
+
+		case ETrajectoryInterpolationMode::Linear:
+		default:
+			Tangents[i] = FVector3f::ZeroVector;
+			break;
+		}
+	}
+
+	// Coefficients de chaque segment
+	Segments.SetNumUninitialized(Count - 1);
+	for (int32 i = 0; i < Count - 1; i++)
+	{
+		const FVector3f P0 = GetPoint(i);
+		const FVector3f P1 = GetPoint(i + 1);
+		const float Duration = Times[i + 1] - Times[i];
+		FSegment& Segment = Segments[i];
+
+		if (Mode == ETrajectoryInterpolationMode::Linear || Duration <= 0.0f)
+		{
+			// Segment droit (ou segment de durée nulle, jamais évalué au-delà de son début)
+			const FVector3f Delta = Duration > 0.0f ? P1 - P0 : FVector3f::ZeroVector;
+			Segment.X = FVector4f(0.0f, 0.0f, Delta.X, P0.X);
+			Segment.Y = FVector4f(0.0f, 0.0f, Delta.Y, P0.Y);
+			Segment.Z = FVector4f(0.0f, 0.0f, Delta.Z, P0.Z);
+			continue;
+		}
+
+		Segment.X = TrajectoryCurve::HermiteCoefficients(P0.X, P1.X, Tangents[i].X, Tangents[i + 1].X, Duration);
+		Segment.Y = TrajectoryCurve::HermiteCoefficients(P0.Y, P1.Y, Tangents[i].Y, Tangents[i + 1].Y, Duration);
+		Segment.Z = TrajectoryCurve::HermiteCoefficients(P0.Z, P1.Z, Tangents[i].Z, Tangents[i + 1].Z, Duration);
+	}
+}
+
+FVector FTrajectoryCurve::EvaluateSegment(int32 SegmentIndex, float U) const
+{
+	const FSegment& Segment = Segments[SegmentIndex];
+	return FVector(
+		TrajectoryCurve::EvaluateCoefficients(Segment.X, U),
+		TrajectoryCurve::EvaluateCoefficients(Segment.Y, U),
+		TrajectoryCurve::EvaluateCoefficients(Segment.Z, U));
+}
+
+FVector FTrajectoryCurve::EvaluatePosition(const FTrajectorySampleBuffer& Samples, float Time, int32& InOutCursor) const
+{
+	const int32 Count = Samples.Num();
+	if (Count == 0)
+	{
+		return FVector::ZeroVector;
+	}
+
+	// Un seul point, temps hors de la trajectoire ou courbe pas encore construite
+	if (Count == 1 || Time <= Samples.Times[0] || Segments.Num() != Count - 1)
+	{
+		return Samples.EvaluatePosition(Time, InOutCursor);
+	}
+	if (Time >= Samples.Times[Count - 1])
+	{
+		return Samples.GetPosition(Count - 1);
+	}
+
+	const int32 i = Samples.FindSegment(Time, InOutCursor);
+	const float Duration = Samples.Times[i + 1] - Samples.Times[i];
+	const float U = (Duration > 0.0f) ? (Time - Samples.Times[i]) / Duration : 0.0f;
+	return EvaluateSegment(i, U);
+}
+
+// ========== ABSCISSE CURVILIGNE ==========
+
+void FTrajectoryCurve::BuildArcLengthTable(int32 StepsPerSegment)
+{
+	ArcLengths.Reset();
+	ArcStepsPerSegment = FMath::Max(StepsPerSegment, 1);
+	if (Segments.Num() == 0)
+	{
+		return;
+	}
+
+	ArcLengths.SetNumUninitialized(Segments.Num() * ArcStepsPerSegment + 1);
+	ArcLengths[0] = 0.0f;
+
+	// Distance accumulée en double : la courbe peut compter des millions de pas
+	double Length = 0.0;
+	int32 Index = 1;
+	for (int32 SegmentIndex = 0; SegmentIndex < Segments.Num(); SegmentIndex++)
+	{
+		FVector Previous = EvaluateSegment(SegmentIndex, 0.0f);
+		for (int32 Step = 1; Step <= ArcStepsPerSegment; Step++)
+		{
+			const FVector Current = EvaluateSegment(SegmentIndex, static_cast<float>(Step) / ArcStepsPerSegment);
+			Length += FVector::Dist(Previous, Current);
+			ArcLengths[Index++] = static_cast<float>(Length);
+			Previous = Current;
+		}
+	}
+}
+
+FVector FTrajectoryCurve::EvaluateAtDistance(float Distance, int32& InOutCursor) const
+{
+	if (ArcLengths.Num() < 2)
+	{
+		return Segments.Num() > 0 ? EvaluateSegment(0, 0.0f) : FVector::ZeroVector;
+	}
+
+	const int32 LastStep = ArcLengths.Num() - 2;
+	Distance = FMath::Clamp(Distance, 0.0f, ArcLengths.Last());
+
+	// Pas [j, j+1] tel que Length(j) <= Distance < Length(j+1) ; le plus souvent le même qu'à la frame précédente
+	int32 Step = FMath::Clamp(InOutCursor, 0, LastStep);
+	if (!(ArcLengths[Step] <= Distance && Distance < ArcLengths[Step + 1]))
+	{
+		const int32 UpperIndex = Algo::UpperBound(ArcLengths, Distance);
+		Step = FMath::Clamp(UpperIndex - 1, 0, LastStep);
+	}
+	InOutCursor = Step;
+
+	const float StepLength = ArcLengths[Step + 1] - ArcLengths[Step];
+	const float StepAlpha = StepLength > 0.0f ? (Distance - ArcLengths[Step]) / StepLength : 0.0f;
+
+	const int32 SegmentIndex = Step / ArcStepsPerSegment;
+	const float U = (Step % ArcStepsPerSegment + StepAlpha) / ArcStepsPerSegment;
+	return EvaluateSegment(SegmentIndex, U);
+}
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrajectoryCurve.generated.h"
+
+struct FTrajectorySampleBuffer;
+
+/**
+ * Interpolation entre les échantillons d'une trajectoire
+ */
+UENUM(BlueprintType)
+enum class ETrajectoryInterpolationMode : uint8
+{
+	// Segments droits entre deux échantillons
+	Linear UMETA(DisplayName = "Linear"),
+
+	// Courbe passant par les échantillons, tangentes (P(i+1) - P(i-1)) / (T(i+1) - T(i-1))
+	CatmullRom UMETA(DisplayName = "Catmull-Rom"),
+
+	// Hermite cubique à tangentes monotones (Fritsch-Butland) : aucun dépassement entre deux échantillons
+	CubicHermite UMETA(DisplayName = "Cubic Hermite")
+};
+
+/**
+ * Coefficients polynomiaux d'une trajectoire, calculés une seule fois à partir des échantillons
+ * Chaque segment [i, i+1] stocke P(u) = ((A * u + B) * u + C) * u + D pour X, Y et Z, avec u entre 0 et 1 :
+ * l'évaluation se résume à quelques multiplications-additions, sans lire les échantillons voisins.
+ * Une table d'abscisse curviligne optionnelle permet de parcourir la courbe à vitesse constante.
+ */
+struct DATAREPLAY_API FTrajectoryCurve
+{
+	// Calculer les coefficients de chaque segment (la table d'abscisse curviligne est supprimée)
+	void Build(const FTrajectorySampleBuffer& Samples, ETrajectoryInterpolationMode InMode);
+
+	void Reset();
+
+	bool IsEmpty() const { return Segments.Num() == 0; }
+	int32 NumSegments() const { return Segments.Num(); }
+	ETrajectoryInterpolationMode GetMode() const { return Mode; }
+
+	// Mémoire allouée par les coefficients et la table (octets)
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * Position au temps donné, bornée aux extrémités
+	 * Samples doit être le buffer utilisé par Build : il sert à trouver le segment (avec le curseur de lecture)
+	 */
+	FVector EvaluatePosition(const FTrajectorySampleBuffer& Samples, float Time, int32& InOutCursor) const;
+
+	// Position sur un segment, u entre 0 et 1
+	FVector EvaluateSegment(int32 SegmentIndex, float U) const;
+
+	// ========== ABSCISSE CURVILIGNE ==========
+
+	// Mesurer la longueur de la courbe en StepsPerSegment pas par segment
+	void BuildArcLengthTable(int32 StepsPerSegment = 8);
+
+	bool HasArcLengthTable() const { return ArcLengths.Num() > 0; }
+
+	// Longueur totale de la courbe (0 sans table)
+	float GetTotalLength() const { return ArcLengths.Num() > 0 ? ArcLengths.Last() : 0.0f; }
+
+	// Position à une distance donnée depuis le début de la courbe ; InOutCursor est l'index du dernier pas trouvé
+	FVector EvaluateAtDistance(float Distance, int32& InOutCursor) const;
+
+private:
+	// Coefficients A, B, C, D d'un segment pour chaque axe
+	struct FSegment
+	{
+		FVector4f X;
+		FVector4f Y;
+		FVector4f Z;
+	};
+
+	TArray<FSegment> Segments;
+
+	// Distance cumulée à chaque pas (NumSegments * ArcStepsPerSegment + 1 valeurs)
+	TArray<float> ArcLengths;
+	int32 ArcStepsPerSegment = 0;
+
+	ETrajectoryInterpolationMode Mode = ETrajectoryInterpolationMode::Linear;
+};
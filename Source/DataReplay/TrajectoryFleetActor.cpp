@@ -0,0 +1,532 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryFleetActor.h"
+#include "DataReplay.h"
+#include "TrajectoryBatchLoader.h"
+#include "TrajectoryCsvLoader.h"
+#include "TrajectoryReplaySubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Async/ParallelFor.h"
+#include "Misc/Paths.h"
+
+namespace TrajectoryFleet
+{
+	// Nombre de trajectoires évaluées par tâche
+	constexpr int32 BatchSize = 256;
+}
+
+// ========== CONSTRUCTEUR ==========
+
+ATrajectoryFleetActor::ATrajectoryFleetActor()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+	// Les trajectoires sont en coordonnées monde : les instances ne suivent pas l'acteur
+	FleetMeshes = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("FleetMeshes"));
+	FleetMeshes->SetupAttachment(RootComponent);
+	FleetMeshes->SetUsingAbsoluteLocation(true);
+	FleetMeshes->SetUsingAbsoluteRotation(true);
+	FleetMeshes->SetUsingAbsoluteScale(true);
+	FleetMeshes->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	FleetMeshes->SetGenerateOverlapEvents(false);
+	FleetMeshes->SetCanEverAffectNavigation(false);
+	FleetMeshes->SetMobility(EComponentMobility::Movable);
+
+	bIncludeSubdirectories = false;
+	LoadMemoryBudgetMB = 1024.0f;
+	MaxConcurrentLoads = 0;
+	bUseGeoOrigin = false;
+
+	DroneMesh = nullptr;
+	DroneScale = FVector::OneVector;
+
+	PlaybackSpeed = 1.0f;
+	bAutoPlay = false;
+	bIsPlaying = false;
+	bLoopPlayback = false;
+	bReversePlayback = false;
+	CurrentPlaybackTime = 0.0f;
+	TotalDuration = 0.0f;
+	TrajectoryCount = 0;
+	TotalSampleCount = 0;
+	bInstancesDirty = false;
+	bSpatialIndexDirty = false;
+	LoadStartTime = 0.0;
+	bPlayWhenLoaded = false;
+}
+
+// ========== ÉVÉNEMENTS DU CYCLE DE VIE ==========
+
+void ATrajectoryFleetActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ReloadTrajectoryData();
+
+	if (bAutoPlay && (TrajectoryCount > 0 || IsTrajectoryLoading()))
+	{
+		Play();
+	}
+}
+
+void ATrajectoryFleetActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Les tâches lisent les sources configurées : les attendre avant la destruction de l'acteur
+	BatchLoader.Reset();
+	bPlayWhenLoaded = false;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATrajectoryFleetActor::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Tick);
+	Super::Tick(DeltaTime);
+
+	if (BatchLoader.IsValid())
+	{
+		PumpBatchLoad();
+	}
+
+	if (bIsPlaying && TrajectoryCount > 0)
+	{
+		AdvancePlaybackTime(DeltaTime);
+		UpdateFleetInstances();
+	}
+	else if (bInstancesDirty)
+	{
+		UpdateFleetInstances();
+	}
+}
+
+// ========== CHARGEMENT DES DONNÉES ==========
+
+void ATrajectoryFleetActor::ReloadTrajectoryData()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Load);
+
+	// Abandonner un éventuel chargement en cours (attend ses tâches)
+	BatchLoader.Reset();
+	ClearTrajectories();
+
+	// La durée commune n'est connue qu'à la fin du chargement : la lecture en cours reprendra à ce moment
+	if (bIsPlaying)
+	{
+		bIsPlaying = false;
+		bPlayWhenLoaded = true;
+	}
+
+	LoadStartTime = FPlatformTime::Seconds();
+
+	TArray<FTrajectoryLoadRequest> Requests;
+	for (const FTrajectoryFleetSource& Source : Trajectories)
+	{
+		FTrajectoryLoadRequest& Request = Requests.AddDefaulted_GetRef();
+		Request.Source = Source.Source;
+		Request.DataTable = Source.DataTable;
+		Request.Asset = Source.Asset;
+		Request.FilePath = Source.FilePath.FilePath;
+		if (!Request.FilePath.IsEmpty() && FPaths::IsRelative(Request.FilePath))
+		{
+			Request.FilePath = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), Request.FilePath);
+		}
+	}
+
+	if (!MissionDirectory.Path.IsEmpty())
+	{
+		const FString Directory = FPaths::IsRelative(MissionDirectory.Path) ? FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), MissionDirectory.Path) : MissionDirectory.Path;
+		FTrajectoryBatchLoader::FindMissionFiles(Directory, bIncludeSubdirectories, Requests);
+	}
+
+	// Fichiers GPS : un seul repère pour toute la flotte, sinon chaque trajectoire serait centrée sur son propre départ ;
+	// sans Geo Origin, c'est le repère partagé avec les autres acteurs du monde
+	UWorld* World = GetWorld();
+	UTrajectoryReplaySubsystem* GeoSubsystem = (!bUseGeoOrigin && World) ? World->GetSubsystem<UTrajectoryReplaySubsystem>() : nullptr;
+	GeoReference = bUseGeoOrigin ? FTrajectoryGeoReference(GeoOrigin) : FTrajectoryGeoReference();
+	if (GeoSubsystem)
+	{
+		GeoReference = GeoSubsystem->GetSharedGeoReference();
+	}
+	for (FTrajectoryLoadRequest& Request : Requests)
+	{
+		if (Request.Source != ETrajectorySourceType::CsvFile)
+		{
+			continue;
+		}
+
+		FTrajectoryGeoPosition FileOrigin;
+		if (!GeoReference.IsValid() && FTrajectoryCsvLoader::FindGeoOrigin(Request.FilePath, FileOrigin))
+		{
+			GeoReference = FTrajectoryGeoReference(FileOrigin);
+			if (GeoSubsystem)
+			{
+				GeoSubsystem->ShareGeoReference(GeoReference);
+			}
+			UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryFleet] Geodetic origin taken from %s: %.8f, %.8f, %.3f m"),
+				*FPaths::GetCleanFilename(Request.FilePath), FileOrigin.Latitude, FileOrigin.Longitude, FileOrigin.Altitude);
+		}
+		Request.GeoReference = GeoReference;
+	}
+
+	// Lecture, validation et tri de toutes les trajectoires en parallèle, sous le budget mémoire
+	FTrajectoryBatchLoader::FSettings Settings;
+	Settings.MemoryBudgetBytes = static_cast<int64>(LoadMemoryBudgetMB * 1024.0 * 1024.0);
+	Settings.MaxConcurrentLoads = MaxConcurrentLoads;
+	BatchLoader = MakeUnique<FTrajectoryBatchLoader>(Settings);
+	for (const FTrajectoryLoadRequest& Request : Requests)
+	{
+		BatchLoader->AddMission(Request);
+	}
+
+	// Les trajectoires arrivent pendant les Tick suivants ; une flotte vide est terminée tout de suite
+	PumpBatchLoad();
+}
+
+void ATrajectoryFleetActor::PumpBatchLoad()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Load);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+	// Résultats rendus dans l'ordre des sources : les index de trajectoire ne dépendent pas de l'ordre de fin des tâches
+	FTrajectoryBatchResult Result;
+	while (BatchLoader->DequeueResult(Result))
+	{
+		// Échantillons déjà validés et triés dans la tâche de la mission
+		if (!Result.bSucceeded || Result.Samples.IsEmpty())
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryFleet] Trajectory %d (%s) could not be loaded"), Result.MissionIndex, *Result.Stats.Name);
+			continue;
+		}
+		AppendTrajectory(Result.Samples);
+	}
+
+	if (!BatchLoader->IsDone())
+	{
+		return;
+	}
+
+	BatchLoader->LogSummary();
+	BatchLoader.Reset();
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryFleet] %d trajectories loaded (%d samples, %.1f KB) in %.2f ms, Total Duration: %.2f seconds"),
+		TrajectoryCount, TotalSampleCount, SamplePool.GetAllocatedSize() / 1024.0, (FPlatformTime::Seconds() - LoadStartTime) * 1000.0, TotalDuration);
+
+	CurrentPlaybackTime = FMath::Clamp(CurrentPlaybackTime, 0.0f, TotalDuration);
+	UpdateFleetInstances();
+
+	// Index des requêtes de proximité, prêt avant la première requête
+	GetSpatialIndex();
+
+	// Lecture demandée pendant le chargement : la durée commune est maintenant connue
+	if (bPlayWhenLoaded)
+	{
+		bPlayWhenLoaded = false;
+		Play();
+	}
+}
+
+float ATrajectoryFleetActor::GetLoadProgress() const
+{
+	return BatchLoader.IsValid() ? BatchLoader->GetProgress() : 1.0f;
+}
+
+int32 ATrajectoryFleetActor::AddTrajectory(FTrajectorySampleBuffer&& Samples)
+{
+	Samples.RemoveInvalidSamples();
+	Samples.SortByTime();
+	if (Samples.IsEmpty())
+	{
+		return INDEX_NONE;
+	}
+	return AppendTrajectory(Samples);
+}
+
+int32 ATrajectoryFleetActor::AppendTrajectory(const FTrajectorySampleBuffer& Samples)
+{
+	// Ajouter les échantillons à la suite du buffer partagé
+	const int32 FirstSample = SamplePool.Num();
+	SamplePool.Append(Samples);
+
+	TrajectoryFirstSample.Add(FirstSample);
+	TrajectorySampleCount.Add(Samples.Num());
+	SegmentCursors.Add(FirstSample);
+
+	TotalDuration = FMath::Max(TotalDuration, Samples.GetEndTime());
+	TotalSampleCount = SamplePool.Num();
+	bInstancesDirty = true;
+	bSpatialIndexDirty = true;
+	return TrajectoryCount++;
+}
+
+void ATrajectoryFleetActor::ClearTrajectories()
+{
+	SamplePool.Empty();
+	TrajectoryFirstSample.Empty();
+	TrajectorySampleCount.Empty();
+	SegmentCursors.Empty();
+	InstanceTransforms.Empty();
+
+	TrajectoryCount = 0;
+	TotalSampleCount = 0;
+	TotalDuration = 0.0f;
+	bInstancesDirty = true;
+	SpatialIndex.Reset();
+	bSpatialIndexDirty = false;
+}
+
+// ========== REQUÊTES SPATIO-TEMPORELLES ==========
+
+const FTrajectorySpatialIndex& ATrajectoryFleetActor::GetSpatialIndex()
+{
+	if (bSpatialIndexDirty)
+	{
+		SpatialIndex.Reset();
+		for (int32 TrajectoryIndex = 0; TrajectoryIndex < TrajectoryCount; TrajectoryIndex++)
+		{
+			SpatialIndex.AddTrajectory(SamplePool, TrajectoryFirstSample[TrajectoryIndex], TrajectorySampleCount[TrajectoryIndex]);
+		}
+		SpatialIndex.Build();
+		bSpatialIndexDirty = false;
+	}
+	return SpatialIndex;
+}
+
+TArray<FTrajectoryQueryHit> ATrajectoryFleetActor::FindTrajectoriesNearPoint(FVector Center, float Radius, float StartTime, float EndTime)
+{
+	TArray<FTrajectoryQueryHit> Hits;
+	GetSpatialIndex().QuerySphere(Center, Radius, StartTime, EndTime, Hits);
+	return Hits;
+}
+
+TArray<FTrajectoryQueryHit> ATrajectoryFleetActor::FindTrajectoriesInBox(FBox Box, float StartTime, float EndTime)
+{
+	TArray<FTrajectoryQueryHit> Hits;
+	GetSpatialIndex().QueryBox(Box, StartTime, EndTime, Hits);
+	return Hits;
+}
+
+TArray<FTrajectorySeparationEvent> ATrajectoryFleetActor::FindSeparationViolations(float MinSeparation, float StartTime, float EndTime)
+{
+	TArray<FTrajectorySeparationEvent> Events;
+	GetSpatialIndex().QuerySeparation(MinSeparation, StartTime, EndTime, Events);
+	return Events;
+}
+
+// ========== ÉVALUATION ==========
+
+void ATrajectoryFleetActor::FindInterpolationSamples(int32 TrajectoryIndex, float Time, int32& InOutCursor, int32& OutLower, int32& OutUpper, float& OutAlpha) const
+{
+	const int32 First = TrajectoryFirstSample[TrajectoryIndex];
+	const int32 Count = TrajectorySampleCount[TrajectoryIndex];
+	const int32 Last = First + Count - 1;
+	const float* Times = SamplePool.Times.GetData();
+
+	// Temps hors de la trajectoire : position bornée aux extrémités
+	if (Count == 1 || Time <= Times[First])
+	{
+		OutLower = OutUpper = First;
+		OutAlpha = 0.0f;
+		return;
+	}
+	if (Time >= Times[Last])
+	{
+		OutLower = OutUpper = Last;
+		OutAlpha = 0.0f;
+		return;
+	}
+
+	OutLower = SamplePool.FindSegmentInRange(Time, First, Count, InOutCursor);
+	OutUpper = OutLower + 1;
+
+	const float TimeDelta = Times[OutUpper] - Times[OutLower];
+	OutAlpha = (TimeDelta > 0.0f) ? (Time - Times[OutLower]) / TimeDelta : 0.0f;
+}
+
+void ATrajectoryFleetActor::RebuildInstances()
+{
+	if (FleetMeshes->GetStaticMesh() != DroneMesh)
+	{
+		FleetMeshes->SetStaticMesh(DroneMesh);
+	}
+
+	InstanceTransforms.Init(FTransform(FQuat::Identity, FVector::ZeroVector, DroneScale), TrajectoryCount);
+
+	// Un seul ajout groupé ; les positions sont écrites par UpdateFleetInstances
+	FleetMeshes->ClearInstances();
+	FleetMeshes->AddInstances(InstanceTransforms, false, false, false);
+	bInstancesDirty = false;
+}
+
+void ATrajectoryFleetActor::UpdateFleetInstances()
+{
+	if (bInstancesDirty)
+	{
+		RebuildInstances();
+	}
+
+	const int32 Count = TrajectoryCount;
+	if (Count == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Evaluate);
+	const float Time = CurrentPlaybackTime;
+	const int32 BatchCount = FMath::DivideAndRoundUp(Count, TrajectoryFleet::BatchSize);
+
+	ParallelFor(BatchCount, [this, Count, Time](int32 BatchIndex)
+		{
+			const int32 BatchFirst = BatchIndex * TrajectoryFleet::BatchSize;
+			const int32 BatchNum = FMath::Min(TrajectoryFleet::BatchSize, Count - BatchFirst);
+
+			int32 Lower[TrajectoryFleet::BatchSize];
+			int32 Upper[TrajectoryFleet::BatchSize];
+			float Alpha[TrajectoryFleet::BatchSize];
+
+			// Étape 1 : segment de chaque trajectoire, depuis son propre curseur
+			for (int32 i = 0; i < BatchNum; i++)
+			{
+				const int32 TrajectoryIndex = BatchFirst + i;
+				FindInterpolationSamples(TrajectoryIndex, Time, SegmentCursors[TrajectoryIndex], Lower[i], Upper[i], Alpha[i]);
+			}
+
+			// Étape 2 : interpolation sans branchement sur tout le lot, écrite directement dans les transformations
+			const float* PosX = SamplePool.PosX.GetData();
+			const float* PosY = SamplePool.PosY.GetData();
+			const float* PosZ = SamplePool.PosZ.GetData();
+			for (int32 i = 0; i < BatchNum; i++)
+			{
+				const float X = PosX[Lower[i]] + (PosX[Upper[i]] - PosX[Lower[i]]) * Alpha[i];
+				const float Y = PosY[Lower[i]] + (PosY[Upper[i]] - PosY[Lower[i]]) * Alpha[i];
+				const float Z = PosZ[Lower[i]] + (PosZ[Upper[i]] - PosZ[Lower[i]]) * Alpha[i];
+				InstanceTransforms[BatchFirst + i].SetTranslation(FVector(X, Y, Z));
+			}
+		});
+
+	// Envoi groupé au composant (coordonnées locales du composant, identiques au monde)
+	FleetMeshes->BatchUpdateInstancesTransforms(0, InstanceTransforms, false, true, true);
+}
+
+FVector ATrajectoryFleetActor::GetTrajectoryPosition(int32 TrajectoryIndex) const
+{
+	if (!TrajectoryFirstSample.IsValidIndex(TrajectoryIndex))
+	{
+		return FVector::ZeroVector;
+	}
+
+	int32 Cursor = SegmentCursors[TrajectoryIndex];
+	int32 Lower;
+	int32 Upper;
+	float Alpha;
+	FindInterpolationSamples(TrajectoryIndex, CurrentPlaybackTime, Cursor, Lower, Upper, Alpha);
+	return FMath::Lerp(SamplePool.GetPosition(Lower), SamplePool.GetPosition(Upper), Alpha);
+}
+
+// ========== CONTRÔLES DE LECTURE ==========
+
+void ATrajectoryFleetActor::AdvancePlaybackTime(float DeltaTime)
+{
+	// Calculer l'incrément de temps selon la vitesse et la direction
+	float TimeIncrement = DeltaTime * PlaybackSpeed;
+	if (bReversePlayback)
+	{
+		TimeIncrement = -TimeIncrement;
+	}
+
+	CurrentPlaybackTime += TimeIncrement;
+
+	// Gérer les conditions de boucle et de fin
+	if (CurrentPlaybackTime > TotalDuration)
+	{
+		if (bLoopPlayback)
+		{
+			CurrentPlaybackTime = 0.0f;
+		}
+		else
+		{
+			CurrentPlaybackTime = TotalDuration;
+			Pause();
+			UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryFleet] Playback completed"));
+		}
+	}
+	else if (CurrentPlaybackTime < 0.0f)
+	{
+		if (bLoopPlayback)
+		{
+			CurrentPlaybackTime = TotalDuration;
+		}
+		else
+		{
+			CurrentPlaybackTime = 0.0f;
+			Pause();
+			UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryFleet] Reverse playback completed"));
+		}
+	}
+}
+
+void ATrajectoryFleetActor::Play()
+{
+	// Pendant le chargement, la durée commune n'est pas encore connue : démarrer à la fin
+	if (IsTrajectoryLoading())
+	{
+		bPlayWhenLoaded = true;
+		return;
+	}
+
+	if (TrajectoryCount == 0)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryFleet] Cannot play - no trajectory data loaded"));
+		return;
+	}
+
+	bIsPlaying = true;
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryFleet] Playback started at time %.2f"), CurrentPlaybackTime);
+}
+
+void ATrajectoryFleetActor::Pause()
+{
+	bIsPlaying = false;
+	bPlayWhenLoaded = false;
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryFleet] Playback paused at time %.2f"), CurrentPlaybackTime);
+}
+
+void ATrajectoryFleetActor::Stop()
+{
+	bIsPlaying = false;
+	bPlayWhenLoaded = false;
+	CurrentPlaybackTime = 0.0f;
+	UpdateFleetInstances();
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryFleet] Playback stopped and reset"));
+}
+
+void ATrajectoryFleetActor::SeekToTime(float TimeInSeconds)
+{
+	CurrentPlaybackTime = FMath::Clamp(TimeInSeconds, 0.0f, TotalDuration);
+	UpdateFleetInstances();
+	INC_DWORD_STAT(STAT_DataReplay_Seeks);
+
+	UE_LOG(LogDataReplay, Verbose, TEXT("[TrajectoryFleet] Seeked to time %.2f seconds"), CurrentPlaybackTime);
+}
+
+void ATrajectoryFleetActor::SeekToProgress(float Progress)
+{
+	Progress = FMath::Clamp(Progress, 0.0f, 1.0f);
+	CurrentPlaybackTime = Progress * TotalDuration;
+	UpdateFleetInstances();
+	INC_DWORD_STAT(STAT_DataReplay_Seeks);
+
+	UE_LOG(LogDataReplay, Verbose, TEXT("[TrajectoryFleet] Seeked to %.1f%% progress"), Progress * 100.0f);
+}
+
+float ATrajectoryFleetActor::GetPlaybackProgress() const
+{
+	if (TotalDuration > 0.0f)
+	{
+		return CurrentPlaybackTime / TotalDuration;
+	}
+	return 0.0f;
+}
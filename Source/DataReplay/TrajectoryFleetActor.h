@@ -0,0 +1,270 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/DataTable.h"
+#include "TrajectorySampleBuffer.h"
+#include "TrajectoryLoader.h"
+#include "TrajectoryBatchLoader.h"
+#include "TrajectorySpatialIndex.h"
+#include "TrajectoryGeodetic.h"
+#include "TrajectoryFleetActor.generated.h"
+
+class UTrajectoryAsset;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * Source d'une trajectoire de la flotte
+ */
+USTRUCT(BlueprintType)
+struct FTrajectoryFleetSource
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data")
+	ETrajectorySourceType Source = ETrajectorySourceType::CsvFile;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (EditCondition = "Source == ETrajectorySourceType::DataTable"))
+	UDataTable* DataTable = nullptr;
+
+	// Fichier CSV ou paginé, chemin absolu ou relatif au dossier du projet (un fichier paginé est chargé en entier)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (FilePathFilter = "csv", EditCondition = "Source == ETrajectorySourceType::CsvFile || Source == ETrajectorySourceType::PagedFile"))
+	FFilePath FilePath;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (EditCondition = "Source == ETrajectorySourceType::Asset"))
+	UTrajectoryAsset* Asset = nullptr;
+};
+
+/**
+ * Relecture d'une flotte de trajectoires sans un acteur par drone
+ * Toutes les trajectoires partagent un seul buffer d'échantillons ; chaque frame, les positions sont évaluées
+ * par lots en parallèle et écrites directement dans les instances d'un unique composant instancié.
+ * Les trajectoires sont chargées en arrière-plan et ajoutées dans l'ordre des sources au fil des Tick.
+ * Mêmes contrôles de lecture que ATrajectoryReplayActor (Play/Pause/Stop/Seek, boucle, lecture inverse),
+ * sur une ligne de temps commune dont la durée est celle de la plus longue trajectoire.
+ */
+UCLASS()
+class DATAREPLAY_API ATrajectoryFleetActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ATrajectoryFleetActor();
+
+	// ========== CONFIGURATION DE LA FLOTTE ==========
+
+	// Trajectoires chargées au démarrage (une instance par trajectoire)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data")
+	TArray<FTrajectoryFleetSource> Trajectories;
+
+	// Dossier de missions dont tous les fichiers CSV et .dtraj sont chargés après Trajectories (chemin absolu ou relatif au dossier du projet)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data")
+	FDirectoryPath MissionDirectory;
+
+	// Chercher aussi les missions dans les sous-dossiers de MissionDirectory
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data")
+	bool bIncludeSubdirectories;
+
+	// Mémoire maximale des chargements en cours et des résultats pas encore ajoutés à la flotte (Mo)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (ClampMin = "16.0"))
+	float LoadMemoryBudgetMB;
+
+	// Nombre maximal de trajectoires chargées en parallèle ; 0 : une par thread de travail
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (ClampMin = "0"))
+	int32 MaxConcurrentLoads;
+
+	// Fichiers GPS (latitude, longitude, altitude) : convertir autour de GeoOrigin plutôt qu'autour du repère partagé
+	// des acteurs du monde (premier échantillon du premier fichier GPS chargé)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data")
+	bool bUseGeoOrigin;
+
+	// Position WGS84 placée à l'origine du monde, commune à toutes les trajectoires GPS (axes : X = Est, Y = Sud, Z = Haut)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (EditCondition = "bUseGeoOrigin"))
+	FTrajectoryGeoPosition GeoOrigin;
+
+	// ========== VISUALISATION ==========
+
+	// Instances des drones, en coordonnées monde
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Visualization")
+	UInstancedStaticMeshComponent* FleetMeshes;
+
+	// Mesh affiché pour chaque drone
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Visualization")
+	UStaticMesh* DroneMesh;
+
+	// Échelle de chaque instance
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Visualization")
+	FVector DroneScale;
+
+	// ========== CONTRÔLES DE LECTURE ==========
+
+	// Vitesse de lecture (1.0 = temps réel, 2.0 = 2x plus rapide, 0.5 = ralenti)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls", meta = (ClampMin = "0.1", ClampMax = "10.0"))
+	float PlaybackSpeed;
+
+	// Lecture automatique au démarrage du jeu
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls")
+	bool bAutoPlay;
+
+	// État de lecture actuel
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls")
+	bool bIsPlaying;
+
+	// Répéter la lecture en boucle
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls")
+	bool bLoopPlayback;
+
+	// Lecture en sens inverse
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls")
+	bool bReversePlayback;
+
+	// ========== INFORMATIONS D'ÉTAT ==========
+
+	// Temps actuel sur la ligne de temps commune (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	float CurrentPlaybackTime;
+
+	// Durée de la plus longue trajectoire (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	float TotalDuration;
+
+	// Nombre de trajectoires chargées (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	int32 TrajectoryCount;
+
+	// Nombre total d'échantillons dans le buffer partagé (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	int32 TotalSampleCount;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	// ========== FONCTIONS DE CONTRÔLE ==========
+
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void Play();
+
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void Pause();
+
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void Stop();
+
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void SeekToTime(float TimeInSeconds);
+
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void SeekToProgress(float Progress);
+
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	float GetPlaybackProgress() const;
+
+	// Recharger toutes les trajectoires configurées : chargées en parallèle en arrière-plan, ajoutées dans l'ordre des sources
+	// pendant les Tick suivants
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void ReloadTrajectoryData();
+
+	// Vrai tant que des trajectoires du dernier rechargement restent à ajouter
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	bool IsTrajectoryLoading() const { return BatchLoader.IsValid(); }
+
+	// Part des trajectoires du dernier rechargement déjà chargées, entre 0 et 1
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	float GetLoadProgress() const;
+
+	// Position actuelle d'une trajectoire de la flotte
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	FVector GetTrajectoryPosition(int32 TrajectoryIndex) const;
+
+	// Ajouter une trajectoire déjà en mémoire (validée et triée ici) ; renvoie son index ou INDEX_NONE
+	int32 AddTrajectory(FTrajectorySampleBuffer&& Samples);
+
+	// Supprimer toutes les trajectoires et instances
+	void ClearTrajectories();
+
+	// ========== REQUÊTES SPATIO-TEMPORELLES ==========
+	// Index des segments construit au chargement ; EndTime < StartTime : jusqu'à la fin de la trajectoire
+
+	// Trajectoires passées à moins de Radius de Center entre StartTime et EndTime
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Query")
+	TArray<FTrajectoryQueryHit> FindTrajectoriesNearPoint(FVector Center, float Radius, float StartTime = 0.0f, float EndTime = -1.0f);
+
+	// Trajectoires entrées dans Box entre StartTime et EndTime
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Query")
+	TArray<FTrajectoryQueryHit> FindTrajectoriesInBox(FBox Box, float StartTime = 0.0f, float EndTime = -1.0f);
+
+	// Paires de trajectoires passées à moins de MinSeparation l'une de l'autre au même instant
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Query")
+	TArray<FTrajectorySeparationEvent> FindSeparationViolations(float MinSeparation, float StartTime = 0.0f, float EndTime = -1.0f);
+
+	// Index des segments de la flotte (reconstruit s'il a changé depuis le chargement)
+	// Il lit les échantillons de la flotte : ne plus l'utiliser après un ajout ou une suppression de trajectoire
+	const FTrajectorySpatialIndex& GetSpatialIndex();
+
+	// Repère local commun des trajectoires GPS (invalide si la flotte n'en contient aucune)
+	const FTrajectoryGeoReference& GetGeoReference() const { return GeoReference; }
+
+private:
+	// ========== DONNÉES INTERNES ==========
+
+	// Échantillons de toutes les trajectoires, mis bout à bout
+	FTrajectorySampleBuffer SamplePool;
+
+	// Plage de chaque trajectoire dans SamplePool
+	TArray<int32> TrajectoryFirstSample;
+	TArray<int32> TrajectorySampleCount;
+
+	// Curseur de segment de chaque trajectoire (indices absolus dans SamplePool)
+	TArray<int32> SegmentCursors;
+
+	// Transformations écrites par l'évaluation puis envoyées au composant instancié
+	TArray<FTransform> InstanceTransforms;
+
+	// Les instances doivent être recréées (trajectoires ajoutées ou supprimées)
+	bool bInstancesDirty;
+
+	// Index spatio-temporel des trajectoires (mêmes index que la flotte, plages de SamplePool sans copie)
+	FTrajectorySpatialIndex SpatialIndex;
+
+	// Des trajectoires ont été ajoutées ou supprimées depuis la construction de l'index
+	bool bSpatialIndexDirty;
+
+	// Repère des trajectoires GPS, choisi au chargement
+	FTrajectoryGeoReference GeoReference;
+
+	// Chargement en cours des trajectoires configurées, vidé pendant le Tick
+	TUniquePtr<FTrajectoryBatchLoader> BatchLoader;
+
+	// Début du chargement en cours (pour le bilan)
+	double LoadStartTime;
+
+	// La lecture démarrera à la fin du chargement
+	bool bPlayWhenLoaded;
+
+	// ========== FONCTIONS INTERNES ==========
+
+	// Ajouter les trajectoires chargées depuis le dernier Tick, dans l'ordre des sources, puis terminer le chargement
+	void PumpBatchLoad();
+
+	// Ajouter des échantillons déjà validés et triés à la suite du buffer partagé ; renvoie l'index de la trajectoire
+	int32 AppendTrajectory(const FTrajectorySampleBuffer& Samples);
+
+	// Avancer le temps commun (mêmes règles de boucle et de fin que ATrajectoryReplayActor)
+	void AdvancePlaybackTime(float DeltaTime);
+
+	// Évaluer toutes les trajectoires au temps actuel et mettre à jour les instances
+	void UpdateFleetInstances();
+
+	// Recréer une instance par trajectoire
+	void RebuildInstances();
+
+	// Échantillons encadrant le temps donné pour une trajectoire (bornés à ses extrémités)
+	void FindInterpolationSamples(int32 TrajectoryIndex, float Time, int32& InOutCursor, int32& OutLower, int32& OutUpper, float& OutAlpha) const;
+};
@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryGeodetic.h"
+#include "DataReplay.h"
+#include "Async/ParallelFor.h"
+
+namespace TrajectoryGeodetic
+{
+	// Ellipsoïde WGS84
+	static constexpr double SemiMajorAxis = 6378137.0;
+	static constexpr double Flattening = 1.0 / 298.257223563;
+	static constexpr double EccentricitySquared = Flattening * (2.0 - Flattening);
+
+	// Mètres -> centimètres
+	static constexpr double MetersToUnits = 100.0;
+
+	// Échantillons convertis par tâche
+	static constexpr int32 BlockSize = 4096;
+
+	// Itérations de la conversion ECEF -> géodésique (précision sub-millimétrique dès la troisième)
+	static constexpr int32 LatitudeIterations = 4;
+
+	static FORCEINLINE double PrimeVerticalRadius(double SinLatitude)
+	{
+		return SemiMajorAxis / FMath::Sqrt(1.0 - EccentricitySquared * SinLatitude * SinLatitude);
+	}
+}
+
+// ========== CONSTRUCTION ==========
+
+FTrajectoryGeoReference::FTrajectoryGeoReference(const FTrajectoryGeoPosition& InOrigin)
+	: Origin(InOrigin)
+{
+	using namespace TrajectoryGeodetic;
+
+	const double Latitude = FMath::DegreesToRadians(Origin.Latitude);
+	const double Longitude = FMath::DegreesToRadians(Origin.Longitude);
+	SinLatitude = FMath::Sin(Latitude);
+	CosLatitude = FMath::Cos(Latitude);
+	SinLongitude = FMath::Sin(Longitude);
+	CosLongitude = FMath::Cos(Longitude);
+
+	const double Radius = PrimeVerticalRadius(SinLatitude);
+	OriginEcef[0] = (Radius + Origin.Altitude) * CosLatitude * CosLongitude;
+	OriginEcef[1] = (Radius + Origin.Altitude) * CosLatitude * SinLongitude;
+	OriginEcef[2] = (Radius * (1.0 - EccentricitySquared) + Origin.Altitude) * SinLatitude;
+
+	bValid = FMath::IsFinite(OriginEcef[0]) && FMath::IsFinite(OriginEcef[1]) && FMath::IsFinite(OriginEcef[2]);
+}
+
+// ========== CONVERSION ==========
+
+FVector FTrajectoryGeoReference::GeoToLocal(const FTrajectoryGeoPosition& Position) const
+{
+	using namespace TrajectoryGeodetic;
+
+	const double Latitude = FMath::DegreesToRadians(Position.Latitude);
+	const double Longitude = FMath::DegreesToRadians(Position.Longitude);
+	const double SinLat = FMath::Sin(Latitude);
+	const double CosLat = FMath::Cos(Latitude);
+	const double Radius = PrimeVerticalRadius(SinLat);
+
+	const double Dx = (Radius + Position.Altitude) * CosLat * FMath::Cos(Longitude) - OriginEcef[0];
+	const double Dy = (Radius + Position.Altitude) * CosLat * FMath::Sin(Longitude) - OriginEcef[1];
+	const double Dz = (Radius * (1.0 - EccentricitySquared) + Position.Altitude) * SinLat - OriginEcef[2];
+
+	const double East = -SinLongitude * Dx + CosLongitude * Dy;
+	const double North = -SinLatitude * CosLongitude * Dx - SinLatitude * SinLongitude * Dy + CosLatitude * Dz;
+	const double Up = CosLatitude * CosLongitude * Dx + CosLatitude * SinLongitude * Dy + SinLatitude * Dz;
+	return FVector(East, -North, Up) * MetersToUnits;
+}
+
+FTrajectoryGeoPosition FTrajectoryGeoReference::LocalToGeo(const FVector& Location) const
+{
+	using namespace TrajectoryGeodetic;
+
+	const double East = Location.X / MetersToUnits;
+	const double North = -Location.Y / MetersToUnits;
+	const double Up = Location.Z / MetersToUnits;
+
+	// ENU -> ECEF (rotation transposée)
+	const double X = OriginEcef[0] - SinLongitude * East - SinLatitude * CosLongitude * North + CosLatitude * CosLongitude * Up;
+	const double Y = OriginEcef[1] + CosLongitude * East - SinLatitude * SinLongitude * North + CosLatitude * SinLongitude * Up;
+	const double Z = OriginEcef[2] + CosLatitude * North + SinLatitude * Up;
+
+	// ECEF -> géodésique : latitude par itérations, hauteur sans division par cos (stable près des pôles)
+	const double P = FMath::Sqrt(X * X + Y * Y);
+	double Latitude = FMath::Atan2(Z, P * (1.0 - EccentricitySquared));
+	double Height = 0.0;
+	for (int32 Iteration = 0; Iteration < LatitudeIterations; Iteration++)
+	{
+		const double SinLat = FMath::Sin(Latitude);
+		const double Radius = PrimeVerticalRadius(SinLat);
+		Height = P * FMath::Cos(Latitude) + Z * SinLat - SemiMajorAxis * SemiMajorAxis / Radius;
+		Latitude = FMath::Atan2(Z, P * (1.0 - EccentricitySquared * Radius / (Radius + Height)));
+	}
+
+	FTrajectoryGeoPosition Position;
+	Position.Latitude = FMath::RadiansToDegrees(Latitude);
+	Position.Longitude = FMath::RadiansToDegrees(FMath::Atan2(Y, X));
+	Position.Altitude = Height;
+	return Position;
+}
+
+void FTrajectoryGeoReference::GeoToLocal(const double* Latitudes, const double* Longitudes, const double* Altitudes, int32 Count, float* OutX, float* OutY, float* OutZ) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTrajectoryGeoReference::GeoToLocal);
+	using namespace TrajectoryGeodetic;
+
+	const int32 BlockCount = FMath::DivideAndRoundUp(Count, BlockSize);
+	ParallelFor(TEXT("TrajectoryGeodetic.Convert"), BlockCount, 1, [this, Latitudes, Longitudes, Altitudes, Count, OutX, OutY, OutZ](int32 Block)
+		{
+			const int32 First = Block * BlockSize;
+			const int32 BlockSamples = FMath::Min(BlockSize, Count - First);
+			ConvertBlock(Latitudes + First, Longitudes + First, Altitudes + First, BlockSamples, OutX + First, OutY + First, OutZ + First);
+		});
+}
+
+void FTrajectoryGeoReference::ConvertBlock(const double* Latitudes, const double* Longitudes, const double* Altitudes, int32 Count, float* OutX, float* OutY, float* OutZ) const
+{
+	using namespace TrajectoryGeodetic;
+
+	const double* RESTRICT InLat = Latitudes;
+	const double* RESTRICT InLon = Longitudes;
+	const double* RESTRICT InAlt = Altitudes;
+	float* RESTRICT X = OutX;
+	float* RESTRICT Y = OutY;
+	float* RESTRICT Z = OutZ;
+
+	// Constantes du repère copiées localement : la boucle n'a aucune dépendance entre échantillons
+	const double Ox = OriginEcef[0];
+	const double Oy = OriginEcef[1];
+	const double Oz = OriginEcef[2];
+	const double SinLat0 = SinLatitude;
+	const double CosLat0 = CosLatitude;
+	const double SinLon0 = SinLongitude;
+	const double CosLon0 = CosLongitude;
+
+	for (int32 i = 0; i < Count; i++)
+	{
+		const double Latitude = FMath::DegreesToRadians(InLat[i]);
+		const double Longitude = FMath::DegreesToRadians(InLon[i]);
+		const double Altitude = InAlt[i];
+		const double SinLat = FMath::Sin(Latitude);
+		const double CosLat = FMath::Cos(Latitude);
+		const double SinLon = FMath::Sin(Longitude);
+		const double CosLon = FMath::Cos(Longitude);
+		const double Radius = PrimeVerticalRadius(SinLat);
+
+		// Écart ECEF à l'origine : les deux termes valent ~6.4e6 m, la différence garde une précision de l'ordre du nanomètre
+		const double Dx = (Radius + Altitude) * CosLat * CosLon - Ox;
+		const double Dy = (Radius + Altitude) * CosLat * SinLon - Oy;
+		const double Dz = (Radius * (1.0 - EccentricitySquared) + Altitude) * SinLat - Oz;
+
+		const double East = -SinLon0 * Dx + CosLon0 * Dy;
+		const double North = -SinLat0 * CosLon0 * Dx - SinLat0 * SinLon0 * Dy + CosLat0 * Dz;
+		const double Up = CosLat0 * CosLon0 * Dx + CosLat0 * SinLon0 * Dy + SinLat0 * Dz;
+
+		X[i] = static_cast<float>(East * MetersToUnits);
+		Y[i] = static_cast<float>(-North * MetersToUnits);
+		Z[i] = static_cast<float>(Up * MetersToUnits);
+	}
+}
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrajectoryGeodetic.generated.h"
+
+/**
+ * Position géodésique WGS84
+ */
+USTRUCT(BlueprintType)
+struct FTrajectoryGeoPosition
+{
+	GENERATED_BODY()
+
+	// Latitude (degrés, positive au nord)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Geodetic", meta = (ClampMin = "-90.0", ClampMax = "90.0"))
+	double Latitude = 0.0;
+
+	// Longitude (degrés, positive à l'est)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Geodetic", meta = (ClampMin = "-180.0", ClampMax = "180.0"))
+	double Longitude = 0.0;
+
+	// Hauteur au-dessus de l'ellipsoïde (mètres)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Geodetic")
+	double Altitude = 0.0;
+};
+
+/**
+ * Repère local Est-Nord-Haut (ENU) tangent à l'ellipsoïde WGS84 en une origine
+ * Conversion exacte en double : coordonnées ECEF de l'échantillon moins celles de l'origine, puis rotation
+ * dans le plan tangent. L'origine du repère est l'origine du monde ; axes Unreal (main gauche) :
+ * X = Est, Y = Sud, Z = Haut, en centimètres.
+ * Les positions restent petites autour de l'origine : stockées en float dans FTrajectorySampleBuffer,
+ * elles gardent une précision inférieure au centimètre jusqu'à environ 80 km de l'origine.
+ */
+class DATAREPLAY_API FTrajectoryGeoReference
+{
+public:
+	// Repère invalide : aucune origine choisie
+	FTrajectoryGeoReference() = default;
+
+	explicit FTrajectoryGeoReference(const FTrajectoryGeoPosition& InOrigin);
+
+	bool IsValid() const { return bValid; }
+	const FTrajectoryGeoPosition& GetOrigin() const { return Origin; }
+
+	// Position locale (centimètres, axes Unreal) d'un point géodésique
+	FVector GeoToLocal(const FTrajectoryGeoPosition& Position) const;
+
+	// Position géodésique d'un point local (centimètres, axes Unreal)
+	FTrajectoryGeoPosition LocalToGeo(const FVector& Location) const;
+
+	/**
+	 * Convertir Count échantillons (colonnes de degrés et de mètres) en positions locales float (centimètres, axes Unreal)
+	 * Passe par colonnes en double sur des blocs de taille fixe, répartis en parallèle au-delà de quelques milliers d'échantillons.
+	 */
+	void GeoToLocal(const double* Latitudes, const double* Longitudes, const double* Altitudes, int32 Count, float* OutX, float* OutY, float* OutZ) const;
+
+private:
+	FTrajectoryGeoPosition Origin;
+
+	// Origine en ECEF (mètres)
+	double OriginEcef[3] = { 0.0, 0.0, 0.0 };
+
+	// Rotation ECEF -> ENU
+	double SinLatitude = 0.0;
+	double CosLatitude = 1.0;
+	double SinLongitude = 0.0;
+	double CosLongitude = 1.0;
+
+	bool bValid = false;
+
+	// Conversion d'un bloc, sur le thread appelant
+	void ConvertBlock(const double* Latitudes, const double* Longitudes, const double* Altitudes, int32 Count, float* OutX, float* OutY, float* OutZ) const;
+};
@@ -0,0 +1,254 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryKinematics.h"
+#include "DataReplay.h"
+#include "TrajectorySampleBuffer.h"
+#include "Algo/BinarySearch.h"
+
+namespace TrajectoryKinematics
+{
+	/**
+	 * Moyenne glissante centrée de largeur Window (secondes) sur les trois colonnes de position
+	 * La demi-largeur est réduite près des extrémités pour que la fenêtre reste symétrique :
+	 * le premier et le dernier échantillon ne sont pas déplacés vers l'intérieur.
+	 */
+	static void SmoothPositions(const FTrajectorySampleBuffer& Samples, float Window, FTrajectoryKinematics::FAlignedFloatArray* OutColumns)
+	{
+		const int32 Count = Samples.Num();
+		const float* RESTRICT Times = Samples.Times.GetData();
+		const float HalfWindow = Window * 0.5f;
+		const float FirstTime = Times[0];
+		const float LastTime = Times[Count - 1];
+
+		// Bornes de la fenêtre de chaque échantillon, croissantes : deux curseurs suffisent
+		TArray<int32> WindowFirst;
+		TArray<int32> WindowLast;
+		WindowFirst.SetNumUninitialized(Count);
+		WindowLast.SetNumUninitialized(Count);
+
+		int32 Lo = 0;
+		int32 Hi = 0;
+		for (int32 i = 0; i < Count; i++)
+		{
+			const float Time = Times[i];
+			const float HalfWidth = FMath::Min3(HalfWindow, Time - FirstTime, LastTime - Time);
+			while (Times[Lo] < Time - HalfWidth)
+			{
+				Lo++;
+			}
+			Hi = FMath::Max(Hi, i);
+			while (Hi + 1 < Count && Times[Hi + 1] <= Time + HalfWidth)
+			{
+				Hi++;
+			}
+			WindowFirst[i] = Lo;
+			WindowLast[i] = Hi;
+		}
+
+		// Sommes cumulées en double : la moyenne de chaque fenêtre est une différence de deux sommes
+		const FTrajectorySampleBuffer::FAlignedFloatArray* Inputs[3] = { &Samples.PosX, &Samples.PosY, &Samples.PosZ };
+		TArray<double> Prefix;
+		Prefix.SetNumUninitialized(Count + 1);
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			const float* RESTRICT In = Inputs[Axis]->GetData();
+			Prefix[0] = 0.0;
+			for (int32 i = 0; i < Count; i++)
+			{
+				Prefix[i + 1] = Prefix[i] + In[i];
+			}
+
+			OutColumns[Axis].SetNumUninitialized(Count);
+			float* RESTRICT Out = OutColumns[Axis].GetData();
+			for (int32 i = 0; i < Count; i++)
+			{
+				const int32 First = WindowFirst[i];
+				const int32 Last = WindowLast[i];
+				Out[i] = static_cast<float>((Prefix[Last + 1] - Prefix[First]) / (Last - First + 1));
+			}
+		}
+	}
+
+	// Dérivée par différences centrées (décentrées aux extrémités) ; un intervalle de temps nul donne 0
+	static void Differentiate(const float* RESTRICT Times, const float* RESTRICT In, float* RESTRICT Out, int32 Count)
+	{
+		for (int32 i = 0; i < Count; i++)
+		{
+			const int32 Prev = FMath::Max(i - 1, 0);
+			const int32 Next = FMath::Min(i + 1, Count - 1);
+			const float DeltaTime = Times[Next] - Times[Prev];
+			const float InvDeltaTime = DeltaTime > 0.0f ? 1.0f / DeltaTime : 0.0f;
+			Out[i] = (In[Next] - In[Prev]) * InvDeltaTime;
+		}
+	}
+}
+
+// ========== CONSTRUCTION ==========
+
+void FTrajectoryKinematics::Build(const FTrajectorySampleBuffer& Samples, float SmoothingWindow)
+{
+	using namespace TrajectoryKinematics;
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTrajectoryKinematics::Build);
+	LLM_SCOPE_BYTAG(DataReplay_Derived);
+
+	const int32 Count = Samples.Num();
+	if (Count == 0)
+	{
+		Reset();
+		return;
+	}
+
+	// Positions dérivées : lissées si demandé, sinon celles des échantillons
+	FAlignedFloatArray Smoothed[3];
+	const float* PosX = Samples.PosX.GetData();
+	const float* PosY = Samples.PosY.GetData();
+	const float* PosZ = Samples.PosZ.GetData();
+	if (SmoothingWindow > 0.0f && Count > 2)
+	{
+		SmoothPositions(Samples, SmoothingWindow, Smoothed);
+		PosX = Smoothed[0].GetData();
+		PosY = Smoothed[1].GetData();
+		PosZ = Smoothed[2].GetData();
+	}
+
+	for (FAlignedFloatArray* Column : { &VelX, &VelY, &VelZ, &Speed, &AccX, &AccY, &AccZ, &Heading, &Pitch, &Distance })
+	{
+		Column->SetNumUninitialized(Count);
+	}
+
+	// Vitesse puis accélération, colonne par colonne
+	const float* Times = Samples.Times.GetData();
+	Differentiate(Times, PosX, VelX.GetData(), Count);
+	Differentiate(Times, PosY, VelY.GetData(), Count);
+	Differentiate(Times, PosZ, VelZ.GetData(), Count);
+	Differentiate(Times, VelX.GetData(), AccX.GetData(), Count);
+	Differentiate(Times, VelY.GetData(), AccY.GetData(), Count);
+	Differentiate(Times, VelZ.GetData(), AccZ.GetData(), Count);
+
+	{
+		const float* RESTRICT Vx = VelX.GetData();
+		const float* RESTRICT Vy = VelY.GetData();
+		const float* RESTRICT Vz = VelZ.GetData();
+		float* RESTRICT OutSpeed = Speed.GetData();
+		for (int32 i = 0; i < Count; i++)
+		{
+			OutSpeed[i] = FMath::Sqrt(Vx[i] * Vx[i] + Vy[i] * Vy[i] + Vz[i] * Vz[i]);
+		}
+	}
+
+	// Orientation du premier échantillon en mouvement, conservée avant lui et pendant les arrêts
+	float CurrentHeading = 0.0f;
+	float CurrentPitch = 0.0f;
+	for (int32 i = 0; i < Count; i++)
+	{
+		if (Speed[i] >= MinOrientationSpeed)
+		{
+			CurrentHeading = FMath::RadiansToDegrees(FMath::Atan2(VelY[i], VelX[i]));
+			break;
+		}
+	}
+
+	// Cap déroulé, tangage et distance cumulée : dépendent de l'échantillon précédent
+	Distance[0] = 0.0f;
+	for (int32 i = 0; i < Count; i++)
+	{
+		if (Speed[i] >= MinOrientationSpeed)
+		{
+			const float RawHeading = FMath::RadiansToDegrees(FMath::Atan2(VelY[i], VelX[i]));
+			CurrentHeading += FMath::UnwindDegrees(RawHeading - CurrentHeading);
+			CurrentPitch = FMath::RadiansToDegrees(FMath::Atan2(VelZ[i], FMath::Sqrt(VelX[i] * VelX[i] + VelY[i] * VelY[i])));
+		}
+		Heading[i] = CurrentHeading;
+		Pitch[i] = CurrentPitch;
+
+		if (i > 0)
+		{
+			const FVector Step(PosX[i] - PosX[i - 1], PosY[i] - PosY[i - 1], PosZ[i] - PosZ[i - 1]);
+			Distance[i] = Distance[i - 1] + static_cast<float>(Step.Size());
+		}
+	}
+}
+
+void FTrajectoryKinematics::Reset()
+{
+	for (FAlignedFloatArray* Column : { &VelX, &VelY, &VelZ, &Speed, &AccX, &AccY, &AccZ, &Heading, &Pitch, &Distance })
+	{
+		Column->Empty();
+	}
+}
+
+SIZE_T FTrajectoryKinematics::GetAllocatedSize() const
+{
+	SIZE_T Size = 0;
+	for (const FAlignedFloatArray* Column : { &VelX, &VelY, &VelZ, &Speed, &AccX, &AccY, &AccZ, &Heading, &Pitch, &Distance })
+	{
+		Size += Column->GetAllocatedSize();
+	}
+	return Size;
+}
+
+// ========== ÉVALUATION ==========
+
+FTrajectoryKinematicState FTrajectoryKinematics::Evaluate(const FTrajectorySampleBuffer& Samples, float Time, int32& InOutCursor) const
+{
+	FTrajectoryKinematicState State;
+	const int32 Count = FMath::Min(Num(), Samples.Num());
+	if (Count == 0)
+	{
+		return State;
+	}
+
+	// Échantillons encadrant le temps (bornés aux extrémités)
+	int32 Lower = 0;
+	int32 Upper = 0;
+	float Alpha = 0.0f;
+	if (Count > 1 && Time >= Samples.Times[Count - 1])
+	{
+		Lower = Upper = Count - 1;
+	}
+	else if (Count > 1 && Time > Samples.Times[0])
+	{
+		Lower = Samples.FindSegmentInRange(Time, 0, Count, InOutCursor);
+		Upper = Lower + 1;
+		const float DeltaTime = Samples.Times[Upper] - Samples.Times[Lower];
+		Alpha = DeltaTime > 0.0f ? (Time - Samples.Times[Lower]) / DeltaTime : 0.0f;
+	}
+
+	auto Lerp = [Lower, Upper, Alpha](const FAlignedFloatArray& Column)
+		{
+			return FMath::Lerp(Column[Lower], Column[Upper], Alpha);
+		};
+
+	State.Velocity = FVector(Lerp(VelX), Lerp(VelY), Lerp(VelZ));
+	State.Speed = Lerp(Speed);
+	State.Acceleration = FVector(Lerp(AccX), Lerp(AccY), Lerp(AccZ));
+	State.Heading = FRotator::NormalizeAxis(Lerp(Heading));
+	State.Pitch = Lerp(Pitch);
+	State.Distance = Lerp(Distance);
+	return State;
+}
+
+float FTrajectoryKinematics::FindTimeAtDistance(const FTrajectorySampleBuffer& Samples, float InDistance) const
+{
+	const int32 Count = FMath::Min(Num(), Samples.Num());
+	if (Count == 0)
+	{
+		return 0.0f;
+	}
+
+	// Premier échantillon au-delà de la distance (la distance cumulée est croissante)
+	const int32 Upper = Algo::UpperBound(TConstArrayView<float>(Distance.GetData(), Count), InDistance);
+	if (Upper <= 0)
+	{
+		return Samples.Times[0];
+	}
+	if (Upper >= Count)
+	{
+		return Samples.Times[Count - 1];
+	}
+
+	const int32 Lower = Upper - 1;
+	const float Span = Distance[Upper] - Distance[Lower];
+	const float Alpha = Span > 0.0f ? (InDistance - Distance[Lower]) / Span : 0.0f;
+	return FMath::Lerp(Samples.Times[Lower], Samples.Times[Upper], Alpha);
+}
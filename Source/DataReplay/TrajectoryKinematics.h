@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrajectoryKinematics.generated.h"
+
+struct FTrajectorySampleBuffer;
+
+/**
+ * Grandeurs cinématiques d'une trajectoire à un instant donné
+ */
+USTRUCT(BlueprintType)
+struct FTrajectoryKinematicState
+{
+	GENERATED_BODY()
+
+	// Vitesse (unités du monde par seconde)
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Kinematics")
+	FVector Velocity = FVector::ZeroVector;
+
+	// Norme de la vitesse (unités du monde par seconde)
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Kinematics")
+	float Speed = 0.0f;
+
+	// Accélération (unités du monde par seconde²)
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Kinematics")
+	FVector Acceleration = FVector::ZeroVector;
+
+	// Cap (lacet autour de Z, degrés) et tangage (degrés, positif en montée) dans le sens du déplacement
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Kinematics")
+	float Heading = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Kinematics")
+	float Pitch = 0.0f;
+
+	// Distance parcourue depuis le premier échantillon (unités du monde)
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Kinematics")
+	float Distance = 0.0f;
+
+	FRotator GetRotation() const { return FRotator(Pitch, Heading, 0.0f); }
+};
+
+/**
+ * Canaux cinématiques précalculés pour chaque échantillon d'une trajectoire
+ * Vitesse et accélération par différences centrées (sur les positions lissées si une fenêtre est donnée),
+ * cap et tangage dans le sens du déplacement, distance cumulée. Calculés une fois au chargement,
+ * colonne par colonne ; la lecture ne fait ensuite qu'une interpolation linéaire entre deux échantillons.
+ */
+struct DATAREPLAY_API FTrajectoryKinematics
+{
+	// Tableau de floats aligné sur une ligne de cache
+	using FAlignedFloatArray = TArray<float, TAlignedHeapAllocator<64>>;
+
+	// En dessous de cette vitesse (unités par seconde), le cap et le tangage précédents sont conservés
+	static constexpr float MinOrientationSpeed = 1.0f;
+
+	/**
+	 * Calculer les canaux des échantillons triés
+	 * SmoothingWindow : largeur (secondes) de la moyenne glissante centrée appliquée aux positions avant dérivation ; 0 : aucune
+	 */
+	void Build(const FTrajectorySampleBuffer& Samples, float SmoothingWindow);
+
+	void Reset();
+
+	bool IsEmpty() const { return Speed.Num() == 0; }
+	int32 Num() const { return Speed.Num(); }
+
+	// Longueur totale de la trajectoire (positions lissées)
+	float GetTotalDistance() const { return Distance.Num() > 0 ? Distance.Last() : 0.0f; }
+
+	// Mémoire allouée par les canaux (octets)
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * Canaux interpolés au temps donné (bornés aux extrémités)
+	 * Samples doit être le buffer passé à Build ; seuls ses Num() premiers échantillons sont utilisés.
+	 */
+	FTrajectoryKinematicState Evaluate(const FTrajectorySampleBuffer& Samples, float Time, int32& InOutCursor) const;
+
+	// Temps auquel la distance cumulée atteint Distance (parcours à vitesse constante)
+	float FindTimeAtDistance(const FTrajectorySampleBuffer& Samples, float InDistance) const;
+
+private:
+	FAlignedFloatArray VelX;
+	FAlignedFloatArray VelY;
+	FAlignedFloatArray VelZ;
+	FAlignedFloatArray Speed;
+	FAlignedFloatArray AccX;
+	FAlignedFloatArray AccY;
+	FAlignedFloatArray AccZ;
+
+	// Cap déroulé (sans saut de 360°) pour pouvoir l'interpoler linéairement
+	FAlignedFloatArray Heading;
+	FAlignedFloatArray Pitch;
+	FAlignedFloatArray Distance;
+};
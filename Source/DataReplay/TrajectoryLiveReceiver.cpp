@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryLiveReceiver.h"
+#include "DataReplay.h"
+#include "TrajectoryCsvLoader.h"
+#include "Common/UdpSocketBuilder.h"
+#include "HAL/RunnableThread.h"
+#include "Interfaces/IPv4/IPv4Address.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+namespace TrajectoryLive
+{
+	// Taille maximale d'un datagramme UDP
+	static constexpr int32 MaxDatagramBytes = 65536;
+
+	// Attente maximale d'un datagramme avant de revérifier la demande d'arrêt
+	static constexpr double WaitMilliseconds = 100.0;
+
+	static bool IsBlankLine(const ANSICHAR* Begin, const ANSICHAR* End)
+	{
+		for (const ANSICHAR* P = Begin; P < End; ++P)
+		{
+			if (*P != ' ' && *P != '\t' && *P != '\r')
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+// ========== CYCLE DE VIE ==========
+
+TSharedPtr<FTrajectoryLiveReceiver> FTrajectoryLiveReceiver::Start(int32 Port, int32 RingCapacity)
+{
+	// Uniquement l'adresse de bouclage : un émetteur local relaie le véhicule
+	FSocket* Socket = FUdpSocketBuilder(TEXT("TrajectoryLiveReceiver"))
+		.AsNonBlocking()
+		.AsReusable()
+		.BoundToAddress(FIPv4Address::InternalLoopback)
+		.BoundToPort(Port)
+		.WithReceiveBufferSize(2 * 1024 * 1024)
+		.Build();
+
+	if (Socket == nullptr)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryLive] Cannot open UDP port %d"), Port);
+		return nullptr;
+	}
+
+	TSharedPtr<FTrajectoryLiveReceiver> Receiver = MakeShareable(new FTrajectoryLiveReceiver(Socket, Port, RingCapacity));
+	Receiver->Thread = FRunnableThread::Create(Receiver.Get(), TEXT("TrajectoryLiveReceiver"), 0, TPri_AboveNormal);
+	if (Receiver->Thread == nullptr)
+	{
+		return nullptr;
+	}
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryLive] Listening on 127.0.0.1:%d (queue of %d samples)"), Port, Receiver->Ring.GetCapacity());
+	return Receiver;
+}
+
+FTrajectoryLiveReceiver::FTrajectoryLiveReceiver(FSocket* InSocket, int32 InPort, int32 RingCapacity)
+	: Socket(InSocket)
+	, Port(InPort)
+	, Ring(RingCapacity)
+{
+}
+
+FTrajectoryLiveReceiver::~FTrajectoryLiveReceiver()
+{
+	// Arrêter le thread avant de fermer le socket qu'il lit
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+}
+
+// ========== RÉCEPTION (THREAD DÉDIÉ) ==========
+
+uint32 FTrajectoryLiveReceiver::Run()
+{
+	// Tampon réutilisé pour tous les datagrammes
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(TrajectoryLive::MaxDatagramBytes);
+
+	while (!bStopping.load(std::memory_order_relaxed))
+	{
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(TrajectoryLive::WaitMilliseconds)))
+		{
+			continue;
+		}
+
+		// Vider tout ce qui est arrivé
+		int32 BytesRead = 0;
+		while (Socket->Recv(Buffer.GetData(), Buffer.Num(), BytesRead) && BytesRead > 0)
+		{
+			ParseDatagram(reinterpret_cast<const ANSICHAR*>(Buffer.GetData()), BytesRead);
+		}
+	}
+
+	return 0;
+}
+
+void FTrajectoryLiveReceiver::Stop()
+{
+	bStopping.store(true, std::memory_order_relaxed);
+}
+
+void FTrajectoryLiveReceiver::ParseDatagram(const ANSICHAR* Data, int32 Size)
+{
+	using namespace TrajectoryLive;
+
+	const ANSICHAR* End = Data + Size;
+	const ANSICHAR* Line = Data;
+
+	while (Line < End)
+	{
+		const ANSICHAR* LineEnd = Line;
+		while (LineEnd < End && *LineEnd != '\n')
+		{
+			LineEnd++;
+		}
+
+		// Quatre champs séparés par des virgules ; les lignes vides sont ignorées
+		float Values[4];
+		int32 FieldCount = 0;
+		bool bValid = true;
+		const ANSICHAR* Field = Line;
+		while (FieldCount < 4 && Field <= LineEnd)
+		{
+			const ANSICHAR* FieldEnd = Field;
+			while (FieldEnd < LineEnd && *FieldEnd != ',')
+			{
+				FieldEnd++;
+			}
+
+			if (!FTrajectoryCsvLoader::ParseFloat(Field, FieldEnd, Values[FieldCount]) || !FMath::IsFinite(Values[FieldCount]))
+			{
+				bValid = false;
+				break;
+			}
+			FieldCount++;
+			Field = FieldEnd + 1;
+		}
+
+		if (bValid && FieldCount == 4)
+		{
+			FTrajectoryLiveSample Sample;
+			Sample.Time = Values[0];
+			Sample.X = Values[1];
+			Sample.Y = Values[2];
+			Sample.Z = Values[3];
+
+			if (Ring.Push(Sample))
+			{
+				ReceivedCount.fetch_add(1, std::memory_order_relaxed);
+			}
+			else
+			{
+				OverflowCount.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		else if (!IsBlankLine(Line, LineEnd))
+		{
+			MalformedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Line = LineEnd + 1;
+	}
+}
@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include <atomic>
+
+class FSocket;
+class FRunnableThread;
+
+/**
+ * Échantillon reçu en direct
+ */
+struct FTrajectoryLiveSample
+{
+	float Time = 0.0f;
+	float X = 0.0f;
+	float Y = 0.0f;
+	float Z = 0.0f;
+};
+
+/**
+ * File circulaire sans verrou entre un seul producteur et un seul consommateur
+ * Capacité fixe (puissance de deux) allouée à la construction : aucune allocation ensuite.
+ * Quand elle est pleine, les nouveaux échantillons sont refusés (le consommateur a trop de retard).
+ */
+class FTrajectorySampleRing
+{
+public:
+	explicit FTrajectorySampleRing(int32 InCapacity)
+	{
+		Capacity = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(InCapacity, 2)));
+		Slots.SetNumUninitialized(Capacity);
+	}
+
+	int32 GetCapacity() const { return static_cast<int32>(Capacity); }
+
+	// ========== PRODUCTEUR ==========
+
+	bool Push(const FTrajectoryLiveSample& Sample)
+	{
+		const uint32 Write = WriteIndex.load(std::memory_order_relaxed);
+		if (Write - ReadIndex.load(std::memory_order_acquire) >= Capacity)
+		{
+			return false;
+		}
+
+		Slots[Write & (Capacity - 1)] = Sample;
+		WriteIndex.store(Write + 1, std::memory_order_release);
+		return true;
+	}
+
+	// ========== CONSOMMATEUR ==========
+
+	// Nombre d'échantillons en attente
+	int32 Num() const
+	{
+		return static_cast<int32>(WriteIndex.load(std::memory_order_acquire) - ReadIndex.load(std::memory_order_relaxed));
+	}
+
+	// Passer au plus MaxCount échantillons en attente à Consume, dans l'ordre, puis libérer leurs places en une fois
+	template<typename FunctorType>
+	int32 ConsumeAll(int32 MaxCount, FunctorType&& Consume)
+	{
+		const uint32 Read = ReadIndex.load(std::memory_order_relaxed);
+		const uint32 Available = WriteIndex.load(std::memory_order_acquire) - Read;
+		const uint32 Count = FMath::Min(Available, static_cast<uint32>(FMath::Max(MaxCount, 0)));
+
+		for (uint32 i = 0; i < Count; i++)
+		{
+			Consume(Slots[(Read + i) & (Capacity - 1)]);
+		}
+
+		ReadIndex.store(Read + Count, std::memory_order_release);
+		return static_cast<int32>(Count);
+	}
+
+private:
+	TArray<FTrajectoryLiveSample> Slots;
+	uint32 Capacity = 0;
+
+	// Indices libres de croître (arithmétique modulo 2^32), chacun sur sa propre ligne de cache
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> WriteIndex { 0 };
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> ReadIndex { 0 };
+};
+
+/**
+ * Réception de télémétrie en direct : un thread écoute un port UDP local et pousse les échantillons
+ * dans une FTrajectorySampleRing vidée par le thread de jeu.
+ * Chaque datagramme contient une ou plusieurs lignes "Time,X,Y,Z" (temps en secondes depuis le début de la mission).
+ */
+class DATAREPLAY_API FTrajectoryLiveReceiver : public FRunnable
+{
+public:
+	// Ouvrir le port sur l'adresse de bouclage et démarrer le thread de réception ; nullptr si le port est indisponible
+	static TSharedPtr<FTrajectoryLiveReceiver> Start(int32 Port, int32 RingCapacity);
+
+	virtual ~FTrajectoryLiveReceiver() override;
+
+	// File des échantillons reçus (consommateur : thread de jeu)
+	FTrajectorySampleRing& GetRing() { return Ring; }
+
+	int32 GetPort() const { return Port; }
+
+	// Échantillons poussés dans la file
+	int32 GetReceivedCount() const { return ReceivedCount.load(std::memory_order_relaxed); }
+
+	// Échantillons perdus : file pleine ou ligne invalide
+	int32 GetOverflowCount() const { return OverflowCount.load(std::memory_order_relaxed); }
+	int32 GetMalformedCount() const { return MalformedCount.load(std::memory_order_relaxed); }
+
+	// ========== FRUNNABLE ==========
+
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	FTrajectoryLiveReceiver(FSocket* InSocket, int32 InPort, int32 RingCapacity);
+
+	// Analyser les lignes d'un datagramme et les pousser dans la file
+	void ParseDatagram(const ANSICHAR* Data, int32 Size);
+
+	FSocket* Socket = nullptr;
+	FRunnableThread* Thread = nullptr;
+	int32 Port = 0;
+
+	FTrajectorySampleRing Ring;
+
+	std::atomic<bool> bStopping { false };
+	std::atomic<int32> ReceivedCount { 0 };
+	std::atomic<int32> OverflowCount { 0 };
+	std::atomic<int32> MalformedCount { 0 };
+};
@@ -0,0 +1,234 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryLoader.h"
+#include "DataReplay.h"
+#include "TrajectoryCsvLoader.h"
+#include "TrajectoryAsset.h"
+#include "TrajectoryPagedSource.h"
+#include "TrajectoryChannels.h"
+#include "Engine/DataTable.h"
+#include "Tasks/Task.h"
+
+// ========== CHARGEMENT ==========
+
+bool FTrajectoryLoader::LoadSamples(const FTrajectoryLoadRequest& Request, FTrajectorySampleBuffer& OutSamples, FTrajectoryLoader* ProgressTarget)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Load);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+	OutSamples.Reset();
+
+	// Lire la source
+	bool bLoaded = false;
+	switch (Request.Source)
+	{
+	case ETrajectorySourceType::CsvFile:
+		bLoaded = LoadFromCsvFile(Request.FilePath, Request.GeoReference, OutSamples, ProgressTarget);
+		break;
+
+	case ETrajectorySourceType::Asset:
+		bLoaded = LoadFromAsset(Request.Asset, OutSamples);
+		break;
+
+	case ETrajectorySourceType::PagedFile:
+		bLoaded = LoadFromPagedFile(Request.FilePath, OutSamples);
+		break;
+
+	case ETrajectorySourceType::LiveUdp:
+		// Les échantillons en direct arrivent dans ATrajectoryReplayActor, il n'y a rien à charger
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryLoader] Live sources cannot be loaded, they stream into a replay actor"));
+		break;
+
+	case ETrajectorySourceType::DataTable:
+	default:
+		bLoaded = LoadFromDataTable(Request.DataTable, OutSamples);
+		break;
+	}
+
+	if (!bLoaded || (ProgressTarget && ProgressTarget->IsCancelled()))
+	{
+		OutSamples.Reset();
+		return false;
+	}
+
+	// Publier ce qui n'a pas encore été publié (sources lues d'un seul bloc)
+	if (ProgressTarget)
+	{
+		ProgressTarget->PublishNewSamples(OutSamples, 1.0f);
+	}
+
+	// Valider : les échantillons non finis rendraient la recherche par temps incohérente
+	const int32 RemovedCount = OutSamples.RemoveInvalidSamples();
+	if (RemovedCount > 0)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryLoader] %d samples with non-finite values removed"), RemovedCount);
+	}
+
+	// Trier les points par temps (croissant)
+	OutSamples.SortByTime();
+
+	if (ProgressTarget)
+	{
+		ProgressTarget->bStreamComplete = ProgressTarget->bStreamSorted && RemovedCount == 0 && ProgressTarget->PublishedCount == OutSamples.Num();
+	}
+	return true;
+}
+
+bool FTrajectoryLoader::LoadFromDataTable(const UDataTable* DataTable, FTrajectorySampleBuffer& OutSamples)
+{
+	if (!OutSamples.AppendFromDataTable(DataTable))
+	{
+		return false;
+	}
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryLoader] Loaded %d waypoints from DataTable %s"), OutSamples.Num(), *DataTable->GetName());
+	return true;
+}
+
+bool FTrajectoryLoader::LoadFromCsvFile(const FString& FilePath, const FTrajectoryGeoReference& GeoReference, FTrajectorySampleBuffer& OutSamples, FTrajectoryLoader* ProgressTarget)
+{
+	// Publier chaque lot analysé et s'arrêter si le chargement est annulé
+	FTrajectoryCsvLoader::FOnBatchParsed OnBatchParsed;
+	if (ProgressTarget)
+	{
+		OnBatchParsed = [ProgressTarget, &OutSamples](int64 BytesDone, int64 BytesTotal)
+			{
+				ProgressTarget->PublishNewSamples(OutSamples, BytesTotal > 0 ? static_cast<float>(static_cast<double>(BytesDone) / BytesTotal) : 1.0f);
+				return !ProgressTarget->IsCancelled();
+			};
+	}
+
+	if (!FTrajectoryCsvLoader::LoadFile(FilePath, OutSamples, nullptr, OnBatchParsed, GeoReference))
+	{
+		return false;
+	}
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryLoader] Loaded %d waypoints from CSV file %s"), OutSamples.Num(), *FilePath);
+	return true;
+}
+
+bool FTrajectoryLoader::LoadFromAsset(UTrajectoryAsset* Asset, FTrajectorySampleBuffer& OutSamples)
+{
+	if (Asset == nullptr || !Asset->LoadSamples(OutSamples))
+	{
+		return false;
+	}
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryLoader] Loaded %d waypoints from asset %s"), OutSamples.Num(), *Asset->GetName());
+	return true;
+}
+
+bool FTrajectoryLoader::LoadFromPagedFile(const FString& FilePath, FTrajectorySampleBuffer& OutSamples)
+{
+	// Chargement complet (acteur de flotte, conversion) ; ATrajectoryReplayActor lit ces fichiers par tronçons
+	if (!FTrajectoryPagedSource::LoadAllSamples(FilePath, OutSamples))
+	{
+		return false;
+	}
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryLoader] Loaded %d waypoints from paged file %s"), OutSamples.Num(), *FilePath);
+	return true;
+}
+
+void FTrajectoryLoader::OpenChannels(const FTrajectoryLoadRequest& Request, int32 SampleCount, FTrajectoryChannelSet& OutChannels)
+{
+	OutChannels.Reset();
+
+	switch (Request.Source)
+	{
+	case ETrajectorySourceType::CsvFile:
+		FTrajectoryCsvLoader::OpenChannels(Request.FilePath, SampleCount, OutChannels);
+		break;
+
+	case ETrajectorySourceType::Asset:
+		if (Request.Asset)
+		{
+			Request.Asset->OpenChannels(SampleCount, OutChannels);
+		}
+		break;
+
+	case ETrajectorySourceType::DataTable:
+		FTrajectoryChannelSet::OpenDataTable(Request.DataTable, SampleCount, OutChannels);
+		break;
+
+	default:
+		break;
+	}
+}
+
+// ========== CHARGEMENT ASYNCHRONE ==========
+
+TSharedRef<FTrajectoryLoader> FTrajectoryLoader::LaunchAsync(const FTrajectoryLoadRequest& Request)
+{
+	TSharedRef<FTrajectoryLoader> Loader = MakeShareable(new FTrajectoryLoader());
+	Loader->SourceDataTable = Request.DataTable;
+	Loader->SourceAsset = Request.Asset;
+
+	// La tâche utilise un pointeur brut : le destructeur du loader attend sa fin
+	FTrajectoryLoader* RawLoader = &Loader.Get();
+	Loader->Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [RawLoader, Request]()
+		{
+			FTrajectorySampleBuffer Samples;
+			RawLoader->bSucceeded = LoadSamples(Request, Samples, RawLoader);
+			RawLoader->Result = MoveTemp(Samples);
+			RawLoader->Progress.store(1.0f, std::memory_order_relaxed);
+			RawLoader->bDone.store(true, std::memory_order_release);
+		},
+		UE::Tasks::ETaskPriority::BackgroundNormal);
+
+	return Loader;
+}
+
+FTrajectoryLoader::~FTrajectoryLoader()
+{
+	CancelAndWait();
+}
+
+void FTrajectoryLoader::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(SourceDataTable);
+	Collector.AddReferencedObject(SourceAsset);
+}
+
+void FTrajectoryLoader::CancelAndWait()
+{
+	bCancelled.store(true, std::memory_order_relaxed);
+	if (Task.IsValid())
+	{
+		Task.Wait();
+	}
+}
+
+bool FTrajectoryLoader::TakeResult(FTrajectorySampleBuffer& OutSamples)
+{
+	check(IsDone());
+	OutSamples = MoveTemp(Result);
+	return bSucceeded;
+}
+
+void FTrajectoryLoader::PublishNewSamples(const FTrajectorySampleBuffer& Samples, float InProgress)
+{
+	Progress.store(InProgress, std::memory_order_relaxed);
+
+	const int32 Count = Samples.Num();
+	if (!bStreamSorted || Count <= PublishedCount)
+	{
+		return;
+	}
+
+	// Ne publier que des temps finis et croissants, à la suite de ceux déjà publiés
+	for (int32 i = PublishedCount; i < Count; i++)
+	{
+		const bool bFinite = FMath::IsFinite(Samples.Times[i]) && FMath::IsFinite(Samples.PosX[i]) && FMath::IsFinite(Samples.PosY[i]) && FMath::IsFinite(Samples.PosZ[i]);
+		if (!bFinite || (i > 0 && Samples.Times[i] < Samples.Times[i - 1]))
+		{
+			bStreamSorted = false;
+			return;
+		}
+	}
+
+	FTrajectorySampleBuffer Batch;
+	Batch.Append(Samples, PublishedCount);
+	StreamedBatches.Enqueue(MoveTemp(Batch));
+	PublishedCount = Count;
+}
@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Tasks/Task.h"
+#include "UObject/GCObject.h"
+#include "TrajectorySampleBuffer.h"
+#include "TrajectoryGeodetic.h"
+#include <atomic>
+#include "TrajectoryLoader.generated.h"
+
+class UDataTable;
+class UTrajectoryAsset;
+class FTrajectoryChannelSet;
+
+/**
+ * Origine des données de trajectoire
+ */
+UENUM(BlueprintType)
+enum class ETrajectorySourceType : uint8
+{
+	// DataTable de FDroneWaypointRow importé dans l'éditeur
+	DataTable UMETA(DisplayName = "DataTable"),
+
+	// Fichier CSV lu directement à l'exécution
+	CsvFile UMETA(DisplayName = "CSV File"),
+
+	// Asset binaire compact (UTrajectoryAsset)
+	Asset UMETA(DisplayName = "Trajectory Asset"),
+
+	// Fichier paginé (.dtraj) : seuls les tronçons autour de la tête de lecture sont en mémoire
+	PagedFile UMETA(DisplayName = "Paged File"),
+
+	// Télémétrie reçue en direct sur un port UDP local (ATrajectoryReplayActor uniquement)
+	LiveUdp UMETA(DisplayName = "Live UDP")
+};
+
+/**
+ * État du chargement d'une trajectoire
+ */
+UENUM(BlueprintType)
+enum class ETrajectoryLoadState : uint8
+{
+	// Aucune donnée chargée
+	Unloaded UMETA(DisplayName = "Unloaded"),
+
+	// Chargement en cours en arrière-plan (le début de la trajectoire peut déjà être disponible)
+	Loading UMETA(DisplayName = "Loading"),
+
+	// Trajectoire complète disponible
+	Loaded UMETA(DisplayName = "Loaded"),
+
+	// Échec du chargement
+	Failed UMETA(DisplayName = "Failed")
+};
+
+/**
+ * Description d'un chargement : source et références nécessaires pour la lire
+ * Les chargeurs (FTrajectoryLoader, FTrajectoryBatchLoader) gardent le DataTable et l'asset référencés
+ * en vie jusqu'à leur destruction ; un appel direct à LoadSamples doit les garder valides lui-même
+ */
+struct FTrajectoryLoadRequest
+{
+	ETrajectorySourceType Source = ETrajectorySourceType::DataTable;
+	const UDataTable* DataTable = nullptr;
+	UTrajectoryAsset* Asset = nullptr;
+
+	// Chemin absolu du fichier CSV ou paginé
+	FString FilePath;
+
+	// Repère des fichiers CSV en latitude/longitude/altitude ; invalide : origine au premier échantillon du fichier
+	FTrajectoryGeoReference GeoReference;
+};
+
+/**
+ * Chargement d'une trajectoire : lecture de la source, validation et tri
+ * Peut s'exécuter sur le thread appelant (LoadSamples) ou dans une tâche de fond (LaunchAsync).
+ * En arrière-plan, tant que les données arrivent déjà triées, chaque lot lu est publié
+ * pour que la lecture puisse démarrer avant la fin du chargement.
+ * Le DataTable ou l'asset lu par la tâche est référencé auprès du ramasse-miettes tant que le loader existe.
+ */
+class DATAREPLAY_API FTrajectoryLoader : public FGCObject
+{
+public:
+	// Charger, valider et trier les échantillons sur le thread courant
+	static bool LoadSamples(const FTrajectoryLoadRequest& Request, FTrajectorySampleBuffer& OutSamples, FTrajectoryLoader* ProgressTarget = nullptr);
+
+	// Démarrer un chargement dans une tâche de fond
+	static TSharedRef<FTrajectoryLoader> LaunchAsync(const FTrajectoryLoadRequest& Request);
+
+	/**
+	 * Lister les canaux de télémétrie de la source d'une trajectoire chargée (thread de jeu), sans décoder leurs valeurs
+	 * CSV, DataTable et asset ; aucun canal pour les fichiers paginés et le direct. SampleCount : échantillons chargés.
+	 */
+	static void OpenChannels(const FTrajectoryLoadRequest& Request, int32 SampleCount, FTrajectoryChannelSet& OutChannels);
+
+	virtual ~FTrajectoryLoader() override;
+
+	// ========== FGCOBJECT ==========
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override { return TEXT("FTrajectoryLoader"); }
+
+	// ========== SUIVI (THREAD DE JEU) ==========
+
+	// Demander l'arrêt du chargement, puis attendre la fin de la tâche
+	void CancelAndWait();
+
+	bool IsCancelled() const { return bCancelled.load(std::memory_order_relaxed); }
+	bool IsDone() const { return bDone.load(std::memory_order_acquire); }
+
+	// Progression entre 0 et 1
+	float GetProgress() const { return Progress.load(std::memory_order_relaxed); }
+
+	// Récupérer le prochain lot d'échantillons triés publié par la tâche
+	bool DequeueStreamedBatch(FTrajectorySampleBuffer& OutBatch) { return StreamedBatches.Dequeue(OutBatch); }
+
+	// Résultat du chargement (une fois IsDone())
+	bool HasSucceeded() const { return bSucceeded; }
+
+	// Vrai si tous les lots publiés forment déjà la trajectoire finale (aucun tri ni suppression nécessaire)
+	bool IsStreamComplete() const { return bStreamComplete; }
+
+	// Récupérer le résultat final (une fois IsDone())
+	bool TakeResult(FTrajectorySampleBuffer& OutSamples);
+
+	// ========== PUBLICATION (TÂCHE DE FOND) ==========
+
+	// Publier les échantillons ajoutés depuis le dernier appel, tant qu'ils restent triés
+	void PublishNewSamples(const FTrajectorySampleBuffer& Samples, float InProgress);
+
+private:
+	FTrajectoryLoader() = default;
+
+	static bool LoadFromDataTable(const UDataTable* DataTable, FTrajectorySampleBuffer& OutSamples);
+	static bool LoadFromCsvFile(const FString& FilePath, const FTrajectoryGeoReference& GeoReference, FTrajectorySampleBuffer& OutSamples, FTrajectoryLoader* ProgressTarget);
+	static bool LoadFromAsset(UTrajectoryAsset* Asset, FTrajectorySampleBuffer& OutSamples);
+	static bool LoadFromPagedFile(const FString& FilePath, FTrajectorySampleBuffer& OutSamples);
+
+	// Objets lus par la tâche, référencés pour le ramasse-miettes (la tâche garde sa propre copie des pointeurs)
+	const UDataTable* SourceDataTable = nullptr;
+	UTrajectoryAsset* SourceAsset = nullptr;
+
+	// Lots publiés (un seul producteur : la tâche, un seul consommateur : le thread de jeu)
+	TQueue<FTrajectorySampleBuffer, EQueueMode::Spsc> StreamedBatches;
+
+	// Nombre d'échantillons déjà publiés
+	int32 PublishedCount = 0;
+
+	// Faux dès qu'un lot n'arrive pas dans l'ordre : la suite n'est plus publiée avant le tri final
+	bool bStreamSorted = true;
+
+	// Écrit par la tâche avant bDone
+	bool bStreamComplete = false;
+	bool bSucceeded = false;
+	FTrajectorySampleBuffer Result;
+
+	std::atomic<float> Progress { 0.0f };
+	std::atomic<bool> bCancelled { false };
+	std::atomic<bool> bDone { false };
+
+	UE::Tasks::FTask Task;
+};
@@ -0,0 +1,454 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryPagedSource.h"
+#include "DataReplay.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+namespace TrajectoryPaged
+{
+	constexpr uint32 Magic = 0x47505244; // 'DRPG'
+	constexpr int32 Version = 2;
+
+	// Les fichiers de la version 1 (sans aperçu) restent lisibles
+	constexpr int32 MinVersion = 1;
+
+	// Points de l'aperçu basse résolution par tronçon
+	constexpr int32 OverviewPointsPerChunk = 16;
+
+	// Taille de l'en-tête et d'une entrée de la table (octets)
+	constexpr int64 HeaderSize = sizeof(uint32) + sizeof(int32) + 3 * sizeof(float) + 2 * sizeof(int32);
+	constexpr int64 ChunkEntrySize = sizeof(int64) + sizeof(int32);
+}
+
+// ========== ÉCRITURE ==========
+
+bool FTrajectoryPagedSource::WriteFile(const FString& FilePath, const FTrajectorySampleBuffer& Samples, float ChunkDuration)
+{
+	if (Samples.IsEmpty() || ChunkDuration <= 0.0f || !Samples.IsSortedByTime())
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryPaged] Cannot write %s: samples must be non-empty and sorted, chunk duration positive"), *FilePath);
+		return false;
+	}
+
+	const int32 Count = Samples.Num();
+	float FileStartTime = Samples.GetStartTime();
+	float FileEndTime = Samples.GetEndTime();
+	int32 ChunkCount = FMath::Max(1, FMath::CeilToInt((FileEndTime - FileStartTime) / ChunkDuration));
+
+	// Plage de chaque tronçon, étendue d'un échantillon de chaque côté
+	TArray<int32> FirstSamples;
+	TArray<int32> SampleCounts;
+	FirstSamples.SetNumUninitialized(ChunkCount);
+	SampleCounts.SetNumUninitialized(ChunkCount);
+
+	int32 RangeBegin = 0;
+	for (int32 ChunkIndex = 0; ChunkIndex < ChunkCount; ChunkIndex++)
+	{
+		// Premier échantillon du tronçon suivant
+		int32 RangeEnd = Count;
+		if (ChunkIndex < ChunkCount - 1)
+		{
+			const float ChunkEnd = FileStartTime + (ChunkIndex + 1) * ChunkDuration;
+			RangeEnd = RangeBegin;
+			while (RangeEnd < Count && Samples.Times[RangeEnd] < ChunkEnd)
+			{
+				RangeEnd++;
+			}
+		}
+
+		const int32 First = FMath::Max(RangeBegin - 1, 0);
+		const int32 Last = FMath::Min(RangeEnd, Count - 1);
+		FirstSamples[ChunkIndex] = First;
+		SampleCounts[ChunkIndex] = Last - First + 1;
+		RangeBegin = RangeEnd;
+	}
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Writer)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryPaged] Cannot open %s for writing"), *FilePath);
+		return false;
+	}
+
+	// En-tête
+	uint32 Magic = TrajectoryPaged::Magic;
+	int32 Version = TrajectoryPaged::Version;
+	int32 TotalSamples = Count;
+	*Writer << Magic << Version << ChunkDuration << FileStartTime << FileEndTime << TotalSamples << ChunkCount;
+
+	// Aperçu : la trajectoire échantillonnée à intervalle régulier, extrémités comprises
+	int32 OverviewCount = ChunkCount * TrajectoryPaged::OverviewPointsPerChunk + 1;
+	FTrajectorySampleBuffer Overview;
+	Overview.Reserve(OverviewCount);
+	int32 Cursor = 0;
+	for (int32 i = 0; i < OverviewCount; i++)
+	{
+		const float Time = FMath::Lerp(FileStartTime, FileEndTime, static_cast<float>(i) / (OverviewCount - 1));
+		const FVector Position = Samples.EvaluatePosition(Time, Cursor);
+		Overview.Add(Time, Position.X, Position.Y, Position.Z);
+	}
+	const int64 OverviewBytes = sizeof(int32) + static_cast<int64>(OverviewCount) * 4 * sizeof(float);
+
+	// Table des tronçons
+	int64 Offset = TrajectoryPaged::HeaderSize + ChunkCount * TrajectoryPaged::ChunkEntrySize + OverviewBytes;
+	for (int32 ChunkIndex = 0; ChunkIndex < ChunkCount; ChunkIndex++)
+	{
+		int32 SampleCount = SampleCounts[ChunkIndex];
+		*Writer << Offset << SampleCount;
+		Offset += static_cast<int64>(SampleCount) * 4 * sizeof(float);
+	}
+
+	*Writer << OverviewCount;
+	const int64 OverviewColumnBytes = static_cast<int64>(OverviewCount) * sizeof(float);
+	Writer->Serialize(Overview.Times.GetData(), OverviewColumnBytes);
+	Writer->Serialize(Overview.PosX.GetData(), OverviewColumnBytes);
+	Writer->Serialize(Overview.PosY.GetData(), OverviewColumnBytes);
+	Writer->Serialize(Overview.PosZ.GetData(), OverviewColumnBytes);
+
+	// Colonnes de chaque tronçon
+	for (int32 ChunkIndex = 0; ChunkIndex < ChunkCount; ChunkIndex++)
+	{
+		const int32 First = FirstSamples[ChunkIndex];
+		const int64 ColumnBytes = static_cast<int64>(SampleCounts[ChunkIndex]) * sizeof(float);
+		Writer->Serialize(const_cast<float*>(Samples.Times.GetData() + First), ColumnBytes);
+		Writer->Serialize(const_cast<float*>(Samples.PosX.GetData() + First), ColumnBytes);
+		Writer->Serialize(const_cast<float*>(Samples.PosY.GetData() + First), ColumnBytes);
+		Writer->Serialize(const_cast<float*>(Samples.PosZ.GetData() + First), ColumnBytes);
+	}
+
+	const bool bSucceeded = Writer->Close() && !Writer->IsError();
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryPaged] Wrote %s: %d samples in %d chunks of %.1f s"), *FilePath, Count, ChunkCount, ChunkDuration);
+	return bSucceeded;
+}
+
+// ========== OUVERTURE ==========
+
+TSharedPtr<FTrajectoryPagedSource> FTrajectoryPagedSource::Open(const FString& FilePath, int64 MemoryBudgetBytes)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Reader)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryPaged] Cannot open %s"), *FilePath);
+		return nullptr;
+	}
+
+	TSharedPtr<FTrajectoryPagedSource> Source = MakeShareable(new FTrajectoryPagedSource());
+	Source->FilePath = FilePath;
+	Source->MemoryBudget = MemoryBudgetBytes;
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 ChunkCount = 0;
+	*Reader << Magic << Version;
+	if (Magic != TrajectoryPaged::Magic || Version < TrajectoryPaged::MinVersion || Version > TrajectoryPaged::Version)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryPaged] %s is not a paged trajectory file (version %d)"), *FilePath, TrajectoryPaged::Version);
+		return nullptr;
+	}
+
+	*Reader << Source->ChunkDuration << Source->StartTime << Source->EndTime << Source->TotalSamples << ChunkCount;
+
+	const int64 FileSize = Reader->TotalSize();
+	if (Reader->IsError() || ChunkCount <= 0 || Source->ChunkDuration <= 0.0f
+		|| TrajectoryPaged::HeaderSize + ChunkCount * TrajectoryPaged::ChunkEntrySize > FileSize)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryPaged] %s has an invalid header"), *FilePath);
+		return nullptr;
+	}
+
+	Source->Chunks.SetNum(ChunkCount);
+	for (FChunkInfo& Info : Source->Chunks)
+	{
+		*Reader << Info.Offset << Info.SampleCount;
+		if (Info.SampleCount <= 0 || Info.Offset + static_cast<int64>(Info.SampleCount) * 4 * sizeof(float) > FileSize)
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryPaged] %s has an invalid chunk table"), *FilePath);
+			return nullptr;
+		}
+	}
+
+	if (Version >= 2)
+	{
+		int32 OverviewCount = 0;
+		*Reader << OverviewCount;
+		if (Reader->IsError() || OverviewCount < 0 || Reader->Tell() + static_cast<int64>(OverviewCount) * 4 * sizeof(float) > FileSize)
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryPaged] %s has an invalid overview"), *FilePath);
+			return nullptr;
+		}
+
+		LLM_SCOPE_BYTAG(DataReplay_Samples);
+		Source->Overview.SetNumUninitialized(OverviewCount);
+		const int64 OverviewColumnBytes = static_cast<int64>(OverviewCount) * sizeof(float);
+		Reader->Serialize(Source->Overview.Times.GetData(), OverviewColumnBytes);
+		Reader->Serialize(Source->Overview.PosX.GetData(), OverviewColumnBytes);
+		Reader->Serialize(Source->Overview.PosY.GetData(), OverviewColumnBytes);
+		Reader->Serialize(Source->Overview.PosZ.GetData(), OverviewColumnBytes);
+	}
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryPaged] Opened %s: %d samples, %d chunks of %.1f s, budget %.1f MB"),
+		*FilePath, Source->TotalSamples, ChunkCount, Source->ChunkDuration, MemoryBudgetBytes / (1024.0 * 1024.0));
+	return Source;
+}
+
+FTrajectoryPagedSource::~FTrajectoryPagedSource()
+{
+	// Les tâches ne référencent pas la source : les attendre évite seulement des lectures inutiles en fin de partie
+	for (TPair<int32, UE::Tasks::TTask<FChunkSamplesPtr>>& Pending : PendingChunks)
+	{
+		Pending.Value.Wait();
+	}
+}
+
+FTrajectoryPagedSource::FChunkSamplesPtr FTrajectoryPagedSource::ReadChunk(const FString& FilePath, const FChunkInfo& Info)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TrajectoryPagedSource::ReadChunk);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Reader)
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<FTrajectorySampleBuffer, ESPMode::ThreadSafe> Samples = MakeShared<FTrajectorySampleBuffer, ESPMode::ThreadSafe>();
+	Samples->SetNumUninitialized(Info.SampleCount);
+
+	const int64 ColumnBytes = static_cast<int64>(Info.SampleCount) * sizeof(float);
+	Reader->Seek(Info.Offset);
+	Reader->Serialize(Samples->Times.GetData(), ColumnBytes);
+	Reader->Serialize(Samples->PosX.GetData(), ColumnBytes);
+	Reader->Serialize(Samples->PosY.GetData(), ColumnBytes);
+	Reader->Serialize(Samples->PosZ.GetData(), ColumnBytes);
+
+	if (Reader->IsError())
+	{
+		return nullptr;
+	}
+	return Samples;
+}
+
+bool FTrajectoryPagedSource::LoadAllSamples(const FString& FilePath, FTrajectorySampleBuffer& OutSamples)
+{
+	TSharedPtr<FTrajectoryPagedSource> Source = Open(FilePath, 0);
+	if (!Source)
+	{
+		return false;
+	}
+
+	OutSamples.Reset();
+	OutSamples.Reserve(Source->TotalSamples);
+
+	for (int32 ChunkIndex = 0; ChunkIndex < Source->Chunks.Num(); ChunkIndex++)
+	{
+		FChunkSamplesPtr Chunk = ReadChunk(FilePath, Source->Chunks[ChunkIndex]);
+		if (!Chunk)
+		{
+			OutSamples.Reset();
+			return false;
+		}
+
+		// Ne garder que la plage propre du tronçon (les échantillons voisins sont dans les autres tronçons)
+		const float ChunkStart = Source->StartTime + ChunkIndex * Source->ChunkDuration;
+		const float ChunkEnd = ChunkStart + Source->ChunkDuration;
+		const bool bLastChunk = ChunkIndex == Source->Chunks.Num() - 1;
+		for (int32 i = 0; i < Chunk->Num(); i++)
+		{
+			const float Time = Chunk->Times[i];
+			if ((ChunkIndex == 0 || Time >= ChunkStart) && (bLastChunk || Time < ChunkEnd))
+			{
+				OutSamples.Add(Time, Chunk->PosX[i], Chunk->PosY[i], Chunk->PosZ[i]);
+			}
+		}
+	}
+
+	return true;
+}
+
+// ========== LECTURE ==========
+
+int32 FTrajectoryPagedSource::GetChunkIndex(float Time) const
+{
+	return FMath::Clamp(FMath::FloorToInt((Time - StartTime) / ChunkDuration), 0, Chunks.Num() - 1);
+}
+
+void FTrajectoryPagedSource::SetMemoryBudget(int64 Bytes)
+{
+	MemoryBudget = Bytes;
+	EvictOverBudget();
+}
+
+void FTrajectoryPagedSource::HarvestPrefetches()
+{
+	for (auto It = PendingChunks.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsCompleted())
+		{
+			continue;
+		}
+
+		FChunkSamplesPtr Samples = It.Value().GetResult();
+		if (Samples)
+		{
+			FResidentChunk& Resident = ResidentChunks.Add(It.Key());
+			Resident.Samples = Samples;
+			Resident.LastUse = ++UseCounter;
+			ResidentBytes += Samples->GetAllocatedSize();
+		}
+		It.RemoveCurrent();
+	}
+}
+
+const FTrajectoryPagedSource::FResidentChunk& FTrajectoryPagedSource::AcquireChunk(int32 ChunkIndex)
+{
+	if (FResidentChunk* Resident = ResidentChunks.Find(ChunkIndex))
+	{
+		Resident->LastUse = ++UseCounter;
+		return *Resident;
+	}
+
+	// Attendre le préchargement en cours, ou lire le tronçon maintenant
+	FChunkSamplesPtr Samples;
+	if (UE::Tasks::TTask<FChunkSamplesPtr>* Pending = PendingChunks.Find(ChunkIndex))
+	{
+		Samples = Pending->GetResult();
+		PendingChunks.Remove(ChunkIndex);
+	}
+	else
+	{
+		Samples = ReadChunk(FilePath, Chunks[ChunkIndex]);
+	}
+
+	if (!Samples)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryPaged] Failed to read chunk %d of %s"), ChunkIndex, *FilePath);
+		Samples = MakeShared<FTrajectorySampleBuffer, ESPMode::ThreadSafe>();
+	}
+
+	FResidentChunk& Resident = ResidentChunks.Add(ChunkIndex);
+	Resident.Samples = Samples;
+	Resident.LastUse = ++UseCounter;
+	ResidentBytes += Samples->GetAllocatedSize();
+	return Resident;
+}
+
+void FTrajectoryPagedSource::RequestPrefetch(int32 ChunkIndex)
+{
+	if (ResidentChunks.Contains(ChunkIndex) || PendingChunks.Contains(ChunkIndex))
+	{
+		return;
+	}
+
+	// La tâche ne capture que des copies : elle peut survivre à la source
+	PendingChunks.Add(ChunkIndex, UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[Path = FilePath, Info = Chunks[ChunkIndex]]()
+		{
+			return ReadChunk(Path, Info);
+		},
+		UE::Tasks::ETaskPriority::BackgroundNormal));
+	PrefetchCount++;
+}
+
+void FTrajectoryPagedSource::EvictOverBudget()
+{
+	while (ResidentBytes > MemoryBudget && ResidentChunks.Num() > 1)
+	{
+		int32 OldestIndex = INDEX_NONE;
+		uint64 OldestUse = MAX_uint64;
+		for (const TPair<int32, FResidentChunk>& Resident : ResidentChunks)
+		{
+			if (Resident.Key != ActiveChunkIndex && Resident.Value.LastUse < OldestUse)
+			{
+				OldestUse = Resident.Value.LastUse;
+				OldestIndex = Resident.Key;
+			}
+		}
+
+		if (OldestIndex == INDEX_NONE)
+		{
+			break;
+		}
+
+		ResidentBytes -= ResidentChunks[OldestIndex].Samples->GetAllocatedSize();
+		ResidentChunks.Remove(OldestIndex);
+		EvictionCount++;
+	}
+}
+
+void FTrajectoryPagedSource::Update(float PlaybackTime, float SignedSpeed, float PrefetchSeconds)
+{
+	HarvestPrefetches();
+
+	// Tronçon de la tête de lecture : seul cas où la lecture peut bloquer
+	const int32 ChunkIndex = GetChunkIndex(PlaybackTime);
+	if (ChunkIndex != ActiveChunkIndex)
+	{
+		if (ResidentChunks.Contains(ChunkIndex))
+		{
+			HitCount++;
+		}
+		else
+		{
+			MissCount++;
+		}
+
+		ActiveChunk = AcquireChunk(ChunkIndex).Samples;
+		ActiveChunkIndex = ChunkIndex;
+	}
+	else
+	{
+		ResidentChunks[ChunkIndex].LastUse = ++UseCounter;
+	}
+
+	// Préchargement dans le sens de lecture, sur PrefetchSeconds de lecture à la vitesse actuelle,
+	// sans demander plus de tronçons que le budget ne peut en garder
+	const int64 ChunkBytes = ActiveChunk->GetAllocatedSize();
+	const int32 BudgetChunks = ChunkBytes > 0 ? static_cast<int32>(MemoryBudget / ChunkBytes) - 1 : 0;
+	const int32 AheadChunks = FMath::Min(FMath::CeilToInt(FMath::Abs(SignedSpeed) * PrefetchSeconds / ChunkDuration), BudgetChunks);
+	const int32 Direction = SignedSpeed < 0.0f ? -1 : 1;
+
+	for (int32 Ahead = 1; Ahead <= AheadChunks; Ahead++)
+	{
+		const int32 PrefetchIndex = ChunkIndex + Direction * Ahead;
+		if (PrefetchIndex < 0 || PrefetchIndex >= Chunks.Num())
+		{
+			break;
+		}
+		RequestPrefetch(PrefetchIndex);
+	}
+
+	EvictOverBudget();
+}
+
+FVector FTrajectoryPagedSource::EvaluatePosition(float Time, int32& InOutCursor) const
+{
+	return ActiveChunk ? ActiveChunk->EvaluatePosition(Time, InOutCursor) : FVector::ZeroVector;
+}
+
+FVector FTrajectoryPagedSource::EvaluatePreviewPosition(float Time)
+{
+	HarvestPrefetches();
+
+	// Tronçon déjà en mémoire : position exacte
+	const int32 ChunkIndex = GetChunkIndex(Time);
+	if (const FResidentChunk* Resident = ResidentChunks.Find(ChunkIndex))
+	{
+		int32 Cursor = 0;
+		return Resident->Samples->EvaluatePosition(Time, Cursor);
+	}
+
+	// Une seule lecture en attente : un déplacement rapide ne lance pas une lecture par tronçon traversé
+	if (PendingChunks.IsEmpty())
+	{
+		RequestPrefetch(ChunkIndex);
+	}
+
+	if (!Overview.IsEmpty())
+	{
+		return Overview.EvaluatePosition(Time, OverviewCursor);
+	}
+
+	int32 Cursor = 0;
+	return EvaluatePosition(Time, Cursor);
+}
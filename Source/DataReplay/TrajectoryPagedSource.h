@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "TrajectorySampleBuffer.h"
+
+/**
+ * Trajectoire paginée : la ligne de temps est découpée en tronçons de durée fixe stockés sur disque,
+ * et seul un ensemble LRU de tronçons autour de la tête de lecture reste en mémoire.
+ *
+ * Format du fichier (.dtraj, little-endian) :
+ *   en-tête   : Magic 'DRPG', Version, ChunkDuration, StartTime, EndTime, TotalSamples, ChunkCount
+ *   table     : pour chaque tronçon, Offset (int64) et SampleCount (int32)
+ *   aperçu    : OverviewCount (int32) puis colonnes Time, X, Y, Z (version 2)
+ *   tronçons  : colonnes Time, X, Y, Z à la suite (SampleCount floats chacune)
+ * Chaque tronçon contient aussi le dernier échantillon avant sa plage et le premier après :
+ * tout temps de sa plage s'interpole sans lire le tronçon voisin.
+ * L'aperçu échantillonne la trajectoire à basse résolution pour toute sa durée : il reste en mémoire
+ * et donne une position approchée sans lecture disque (déplacement rapide dans la timeline).
+ */
+class DATAREPLAY_API FTrajectoryPagedSource
+{
+public:
+	// Écrire un fichier paginé à partir d'échantillons triés
+	static bool WriteFile(const FString& FilePath, const FTrajectorySampleBuffer& Samples, float ChunkDuration);
+
+	// Lire un fichier paginé en entier (sans les échantillons dupliqués entre tronçons)
+	static bool LoadAllSamples(const FString& FilePath, FTrajectorySampleBuffer& OutSamples);
+
+	// Ouvrir un fichier paginé (lit seulement l'en-tête et la table des tronçons)
+	static TSharedPtr<FTrajectoryPagedSource> Open(const FString& FilePath, int64 MemoryBudgetBytes);
+
+	~FTrajectoryPagedSource();
+
+	// ========== INFORMATIONS ==========
+
+	int32 GetTotalSampleCount() const { return TotalSamples; }
+	float GetStartTime() const { return StartTime; }
+	float GetEndTime() const { return EndTime; }
+	int32 GetNumChunks() const { return Chunks.Num(); }
+	float GetChunkDuration() const { return ChunkDuration; }
+
+	// ========== LECTURE (THREAD DE JEU) ==========
+
+	// Changer le budget mémoire des tronçons résidents (octets)
+	void SetMemoryBudget(int64 Bytes);
+
+	/**
+	 * Préparer le tronçon du temps donné et précharger la suite
+	 * Bloque uniquement si ce tronçon n'est pas encore en mémoire (seek, ou préchargement trop lent).
+	 * SignedSpeed : vitesse de lecture signée (négative en lecture inverse), pour précharger
+	 * PrefetchSeconds secondes de lecture dans le sens du déplacement.
+	 */
+	void Update(float PlaybackTime, float SignedSpeed, float PrefetchSeconds);
+
+	/**
+	 * Position au temps donné dans le tronçon préparé par Update (lecture seule, utilisable depuis plusieurs threads)
+	 * Hors de ce tronçon, la position est bornée à ses extrémités.
+	 */
+	FVector EvaluatePosition(float Time, int32& InOutCursor) const;
+
+	/**
+	 * Position approchée au temps donné, sans jamais bloquer
+	 * Exacte si le tronçon est résident ; sinon interpolée dans l'aperçu, et le tronçon est demandé en arrière-plan
+	 * pour que l'Update suivant au même temps ne l'attende pas. Sans aperçu (version 1), bornée au tronçon actif.
+	 */
+	FVector EvaluatePreviewPosition(float Time);
+
+	bool HasOverview() const { return !Overview.IsEmpty(); }
+
+	// ========== STATISTIQUES ==========
+
+	// Changements de tronçon servis par un tronçon déjà résident (préchargé)
+	int32 GetHitCount() const { return HitCount; }
+
+	// Changements de tronçon qui ont dû attendre une lecture disque
+	int32 GetMissCount() const { return MissCount; }
+
+	int32 GetPrefetchCount() const { return PrefetchCount; }
+	int32 GetEvictionCount() const { return EvictionCount; }
+
+	// Mémoire des tronçons résidents (octets)
+	int64 GetResidentBytes() const { return ResidentBytes; }
+
+private:
+	using FChunkSamplesPtr = TSharedPtr<const FTrajectorySampleBuffer, ESPMode::ThreadSafe>;
+
+	struct FChunkInfo
+	{
+		int64 Offset = 0;
+		int32 SampleCount = 0;
+	};
+
+	struct FResidentChunk
+	{
+		FChunkSamplesPtr Samples;
+
+		// Ordre de dernière utilisation (le plus petit est évincé en premier)
+		uint64 LastUse = 0;
+	};
+
+	FTrajectoryPagedSource() = default;
+
+	int32 GetChunkIndex(float Time) const;
+
+	// Lire un tronçon depuis le disque (sans état partagé : utilisable depuis une tâche)
+	static FChunkSamplesPtr ReadChunk(const FString& FilePath, const FChunkInfo& Info);
+
+	// Intégrer les préchargements terminés
+	void HarvestPrefetches();
+
+	// Rendre un tronçon résident, en attendant sa lecture si nécessaire
+	const FResidentChunk& AcquireChunk(int32 ChunkIndex);
+
+	// Lancer la lecture d'un tronçon en arrière-plan
+	void RequestPrefetch(int32 ChunkIndex);
+
+	// Évincer les tronçons les moins récemment utilisés au-delà du budget (sauf le tronçon actif)
+	void EvictOverBudget();
+
+	FString FilePath;
+	TArray<FChunkInfo> Chunks;
+	float ChunkDuration = 0.0f;
+	float StartTime = 0.0f;
+	float EndTime = 0.0f;
+	int32 TotalSamples = 0;
+
+	// Trajectoire basse résolution (OverviewPointsPerChunk points par tronçon)
+	FTrajectorySampleBuffer Overview;
+	int32 OverviewCursor = 0;
+
+	TMap<int32, FResidentChunk> ResidentChunks;
+	TMap<int32, UE::Tasks::TTask<FChunkSamplesPtr>> PendingChunks;
+
+	// Tronçon préparé par le dernier Update
+	FChunkSamplesPtr ActiveChunk;
+	int32 ActiveChunkIndex = INDEX_NONE;
+
+	uint64 UseCounter = 0;
+	int64 MemoryBudget = 0;
+	int64 ResidentBytes = 0;
+
+	int32 HitCount = 0;
+	int32 MissCount = 0;
+	int32 PrefetchCount = 0;
+	int32 EvictionCount = 0;
+};
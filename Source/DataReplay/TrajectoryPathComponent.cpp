@@ -0,0 +1,559 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryPathComponent.h"
+#include "DataReplay.h"
+#include "TrajectorySampleBuffer.h"
+#include "PrimitiveSceneProxy.h"
+#include "SceneManagement.h"
+#include "RenderingThread.h"
+#include "LocalVertexFactory.h"
+#include "RawIndexBuffer.h"
+#include "StaticMeshResources.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialRenderProxy.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
+#include <atomic>
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Vertices Drawn"), STAT_TrajectoryPathVerticesDrawn, STATGROUP_DataReplay);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Vertices Total"), STAT_TrajectoryPathVerticesTotal, STATGROUP_DataReplay);
+
+static TAutoConsoleVariable<float> CVarTrajectoryPathLODErrorPixels(
+	TEXT("DataReplay.PathLOD.ErrorPixels"),
+	1.0f,
+	TEXT("Erreur maximale tolérée (en pixels) entre la ligne de trajectoire simplifiée et la trajectoire complète.\n")
+	TEXT("0 : toujours dessiner tous les points."),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+namespace TrajectoryPathLod
+{
+	// Nombre de points par tronçon (borne le coût de la simplification et permet un niveau par distance)
+	constexpr int32 ChunkSize = 1024;
+
+	// Nombre maximal de niveaux simplifiés par tronçon
+	constexpr int32 MaxLevels = 12;
+
+	// Plages d'indices par FMeshBatch (le moteur sélectionne les éléments d'un lot par un masque de 64 bits)
+	constexpr int32 MaxBatchElements = 64;
+
+	// Segments dessinés pendant la frame de rendu en cours, publiés dans Insights au début de la suivante
+	static std::atomic<uint32> SegmentsFrame { 0 };
+	static std::atomic<int64> SegmentsDrawn { 0 };
+
+	static void AddSegmentsDrawn(int64 Count)
+	{
+		const uint32 Frame = GFrameNumberRenderThread;
+		uint32 PreviousFrame = SegmentsFrame.load(std::memory_order_relaxed);
+		if (PreviousFrame != Frame && SegmentsFrame.compare_exchange_strong(PreviousFrame, Frame, std::memory_order_relaxed))
+		{
+			TRACE_COUNTER_SET(DataReplay_SegmentsDrawn, SegmentsDrawn.exchange(0, std::memory_order_relaxed));
+		}
+		SegmentsDrawn.fetch_add(Count, std::memory_order_relaxed);
+	}
+
+	// Distance d'un point au segment [A, B]
+	static float PointSegmentDistance(const FVector3f& P, const FVector3f& A, const FVector3f& B)
+	{
+		const FVector3f AB = B - A;
+		const float LengthSquared = AB.SizeSquared();
+		const float Alpha = LengthSquared > UE_SMALL_NUMBER ? FMath::Clamp(FVector3f::DotProduct(P - A, AB) / LengthSquared, 0.0f, 1.0f) : 0.0f;
+		return FVector3f::Dist(P, A + AB * Alpha);
+	}
+
+	/**
+	 * Importance Douglas-Peucker de chaque point du tronçon : écart à partir duquel il est conservé
+	 * L'importance d'un point ne dépasse jamais celle du point qui a découpé son segment parent,
+	 * si bien que les points d'importance > E forment exactement la simplification au seuil E.
+	 */
+	static void ComputeImportance(const FVector3f* Points, int32 Count, TArray<float>& OutImportance)
+	{
+		OutImportance.Init(0.0f, Count);
+		OutImportance[0] = MAX_flt;
+		OutImportance[Count - 1] = MAX_flt;
+
+		struct FSegment
+		{
+			int32 First;
+			int32 Last;
+			float ParentImportance;
+		};
+
+		TArray<FSegment, TInlineAllocator<64>> Stack;
+		Stack.Add({ 0, Count - 1, MAX_flt });
+
+		while (Stack.Num() > 0)
+		{
+			const FSegment Segment = Stack.Pop(EAllowShrinking::No);
+			if (Segment.Last - Segment.First < 2)
+			{
+				continue;
+			}
+
+			int32 FarthestIndex = Segment.First + 1;
+			float FarthestDistance = -1.0f;
+			for (int32 i = Segment.First + 1; i < Segment.Last; i++)
+			{
+				const float Distance = PointSegmentDistance(Points[i], Points[Segment.First], Points[Segment.Last]);
+				if (Distance > FarthestDistance)
+				{
+					FarthestDistance = Distance;
+					FarthestIndex = i;
+				}
+			}
+
+			const float Importance = FMath::Min(FarthestDistance, Segment.ParentImportance);
+			OutImportance[FarthestIndex] = Importance;
+			Stack.Add({ Segment.First, FarthestIndex, Importance });
+			Stack.Add({ FarthestIndex, Segment.Last, Importance });
+		}
+	}
+
+	// Niveaux simplifiés d'un tronçon ; les points conservés par chaque niveau sont ajoutés à OutLevelPoints
+	static void BuildChunkLevels(const TArray<FVector3f>& AllPoints, FTrajectoryPathChunk& Chunk, TArray<TArray<int32>>& OutLevelPoints)
+	{
+		const int32 Count = Chunk.LastPoint - Chunk.FirstPoint + 1;
+		const FVector3f* Points = AllPoints.GetData() + Chunk.FirstPoint;
+
+		Chunk.Bounds = FBox(ForceInit);
+		for (int32 i = 0; i < Count; i++)
+		{
+			Chunk.Bounds += FVector(Points[i]);
+		}
+
+		if (Count <= 2)
+		{
+			return;
+		}
+
+		TArray<float> Importance;
+		ComputeImportance(Points, Count, Importance);
+
+		float MaxInteriorImportance = 0.0f;
+		for (int32 i = 1; i < Count - 1; i++)
+		{
+			MaxInteriorImportance = FMath::Max(MaxInteriorImportance, Importance[i]);
+		}
+
+		// Seuils divisés par deux à chaque niveau ; au-delà de la moitié des points, la géométrie complète suffit
+		float Threshold = MaxInteriorImportance * 0.5f;
+		int32 PreviousCount = 0;
+		for (int32 LevelIndex = 0; LevelIndex < MaxLevels && Threshold > 0.0f; LevelIndex++, Threshold *= 0.5f)
+		{
+			FTrajectoryPathLodLevel Level;
+			TArray<int32> LevelPoints;
+			for (int32 i = 0; i < Count; i++)
+			{
+				if (Importance[i] > Threshold)
+				{
+					LevelPoints.Add(Chunk.FirstPoint + i);
+				}
+				else
+				{
+					Level.MaxError = FMath::Max(Level.MaxError, Importance[i]);
+				}
+			}
+
+			if (LevelPoints.Num() * 2 > Count)
+			{
+				break;
+			}
+			if (LevelPoints.Num() == PreviousCount)
+			{
+				continue;
+			}
+
+			PreviousCount = LevelPoints.Num();
+			Level.NumSegments = LevelPoints.Num() - 1;
+			Chunk.Levels.Add(Level);
+			OutLevelPoints.Add(MoveTemp(LevelPoints));
+		}
+	}
+}
+
+void FTrajectoryPathGeometry::BuildLevelsOfDetail()
+{
+	Chunks.Reset();
+	LineIndices.Reset();
+
+	const int32 Count = Points.Num();
+	if (Count < 2)
+	{
+		return;
+	}
+
+	// Tronçons de ChunkSize segments partageant leurs extrémités
+	const int32 SegmentCount = Count - 1;
+	const int32 ChunkCount = FMath::DivideAndRoundUp(SegmentCount, TrajectoryPathLod::ChunkSize);
+	Chunks.SetNum(ChunkCount);
+	for (int32 ChunkIndex = 0; ChunkIndex < ChunkCount; ChunkIndex++)
+	{
+		Chunks[ChunkIndex].FirstPoint = ChunkIndex * TrajectoryPathLod::ChunkSize;
+		Chunks[ChunkIndex].LastPoint = FMath::Min((ChunkIndex + 1) * TrajectoryPathLod::ChunkSize, SegmentCount);
+	}
+
+	TArray<TArray<TArray<int32>>> LevelPoints;
+	LevelPoints.SetNum(ChunkCount);
+	ParallelFor(ChunkCount, [this, &LevelPoints](int32 ChunkIndex)
+		{
+			TrajectoryPathLod::BuildChunkLevels(Points, Chunks[ChunkIndex], LevelPoints[ChunkIndex]);
+		});
+
+	// Segments complets de tous les tronçons, puis chaque niveau dans l'ordre des tronçons
+	int32 TotalSegments = SegmentCount;
+	for (const FTrajectoryPathChunk& Chunk : Chunks)
+	{
+		for (const FTrajectoryPathLodLevel& Level : Chunk.Levels)
+		{
+			TotalSegments += Level.NumSegments;
+		}
+	}
+	LineIndices.Reserve(TotalSegments * 2);
+
+	for (FTrajectoryPathChunk& Chunk : Chunks)
+	{
+		Chunk.FirstIndex = LineIndices.Num();
+		for (int32 i = Chunk.FirstPoint; i < Chunk.LastPoint; i++)
+		{
+			LineIndices.Add(i);
+			LineIndices.Add(i + 1);
+		}
+	}
+
+	for (int32 LevelIndex = 0; LevelIndex < TrajectoryPathLod::MaxLevels; LevelIndex++)
+	{
+		for (int32 ChunkIndex = 0; ChunkIndex < ChunkCount; ChunkIndex++)
+		{
+			FTrajectoryPathChunk& Chunk = Chunks[ChunkIndex];
+			if (!Chunk.Levels.IsValidIndex(LevelIndex))
+			{
+				continue;
+			}
+
+			const TArray<int32>& Kept = LevelPoints[ChunkIndex][LevelIndex];
+			Chunk.Levels[LevelIndex].FirstIndex = LineIndices.Num();
+			for (int32 i = 1; i < Kept.Num(); i++)
+			{
+				LineIndices.Add(Kept[i - 1]);
+				LineIndices.Add(Kept[i]);
+			}
+		}
+	}
+}
+
+// ========== PROXY DE RENDU ==========
+
+/**
+ * Proxy de rendu de la trajectoire : sommets et indices de tous les niveaux envoyés une fois au GPU,
+ * puis une liste de lignes par vue dont les éléments sont les plages d'indices des niveaux choisis
+ */
+class FTrajectoryPathSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+	FTrajectoryPathSceneProxy(const UTrajectoryPathComponent* InComponent)
+		: FPrimitiveSceneProxy(InComponent)
+		, Geometry(InComponent->GetPathGeometry())
+		, VertexFactory(GetScene().GetFeatureLevel(), "FTrajectoryPathSceneProxy")
+		, IndexBuffer(false)
+		, LineColor(InComponent->LineColor.ToFColor(true))
+	{
+		bWillEverBeLit = false;
+
+		// Copies temporaires, libérées après l'envoi au GPU
+		const TArray<FVector3f>& Points = Geometry->Points;
+		VertexBuffers.PositionVertexBuffer.Init(Points, false);
+		VertexBuffers.StaticMeshVertexBuffer.Init(Points.Num(), 1, false);
+		for (int32 i = 0; i < Points.Num(); i++)
+		{
+			VertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(i, FVector3f::ForwardVector, FVector3f::RightVector, FVector3f::UpVector);
+			VertexBuffers.StaticMeshVertexBuffer.SetVertexUV(i, 0, FVector2f::ZeroVector);
+		}
+		VertexBuffers.ColorVertexBuffer.InitFromSingleColor(FColor::White, Points.Num(), false);
+		IndexBuffer.SetIndices(Geometry->LineIndices, EIndexBufferStride::AutoDetect);
+	}
+
+	virtual ~FTrajectoryPathSceneProxy()
+	{
+		VertexBuffers.PositionVertexBuffer.ReleaseResource();
+		VertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+		VertexBuffers.ColorVertexBuffer.ReleaseResource();
+		IndexBuffer.ReleaseResource();
+		VertexFactory.ReleaseResource();
+	}
+
+	virtual SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+	virtual void CreateRenderThreadResources(FRHICommandListBase& RHICmdList) override
+	{
+		LLM_SCOPE_BYTAG(DataReplay_Geometry);
+
+		VertexBuffers.PositionVertexBuffer.InitResource(RHICmdList);
+		VertexBuffers.StaticMeshVertexBuffer.InitResource(RHICmdList);
+		VertexBuffers.ColorVertexBuffer.InitResource(RHICmdList);
+		IndexBuffer.InitResource(RHICmdList);
+
+		FLocalVertexFactory::FDataType Data;
+		VertexBuffers.PositionVertexBuffer.BindPositionVertexBuffer(&VertexFactory, Data);
+		VertexBuffers.StaticMeshVertexBuffer.BindTangentVertexBuffer(&VertexFactory, Data);
+		VertexBuffers.StaticMeshVertexBuffer.BindPackedTexCoordVertexBuffer(&VertexFactory, Data);
+		VertexBuffers.StaticMeshVertexBuffer.BindLightMapVertexBuffer(&VertexFactory, Data, 0);
+		VertexBuffers.ColorVertexBuffer.BindColorVertexBuffer(&VertexFactory, Data);
+		VertexFactory.SetData(RHICmdList, Data);
+		VertexFactory.InitResource(RHICmdList);
+	}
+
+	void SetLineColor_RenderThread(const FLinearColor& InColor)
+	{
+		LineColor = InColor;
+	}
+
+	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+	{
+		if (!Geometry.IsValid() || Geometry->Points.Num() < 2 || GEngine->LevelColorationUnlitMaterial == nullptr)
+		{
+			return;
+		}
+
+		SCOPE_CYCLE_COUNTER(STAT_DataReplay_DrawPathRT);
+
+		const FMatrix& LocalToWorld = GetLocalToWorld();
+		const float ErrorPixels = CVarTrajectoryPathLODErrorPixels.GetValueOnRenderThread();
+		const int32 NumVertices = Geometry->Points.Num();
+
+		FColoredMaterialRenderProxy* MaterialProxy = new FColoredMaterialRenderProxy(GEngine->LevelColorationUnlitMaterial->GetRenderProxy(), LineColor);
+		Collector.RegisterOneFrameMaterialProxy(MaterialProxy);
+
+		// Plage de segments dans l'index buffer
+		struct FIndexRange
+		{
+			int32 FirstIndex;
+			int32 NumSegments;
+		};
+		TArray<FIndexRange, TInlineAllocator<16>> Ranges;
+
+		for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+		{
+			if (!(VisibilityMap & (1 << ViewIndex)))
+			{
+				continue;
+			}
+
+			const FSceneView* View = Views[ViewIndex];
+
+			// Taille d'un pixel dans le monde : à distance 1 en perspective, constante en orthographique
+			const double ProjectionScale = View->ViewMatrices.GetProjectionMatrix().M[1][1] * FMath::Max(View->UnscaledViewRect.Height(), 1);
+			const double WorldPerPixel = ProjectionScale > UE_SMALL_NUMBER ? 2.0 / ProjectionScale : 0.0;
+			const bool bPerspective = View->IsPerspectiveProjection();
+			const FVector ViewOrigin = View->ViewMatrices.GetViewOrigin();
+
+			int32 VerticesDrawn = 0;
+			int32 SegmentsDrawn = 0;
+			Ranges.Reset();
+			for (const FTrajectoryPathChunk& Chunk : Geometry->Chunks)
+			{
+				// Tolérance du tronçon, mesurée à son point le plus proche de la vue
+				const FTrajectoryPathLodLevel* Level = nullptr;
+				if (ErrorPixels > 0.0f && Chunk.Levels.Num() > 0)
+				{
+					const double Distance = bPerspective ? FMath::Sqrt(Chunk.Bounds.TransformBy(LocalToWorld).ComputeSquaredDistanceToPoint(ViewOrigin)) : 1.0;
+					const double Tolerance = ErrorPixels * WorldPerPixel * Distance;
+					for (const FTrajectoryPathLodLevel& Candidate : Chunk.Levels)
+					{
+						if (Candidate.MaxError <= Tolerance)
+						{
+							Level = &Candidate;
+							break;
+						}
+					}
+				}
+
+				const int32 FirstIndex = Level ? Level->FirstIndex : Chunk.FirstIndex;
+				const int32 NumSegments = Level ? Level->NumSegments : Chunk.LastPoint - Chunk.FirstPoint;
+
+				// Le tronçon précédent au même niveau se termine juste avant : une seule plage
+				if (Ranges.Num() > 0 && Ranges.Last().FirstIndex + Ranges.Last().NumSegments * 2 == FirstIndex)
+				{
+					Ranges.Last().NumSegments += NumSegments;
+				}
+				else
+				{
+					Ranges.Add({ FirstIndex, NumSegments });
+				}
+
+				VerticesDrawn += NumSegments + 1;
+				SegmentsDrawn += NumSegments;
+			}
+
+			for (int32 FirstRange = 0; FirstRange < Ranges.Num(); FirstRange += TrajectoryPathLod::MaxBatchElements)
+			{
+				const int32 NumElements = FMath::Min(Ranges.Num() - FirstRange, TrajectoryPathLod::MaxBatchElements);
+
+				FMeshBatch& Mesh = Collector.AllocateMesh();
+				Mesh.VertexFactory = &VertexFactory;
+				Mesh.MaterialRenderProxy = MaterialProxy;
+				Mesh.Type = PT_LineList;
+				Mesh.DepthPriorityGroup = SDPG_World;
+				Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+				Mesh.CastShadow = false;
+				Mesh.bCanApplyViewModeOverrides = false;
+				Mesh.Elements.SetNum(NumElements);
+
+				for (int32 ElementIndex = 0; ElementIndex < NumElements; ElementIndex++)
+				{
+					const FIndexRange& Range = Ranges[FirstRange + ElementIndex];
+					FMeshBatchElement& Element = Mesh.Elements[ElementIndex];
+					Element.IndexBuffer = &IndexBuffer;
+					Element.FirstIndex = Range.FirstIndex;
+					Element.NumPrimitives = Range.NumSegments;
+					Element.MinVertexIndex = 0;
+					Element.MaxVertexIndex = NumVertices - 1;
+					Element.PrimitiveUniformBuffer = GetUniformBuffer();
+				}
+
+				Collector.AddMesh(ViewIndex, Mesh);
+			}
+
+			INC_DWORD_STAT_BY(STAT_TrajectoryPathVerticesDrawn, VerticesDrawn);
+			INC_DWORD_STAT_BY(STAT_TrajectoryPathVerticesTotal, NumVertices);
+			INC_DWORD_STAT_BY(STAT_DataReplay_SegmentsDrawn, SegmentsDrawn);
+			TrajectoryPathLod::AddSegmentsDrawn(SegmentsDrawn);
+		}
+	}
+
+	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+	{
+		FPrimitiveViewRelevance Result;
+		Result.bDrawRelevance = IsShown(View);
+		Result.bDynamicRelevance = true;
+		Result.bShadowRelevance = false;
+		Result.bRenderInMainPass = ShouldRenderInMainPass();
+		Result.bOpaque = true;
+		return Result;
+	}
+
+	virtual uint32 GetMemoryFootprint() const override
+	{
+		return sizeof(*this) + GetAllocatedSize();
+	}
+
+private:
+	// Géométrie partagée avec le composant (jamais modifiée après publication)
+	TSharedPtr<const FTrajectoryPathGeometry, ESPMode::ThreadSafe> Geometry;
+
+	// Points de la géométrie et indices de tous les niveaux, résidents sur le GPU
+	FStaticMeshVertexBuffers VertexBuffers;
+	FLocalVertexFactory VertexFactory;
+	FRawStaticIndexBuffer IndexBuffer;
+
+	FLinearColor LineColor;
+};
+
+// ========== COMPOSANT ==========
+
+UTrajectoryPathComponent::UTrajectoryPathComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// Les points sont en coordonnées monde : le composant ne suit pas l'acteur qui se déplace
+	SetUsingAbsoluteLocation(true);
+	SetUsingAbsoluteRotation(true);
+	SetUsingAbsoluteScale(true);
+
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(false);
+	CastShadow = false;
+	bUseAsOccluder = false;
+
+	LineColor = FLinearColor(0.0f, 1.0f, 0.0f, 1.0f);
+	LineThickness = 5.0f;
+}
+
+void UTrajectoryPathComponent::SetPathPoints(const FTrajectorySampleBuffer& Samples)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TrajectoryPath::SetPathPoints);
+	LLM_SCOPE_BYTAG(DataReplay_Geometry);
+
+	TSharedRef<FTrajectoryPathGeometry, ESPMode::ThreadSafe> NewGeometry = MakeShared<FTrajectoryPathGeometry, ESPMode::ThreadSafe>();
+
+	const int32 Count = Samples.Num();
+	NewGeometry->Points.SetNumUninitialized(Count);
+	for (int32 i = 0; i < Count; i++)
+	{
+		const FVector3f Point(Samples.PosX[i], Samples.PosY[i], Samples.PosZ[i]);
+		NewGeometry->Points[i] = Point;
+		NewGeometry->Bounds += FVector(Point);
+	}
+	NewGeometry->BuildLevelsOfDetail();
+
+	// Le proxy est recréé avec la nouvelle géométrie
+	PathGeometry = NewGeometry;
+	UpdateBounds();
+	MarkRenderStateDirty();
+}
+
+void UTrajectoryPathComponent::ClearPath()
+{
+	PathGeometry.Reset();
+	UpdateBounds();
+	MarkRenderStateDirty();
+}
+
+void UTrajectoryPathComponent::SetLineStyle(FLinearColor InColor, float InThickness)
+{
+	LineColor = InColor;
+	if (LineThickness != InThickness)
+	{
+		LineThickness = InThickness;
+		UpdateBounds();
+		MarkRenderTransformDirty();
+	}
+
+	// Couleur du matériau changée directement dans le proxy existant, sans renvoyer les buffers au GPU
+	if (FTrajectoryPathSceneProxy* PathProxy = static_cast<FTrajectoryPathSceneProxy*>(SceneProxy))
+	{
+		const FLinearColor ProxyColor(InColor.ToFColor(true));
+		ENQUEUE_RENDER_COMMAND(UpdateTrajectoryPathStyle)(
+			[PathProxy, ProxyColor](FRHICommandListImmediate& RHICmdList)
+			{
+				PathProxy->SetLineColor_RenderThread(ProxyColor);
+			});
+	}
+}
+
+int32 UTrajectoryPathComponent::GetNumPathPoints() const
+{
+	return PathGeometry.IsValid() ? PathGeometry->Points.Num() : 0;
+}
+
+FPrimitiveSceneProxy* UTrajectoryPathComponent::CreateSceneProxy()
+{
+	if (!PathGeometry.IsValid() || PathGeometry->Points.Num() < 2)
+	{
+		return nullptr;
+	}
+	return new FTrajectoryPathSceneProxy(this);
+}
+
+FBoxSphereBounds UTrajectoryPathComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (!PathGeometry.IsValid() || !PathGeometry->Bounds.IsValid)
+	{
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.0f);
+	}
+
+	// Marge LineThickness autour des points
+	return FBoxSphereBounds(PathGeometry->Bounds.ExpandBy(LineThickness)).TransformBy(LocalToWorld);
+}
+
+void UTrajectoryPathComponent::GetUsedMaterials(TArray<UMaterialInterface*>& OutMaterials, bool bGetDebugMaterials) const
+{
+	// Matériau non éclairé coloré par le proxy
+	if (GEngine && GEngine->LevelColorationUnlitMaterial)
+	{
+		OutMaterials.Add(GEngine->LevelColorationUnlitMaterial);
+	}
+}
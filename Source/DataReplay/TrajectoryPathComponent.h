@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "TrajectoryPathComponent.generated.h"
+
+struct FTrajectorySampleBuffer;
+
+/**
+ * Niveau simplifié d'un tronçon de trajectoire
+ */
+struct FTrajectoryPathLodLevel
+{
+	// Écart maximal (unités du monde) entre ce niveau et les points complets du tronçon
+	float MaxError = 0.0f;
+
+	// Segments du niveau dans FTrajectoryPathGeometry::LineIndices (deux indices par segment)
+	int32 FirstIndex = 0;
+	int32 NumSegments = 0;
+};
+
+/**
+ * Tronçon de trajectoire : plage de points consécutifs et sa hiérarchie Douglas-Peucker
+ * Deux tronçons voisins partagent leur point d'extrémité pour que la ligne reste continue
+ */
+struct FTrajectoryPathChunk
+{
+	int32 FirstPoint = 0;
+	int32 LastPoint = 0;
+
+	// Segments complets du tronçon dans FTrajectoryPathGeometry::LineIndices
+	int32 FirstIndex = 0;
+
+	// Boîte englobante des points du tronçon
+	FBox Bounds = FBox(ForceInit);
+
+	// Niveaux simplifiés, du plus grossier au plus fin (la géométrie complète n'y figure pas)
+	TArray<FTrajectoryPathLodLevel> Levels;
+};
+
+/**
+ * Géométrie d'une trajectoire, partagée sans copie entre le composant et son proxy de rendu
+ */
+struct FTrajectoryPathGeometry
+{
+	// Points de la trajectoire, dans l'espace du composant
+	TArray<FVector3f> Points;
+
+	// Boîte englobante des points
+	FBox Bounds = FBox(ForceInit);
+
+	// Découpage en tronçons pour le niveau de détail, choisi tronçon par tronçon selon sa distance à la vue
+	TArray<FTrajectoryPathChunk> Chunks;
+
+	// Liste de lignes de tous les niveaux : segments complets de chaque tronçon, puis chaque niveau simplifié
+	// tronçon par tronçon, si bien que des tronçons voisins au même niveau forment une seule plage
+	TArray<uint32> LineIndices;
+
+	// Construire les tronçons, leurs niveaux simplifiés et la liste de lignes à partir des points
+	void BuildLevelsOfDetail();
+};
+
+/**
+ * Composant de rendu persistant de la ligne de trajectoire
+ * Les points et les indices de tous les niveaux sont envoyés une seule fois au GPU par le proxy de rendu ;
+ * chaque vue ne soumet ensuite qu'une liste de lignes (une plage d'indices par suite de tronçons au même niveau).
+ * Chaque tronçon dessine le niveau simplifié dont l'erreur projetée reste sous
+ * DataReplay.PathLOD.ErrorPixels (les gros plans restent exacts).
+ */
+UCLASS(ClassGroup = (Rendering), meta = (BlueprintSpawnableComponent))
+class DATAREPLAY_API UTrajectoryPathComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTrajectoryPathComponent();
+
+	// Couleur de la ligne
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trajectory Path")
+	FLinearColor LineColor;
+
+	// Obsolète comme largeur : la liste de lignes est dessinée sur un pixel de large, la valeur n'est qu'une marge des bornes (unités du monde)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trajectory Path", meta = (DeprecatedProperty, DeprecationMessage = "The path is drawn as a one-pixel GPU line list; thickness only pads the bounds."))
+	float LineThickness;
+
+	// Reconstruire la géométrie depuis les échantillons
+	void SetPathPoints(const FTrajectorySampleBuffer& Samples);
+
+	// Supprimer la géométrie
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Path")
+	void ClearPath();
+
+	// Changer la couleur et la marge des bornes sans reconstruire la géométrie
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Path")
+	void SetLineStyle(FLinearColor InColor, float InThickness);
+
+	// Nombre de points de la géométrie actuelle
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Path")
+	int32 GetNumPathPoints() const;
+
+	TSharedPtr<const FTrajectoryPathGeometry, ESPMode::ThreadSafe> GetPathGeometry() const { return PathGeometry; }
+
+	// ========== UPRIMITIVECOMPONENT ==========
+
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	virtual void GetUsedMaterials(TArray<UMaterialInterface*>& OutMaterials, bool bGetDebugMaterials = false) const override;
+
+private:
+	// Géométrie courante (immuable une fois publiée)
+	TSharedPtr<const FTrajectoryPathGeometry, ESPMode::ThreadSafe> PathGeometry;
+};
@@ -1,7 +1,22 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "TrajectoryReplayActor.h"
+#include "DataReplay.h"
 #include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UObject/ConstructorHelpers.h"
+#include "TrajectoryAsset.h"
+#include "TrajectoryPathComponent.h"
+#include "TrajectoryReplaySubsystem.h"
+#include "TrajectoryPagedSource.h"
+#include "TrajectoryLiveReceiver.h"
+#include "Misc/Paths.h"
+
+// Paramtre de couleur de BasicShapeMaterial, utilis quand WaypointMaterial n'est pas dfini
+static const FName WaypointColorParameterName(TEXT("Color"));
 
 // ========== CONSTRUCTEUR ==========
 
@@ -14,15 +29,108 @@ ATrajectoryReplayActor::ATrajectoryReplayActor()
 	VisualizationMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("VisualizationMesh"));
 	RootComponent = VisualizationMesh;
 
+	// Crer le composant de rendu de la trajectoire (cach tant que bShowTrajectory est faux)
+	TrajectoryPathComponent = CreateDefaultSubobject<UTrajectoryPathComponent>(TEXT("TrajectoryPath"));
+	TrajectoryPathComponent->SetupAttachment(RootComponent);
+	TrajectoryPathComponent->SetVisibility(false);
+
+	// Crer le composant instanci des waypoints (coordonnes monde, comme la trajectoire)
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> WaypointSphere(TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+	WaypointMarkers = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("WaypointMarkers"));
+	WaypointMarkers->SetupAttachment(RootComponent);
+	WaypointMarkers->SetUsingAbsoluteLocation(true);
+	WaypointMarkers->SetUsingAbsoluteRotation(true);
+	WaypointMarkers->SetUsingAbsoluteScale(true);
+	WaypointMarkers->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	WaypointMarkers->SetGenerateOverlapEvents(false);
+	WaypointMarkers->SetCastShadow(false);
+	WaypointMarkers->SetCanEverAffectNavigation(false);
+	WaypointMarkers->NumCustomDataFloats = 3;
+	WaypointMarkers->SetVisibility(false);
+	if (WaypointSphere.Succeeded())
+	{
+		WaypointMarkers->SetStaticMesh(WaypointSphere.Object);
+	}
+
 	// Valeurs par dfaut des paramtres
+	TrajectorySource = ETrajectorySourceType::DataTable;
 	PlaybackSpeed = 1.0f;
 	bAutoPlay = false;
 	bIsPlaying = false;
 	bLoopPlayback = false;
 	bReversePlayback = false;
+	InterpolationMode = ETrajectoryInterpolationMode::Linear;
+	bConstantSpeed = false;
+	ResampleRate = 0.0f;
+	bUseReplaySubsystem = true;
 	CurrentPlaybackTime = 0.0f;
 	TotalDuration = 0.0f;
 	WaypointCount = 0;
+	CachedSegmentIndex = 0;
+	CachedChannelTime = 0.0f;
+	bChannelLocationValid = false;
+	bInterpolationCurveDirty = true;
+	CachedArcStepIndex = 0;
+	bResampleCacheDirty = true;
+	AppliedResampleRate = 0.0f;
+	AppliedResampleMode = ETrajectoryInterpolationMode::Linear;
+	ResampleMaxError = 0.0f;
+	ResampleMemoryKB = 0.0f;
+	bComputeKinematics = true;
+	KinematicSmoothingWindow = 0.0f;
+	bOrientAlongPath = false;
+	bKinematicsDirty = true;
+	AppliedKinematicSmoothing = 0.0f;
+	CachedKinematicIndex = 0;
+	CurrentSpeed = 0.0f;
+	CurrentAcceleration = 0.0f;
+	CurrentHeading = 0.0f;
+	CurrentPitch = 0.0f;
+	DistanceTravelled = 0.0f;
+	LoadState = ETrajectoryLoadState::Unloaded;
+	LoadProgress = 0.0f;
+	LoadStartTime = 0.0;
+	bPlayWhenReady = false;
+	bRegisteredWithSubsystem = false;
+
+	// Valeurs par dfaut du chargement
+	bAsyncLoading = true;
+	StreamingStartDuration = 2.0f;
+	bBatchLoading = false;
+	BatchMissionIndex = INDEX_NONE;
+	PagingMemoryBudgetMB = 64.0f;
+	PagingPrefetchSeconds = 30.0f;
+	PagingHits = 0;
+	PagingMisses = 0;
+	PagingResidentMB = 0.0f;
+	LivePort = 7777;
+	LiveQueueCapacity = 65536;
+	LiveRefreshInterval = 0.5f;
+	bFollowLiveHead = true;
+	LiveDelay = 0.1f;
+	ScrubSettleDelay = 0.15f;
+	bIsScrubbing = false;
+	bScrubTargetPending = false;
+	ScrubTargetTime = 0.0f;
+	bScrubPreviewShown = false;
+	LastScrubInputTime = 0.0;
+	LiveSamplesReceived = 0;
+	LiveSamplesDropped = 0;
+	LastGrowthRefreshTime = 0.0;
+	LiveOutOfOrderCount = 0;
+	bWatchFile = false;
+	WatchPollInterval = 0.25f;
+	WatchReorderWindow = 1024;
+	bUseGeoOrigin = false;
+	bShareGeoOrigin = true;
+	WatchSamplesDropped = 0;
+	LastTailPollTime = 0.0;
+	BroadcastPlaybackTime = 0.0f;
+	BroadcastTotalDuration = 0.0f;
+	bBroadcastIsPlaying = false;
+	bBroadcastShowTrajectory = false;
+	ReportedResidentSamples = 0;
+	TrajectoryDataRevision = 0;
 
 	// Valeurs par dfaut de la visualisation
 	bShowTrajectory = false;
@@ -30,6 +138,42 @@ ATrajectoryReplayActor::ATrajectoryReplayActor()
 	TrajectoryThickness = 5.0f;
 	bShowWaypoints = false;
 	WaypointRadius = 10.0f;
+	bColorWaypointsByTime = false;
+	WaypointEndColor = FLinearColor(1.0f, 0.0f, 0.0f, 1.0f); // Rouge par dfaut
+	WaypointMaterial = nullptr;
+	WaypointFallbackMaterial = nullptr;
+	bTrajectoryPathDirty = true;
+	AppliedTrajectoryColor = TrajectoryColor;
+	AppliedTrajectoryThickness = TrajectoryThickness;
+	bWaypointMarkersDirty = true;
+	AppliedWaypointRadius = WaypointRadius;
+	AppliedWaypointStartColor = TrajectoryColor;
+	AppliedWaypointEndColor = WaypointEndColor;
+	bAppliedColorWaypointsByTime = bColorWaypointsByTime;
+}
+
+namespace TrajectoryReplayStats
+{
+	// Dplacements dans la timeline depuis la dernire publication du compteur Insights
+	static int32 SeeksInWindow = 0;
+	static double SeekWindowStart = 0.0;
+
+	// Compter des dplacements et publier leur frquence au plus une fois par seconde (thread de jeu)
+	static void CountSeeks(int32 NewSeeks)
+	{
+		INC_DWORD_STAT_BY(STAT_DataReplay_Seeks, NewSeeks);
+#if COUNTERSTRACE_ENABLED
+		SeeksInWindow += NewSeeks;
+		const double Now = FPlatformTime::Seconds();
+		const double Elapsed = Now - SeekWindowStart;
+		if (Elapsed >= 1.0)
+		{
+			TRACE_COUNTER_SET(DataReplay_SeeksPerSecond, SeekWindowStart > 0.0 ? FMath::RoundToInt64(SeeksInWindow / Elapsed) : 0);
+			SeeksInWindow = 0;
+			SeekWindowStart = Now;
+		}
+#endif
+	}
 }
 
 // ========== VNEMENTS DU CYCLE DE VIE ==========
@@ -38,28 +182,111 @@ void ATrajectoryReplayActor::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Charger les points de trajectoire depuis le DataTable
-	LoadTrajectoryPoints();
+	INC_DWORD_STAT(STAT_DataReplay_ActiveActors);
+	TRACE_COUNTER_INCREMENT(DataReplay_ActiveActors);
+
+	// Confier le Tick au sous-systme de relecture si demand
+	SetUseReplaySubsystem(bUseReplaySubsystem);
+
+	// Charger les points de trajectoire depuis la source configure (sauf s'ils ont t fournis avant BeginPlay)
+	if (LoadState != ETrajectoryLoadState::Loaded)
+	{
+		LoadTrajectoryPoints();
+	}
 
 	// Log d'information
-	UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Actor initialized with %d waypoints, Total Duration: %.2f seconds"),
-		WaypointCount, TotalDuration);
+	if (IsTrajectoryLoading())
+	{
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Actor initialized, trajectory loading in background"));
+	}
+	else
+	{
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Actor initialized with %d waypoints, Total Duration: %.2f seconds"),
+			WaypointCount, TotalDuration);
+	}
 
-	// Dmarrage automatique si activ
-	if (bAutoPlay && WaypointCount > 0)
+	// Dmarrage automatique si activ (diffr jusqu' ce que le dbut de la trajectoire soit charg)
+	if (bAutoPlay && (WaypointCount > 0 || IsTrajectoryLoading()))
 	{
 		Play();
 	}
 }
 
+void ATrajectoryReplayActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// La tche de fond lit les objets source : l'arrter avant de les librer
+	CancelAsyncLoad();
+	PagedSource.Reset();
+	StopGrowingSources();
+	ReportResidentSamples(0);
+
+	DEC_DWORD_STAT(STAT_DataReplay_ActiveActors);
+	TRACE_COUNTER_DECREMENT(DataReplay_ActiveActors);
+
+	// Ne plus tre pilot par le sous-systme
+	if (bRegisteredWithSubsystem)
+	{
+		if (UTrajectoryReplaySubsystem* Subsystem = GetWorld()->GetSubsystem<UTrajectoryReplaySubsystem>())
+		{
+			Subsystem->UnregisterActor(this);
+		}
+		bRegisteredWithSubsystem = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ATrajectoryReplayActor::Tick(float DeltaTime)
 {
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Tick);
 	Super::Tick(DeltaTime);
 
-	// Dessiner la trajectoire si active
-	if (bShowTrajectory)
+	if (AdvancePlayback(DeltaTime))
+	{
+		// Mettre  jour la position de l'acteur
+		UpdateActorPosition();
+	}
+
+	BroadcastStateChanges();
+}
+
+bool ATrajectoryReplayActor::AdvancePlayback(float DeltaTime)
+{
+	TrajectoryReplayStats::CountSeeks(0);
+
+	// Intgrer les donnes charges en arrire-plan
+	if (ActiveLoader.IsValid())
+	{
+		PumpAsyncLoad();
+	}
+
+	// Intgrer les chantillons reus en direct
+	if (LiveReceiver.IsValid())
+	{
+		PumpLiveSamples();
+	}
+
+	// Intgrer les lignes ajoutes au fichier suivi
+	if (TailReader.IsValid())
+	{
+		PumpTailReader();
+	}
+
+	// Afficher ou mettre  jour la trajectoire si ncessaire
+	UpdateTrajectoryVisualization();
+
+	// Pendant un dplacement dans la timeline, le temps n'avance pas : la position suit le curseur
+	if (bIsScrubbing)
+	{
+		UpdateScrub();
+		return false;
+	}
+
+	// Suivre le direct, avec un lger retard pour toujours avoir un segment  interpoler
+	if (LiveReceiver.IsValid() && bFollowLiveHead && WaypointCount > 0)
 	{
-		DrawTrajectoryVisualization();
+		CurrentPlaybackTime = FMath::Max(TrajectorySamples.GetStartTime(), TotalDuration - LiveDelay);
+		return true;
 	}
 
 	// Vrifier si la lecture est active
@@ -78,7 +305,18 @@ void ATrajectoryReplayActor::Tick(float DeltaTime)
 		// Grer les conditions de boucle et de fin
 		if (CurrentPlaybackTime > TotalDuration)
 		{
-			if (bLoopPlayback)
+			if (IsTrajectoryLoading() || TailReader.IsValid())
+			{
+				// Attendre la suite de la trajectoire (chargement, ou lignes suivantes du fichier suivi)
+				CurrentPlaybackTime = TotalDuration;
+			}
+			else if (LiveReceiver.IsValid())
+			{
+				// L'historique a rattrap le direct : le suivre  nouveau
+				CurrentPlaybackTime = TotalDuration;
+				bFollowLiveHead = true;
+			}
+			else if (bLoopPlayback)
 			{
 				// Recommencer depuis le dbut
 				CurrentPlaybackTime = 0.0f;
@@ -88,7 +326,7 @@ void ATrajectoryReplayActor::Tick(float DeltaTime)
 				// Arrter  la fin
 				CurrentPlaybackTime = TotalDuration;
 				Pause();
-				UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Playback completed"));
+				UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Playback completed"));
 			}
 		}
 		else if (CurrentPlaybackTime < 0.0f)
@@ -103,263 +341,1444 @@ void ATrajectoryReplayActor::Tick(float DeltaTime)
 				// Arrter au dbut
 				CurrentPlaybackTime = 0.0f;
 				Pause();
-				UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Reverse playback completed"));
+				UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Reverse playback completed"));
 			}
 		}
 
-		// Mettre  jour la position de l'acteur
-		UpdateActorPosition();
+		// La position peut ensuite tre value en parallle : la courbe, la grille et le tronon doivent tre prts
+		UpdateInterpolationCurve();
+		UpdateResampleCache();
+		UpdatePagedSource();
+		return true;
 	}
+
+	return false;
 }
 
 // ========== CHARGEMENT DES DONNES ==========
 
 void ATrajectoryReplayActor::LoadTrajectoryPoints()
 {
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Load);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+	// Abandonner un ventuel chargement en cours
+	CancelAsyncLoad();
+
 	// Rinitialiser les donnes
-	TrajectoryPoints.Empty();
+	TrajectorySamples.Reset();
+	TrajectoryDataRevision++;
+	PagedSource.Reset();
+	StopGrowingSources();
+	LiveOutOfOrderCount = 0;
+	LiveSamplesReceived = 0;
+	LiveSamplesDropped = 0;
+	WatchSamplesDropped = 0;
 	TotalDuration = 0.0f;
 	WaypointCount = 0;
+	CachedSegmentIndex = 0;
+	TrajectoryChannels.Reset();
+	TelemetryChannels.Reset();
+	GeoReference = FTrajectoryGeoReference();
+	LoadProgress = 0.0f;
+	LoadStartTime = FPlatformTime::Seconds();
 
-	// Vrifier que le DataTable est assign
-	if (TrajectoryData == nullptr)
+	FTrajectoryLoadRequest Request;
+	if (!MakeLoadRequest(Request))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[TrajectoryReplay] TrajectoryData is NULL! Please assign a DataTable in the editor."));
+		LoadState = ETrajectoryLoadState::Failed;
 		return;
 	}
 
-	// Rcuprer tous les noms de lignes du DataTable
-	TArray<FName> RowNames = TrajectoryData->GetRowNames();
-
-	// Charger chaque ligne
-	for (const FName& RowName : RowNames)
+	// Fichier GPS : repre choisi avant le chargement, commun au chargement complet et aux lectures du fichier suivi
+	// (origine configure, sinon repre partag du monde, sinon premier chantillon ; un journal encore vide
+	// prend son repre  la premire lecture, voir PumpTailReader)
+	if (Request.Source == ETrajectorySourceType::CsvFile)
 	{
-		FDroneWaypointRow* Row = TrajectoryData->FindRow<FDroneWaypointRow>(RowName, TEXT(""));
-		if (Row)
+		UTrajectoryReplaySubsystem* GeoSubsystem = GetSharedGeoOriginSubsystem();
+		if (bUseGeoOrigin)
 		{
-			TrajectoryPoints.Add(Row);
+			Request.GeoReference = FTrajectoryGeoReference(GeoOrigin);
+			GeoReference = Request.GeoReference;
+		}
+		else if (GeoSubsystem)
+		{
+			Request.GeoReference = GeoSubsystem->GetSharedGeoReference();
 		}
-	}
 
-	// Trier les points par temps (croissant)
-	TrajectoryPoints.Sort([](const FDroneWaypointRow& A, const FDroneWaypointRow& B)
+		FTrajectoryGeoPosition FileOrigin;
+		if (!bUseGeoOrigin && FTrajectoryCsvLoader::FindGeoOrigin(Request.FilePath, FileOrigin))
 		{
-			return A.Time < B.Time;
-		});
+			if (!Request.GeoReference.IsValid())
+			{
+				Request.GeoReference = FTrajectoryGeoReference(FileOrigin);
+				if (GeoSubsystem)
+				{
+					GeoSubsystem->ShareGeoReference(Request.GeoReference);
+				}
+			}
+			GeoReference = Request.GeoReference;
+		}
+	}
 
-	// Calculer les statistiques
-	WaypointCount = TrajectoryPoints.Num();
-	if (WaypointCount > 0)
+	// Fichier pagin : seuls l'en-tte et le premier tronon sont lus maintenant
+	if (Request.Source == ETrajectorySourceType::PagedFile)
+	{
+		PagedSource = FTrajectoryPagedSource::Open(Request.FilePath, static_cast<int64>(PagingMemoryBudgetMB * 1024.0 * 1024.0));
+		FinishLoad(PagedSource.IsValid());
+		UpdatePagedSource();
+		return;
+	}
+
+	// Direct : le buffer se remplit au fil de la rception (PumpLiveSamples)
+	if (Request.Source == ETrajectorySourceType::LiveUdp)
+	{
+		LiveReceiver = FTrajectoryLiveReceiver::Start(LivePort, LiveQueueCapacity);
+		LastGrowthRefreshTime = 0.0;
+		FinishLoad(LiveReceiver.IsValid());
+		return;
+	}
+
+	// Suivi d'un journal CSV : premire lecture puis lectures de la fin ajoute, toujours en tche de fond
+	if (Request.Source == ETrajectorySourceType::CsvFile && bWatchFile)
+	{
+		TailReader = MakeShared<FTrajectoryCsvTailReader>(Request.FilePath, Request.GeoReference);
+		LoadState = ETrajectoryLoadState::Loading;
+		LaunchTailRead();
+		OnDataReloaded.Broadcast();
+		return;
+	}
+
+	// Chargement group avec les autres acteurs du monde ; le sous-systme remet le rsultat (FinishBatchLoad)
+	UWorld* World = GetWorld();
+	UTrajectoryReplaySubsystem* Subsystem = World ? World->GetSubsystem<UTrajectoryReplaySubsystem>() : nullptr;
+	if (bAsyncLoading && bBatchLoading && Subsystem)
+	{
+		LoadState = ETrajectoryLoadState::Loading;
+		BatchMissionIndex = Subsystem->RequestBatchLoad(this, Request);
+		OnDataReloaded.Broadcast();
+		return;
+	}
+
+	// Chargement, tri et validation en arrire-plan ; les donnes arrivent via PumpAsyncLoad
+	if (bAsyncLoading)
 	{
-		TotalDuration = TrajectoryPoints.Last()->Time;
+		LoadState = ETrajectoryLoadState::Loading;
+		LastGrowthRefreshTime = 0.0;
+		ActiveLoader = FTrajectoryLoader::LaunchAsync(Request);
+		OnDataReloaded.Broadcast();
+		return;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Loaded %d waypoints from DataTable"), WaypointCount);
+	FinishLoad(FTrajectoryLoader::LoadSamples(Request, TrajectorySamples));
 }
 
-void ATrajectoryReplayActor::ReloadTrajectoryData()
+FString ATrajectoryReplayActor::ResolveProjectPath(const FString& Path)
 {
-	UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Reloading trajectory data..."));
-
-	bool bWasPlaying = bIsPlaying;
-	Stop();
+	return FPaths::IsRelative(Path) ? FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), Path) : Path;
+}
 
-	LoadTrajectoryPoints();
+bool ATrajectoryReplayActor::MakeLoadRequest(FTrajectoryLoadRequest& OutRequest) const
+{
+	OutRequest.Source = TrajectorySource;
 
-	if (bWasPlaying && bAutoPlay)
+	switch (TrajectorySource)
 	{
-		Play();
+	case ETrajectorySourceType::CsvFile:
+		if (TrajectoryFilePath.FilePath.IsEmpty())
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryReplay] TrajectoryFilePath is empty! Please select a CSV file."));
+			return false;
+		}
+
+		// Les chemins relatifs sont rsolus depuis le dossier du projet
+		OutRequest.FilePath = ResolveProjectPath(TrajectoryFilePath.FilePath);
+		return true;
+
+	case ETrajectorySourceType::PagedFile:
+		if (PagedFilePath.FilePath.IsEmpty())
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryReplay] PagedFilePath is empty! Please select a paged trajectory file."));
+			return false;
+		}
+		OutRequest.FilePath = ResolveProjectPath(PagedFilePath.FilePath);
+		return true;
+
+	case ETrajectorySourceType::LiveUdp:
+		return true;
+
+	case ETrajectorySourceType::Asset:
+		if (TrajectoryAsset == nullptr)
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryReplay] TrajectoryAsset is NULL! Please assign a Trajectory Asset in the editor."));
+			return false;
+		}
+		OutRequest.Asset = TrajectoryAsset;
+		return true;
+
+	case ETrajectorySourceType::DataTable:
+	default:
+		// Vrifier que le DataTable est assign
+		if (TrajectoryData == nullptr)
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryReplay] TrajectoryData is NULL! Please assign a DataTable in the editor."));
+			return false;
+		}
+		OutRequest.DataTable = TrajectoryData;
+		return true;
 	}
 }
 
-// ========== CALCUL DE POSITION ==========
-
-FVector ATrajectoryReplayActor::CalculatePositionAtTime(float Time) const
+void ATrajectoryReplayActor::PumpAsyncLoad()
 {
-	// Si aucun point n'est charg
-	if (WaypointCount == 0)
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Load);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+	// Lire l'tat avant de vider la file : tous les lots publis avant la fin seront reus
+	const bool bLoaderDone = ActiveLoader->IsDone();
+
+	// Ajouter le dbut de trajectoire dj disponible (lots tris, dans l'ordre)
+	FTrajectorySampleBuffer Batch;
+	bool bReceivedSamples = false;
+	while (ActiveLoader->DequeueStreamedBatch(Batch))
 	{
-		return FVector::ZeroVector;
+		TrajectorySamples.Append(Batch);
+		bReceivedSamples = true;
 	}
 
-	// Si un seul point
-	if (WaypointCount == 1)
+	// Seuls les compteurs suivent chaque lot : courbe et grille attendent FinishLoad, la gomtrie est limite  LiveRefreshInterval
+	if (bReceivedSamples)
 	{
-		return FVector(TrajectoryPoints[0]->X, TrajectoryPoints[0]->Y, TrajectoryPoints[0]->Z);
+		OnTrajectoryGrown();
 	}
+	LoadProgress = ActiveLoader->GetProgress();
 
-	// Si le temps est avant le premier point
-	if (Time <= TrajectoryPoints[0]->Time)
+	if (bLoaderDone)
 	{
-		return FVector(TrajectoryPoints[0]->X, TrajectoryPoints[0]->Y, TrajectoryPoints[0]->Z);
+		// Remplacer le buffer par le rsultat final, sauf s'il a dj t reu en entier
+		const bool bSucceeded = ActiveLoader->HasSucceeded();
+		if (bSucceeded && !ActiveLoader->IsStreamComplete())
+		{
+			ActiveLoader->TakeResult(TrajectorySamples);
+		}
+
+		ActiveLoader.Reset();
+		FinishLoad(bSucceeded);
 	}
 
-	// Si le temps est aprs le dernier point
-	if (Time >= TrajectoryPoints.Last()->Time)
+	// Dmarrer la lecture demande pendant le chargement
+	if (bPlayWhenReady && (!IsTrajectoryLoading() || CanStartStreamingPlayback()))
 	{
-		FDroneWaypointRow* LastPoint = TrajectoryPoints.Last();
-		return FVector(LastPoint->X, LastPoint->Y, LastPoint->Z);
+		bPlayWhenReady = false;
+		Play();
 	}
+}
 
-	// Trouver les deux points entre lesquels interpoler
-	for (int32 i = 0; i < WaypointCount - 1; i++)
+void ATrajectoryReplayActor::CancelAsyncLoad()
+{
+	if (ActiveLoader.IsValid())
 	{
-		FDroneWaypointRow* CurrentPoint = TrajectoryPoints[i];
-		FDroneWaypointRow* NextPoint = TrajectoryPoints[i + 1];
+		ActiveLoader->CancelAndWait();
+		ActiveLoader.Reset();
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Background loading cancelled"));
+	}
 
-		if (Time >= CurrentPoint->Time && Time <= NextPoint->Time)
+	if (BatchMissionIndex != INDEX_NONE)
+	{
+		UWorld* World = GetWorld();
+		if (UTrajectoryReplaySubsystem* Subsystem = World ? World->GetSubsystem<UTrajectoryReplaySubsystem>() : nullptr)
 		{
-			// Calculer le facteur d'interpolation linaire (0.0  1.0)
-			float TimeDelta = NextPoint->Time - CurrentPoint->Time;
-			float Alpha = (TimeDelta > 0.0f) ? (Time - CurrentPoint->Time) / TimeDelta : 0.0f;
+			Subsystem->CancelBatchLoad(BatchMissionIndex);
+		}
+		BatchMissionIndex = INDEX_NONE;
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Batch loading cancelled"));
+	}
+}
+
+void ATrajectoryReplayActor::FinishBatchLoad(bool bSucceeded, FTrajectorySampleBuffer&& InSamples)
+{
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+	BatchMissionIndex = INDEX_NONE;
+	TrajectorySamples = MoveTemp(InSamples);
+	CachedSegmentIndex = 0;
+	FinishLoad(bSucceeded);
+
+	// Dmarrer la lecture demande pendant le chargement
+	if (bPlayWhenReady)
+	{
+		bPlayWhenReady = false;
+		Play();
+	}
+}
+
+void ATrajectoryReplayActor::PumpLiveSamples()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Load);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
 
-			// Positions des deux points
-			FVector PosA(CurrentPoint->X, CurrentPoint->Y, CurrentPoint->Z);
-			FVector PosB(NextPoint->X, NextPoint->Y, NextPoint->Z);
+	FTrajectorySampleRing& Ring = LiveReceiver->GetRing();
+	const int32 PendingCount = Ring.Num();
+	const int32 OldCount = TrajectorySamples.Num();
 
-			// Interpolation linaire
-			return FMath::Lerp(PosA, PosB, Alpha);
+	if (PendingCount > 0)
+	{
+		// Agrandir les quatre colonnes ensemble et par doublement : peu de rallocations sur une longue mission
+		const int32 RequiredCount = OldCount + PendingCount;
+		if (RequiredCount > TrajectorySamples.Times.Max())
+		{
+			TrajectorySamples.Reserve(FMath::Max3(RequiredCount, OldCount * 2, 4096));
 		}
+
+		// Le buffer reste tri : un chantillon plus ancien que le dernier reu (UDP dsordonn) est ignor
+		float LastTime = (OldCount > 0) ? TrajectorySamples.GetEndTime() : -MAX_flt;
+		Ring.ConsumeAll(PendingCount, [this, &LastTime](const FTrajectoryLiveSample& Sample)
+			{
+				if (Sample.Time > LastTime)
+				{
+					TrajectorySamples.Add(Sample.Time, Sample.X, Sample.Y, Sample.Z);
+					LastTime = Sample.Time;
+				}
+				else
+				{
+					LiveOutOfOrderCount++;
+				}
+			});
 	}
 
-	// Cas par dfaut (ne devrait pas arriver)
-	return FVector::ZeroVector;
+	LiveSamplesReceived = LiveReceiver->GetReceivedCount();
+	LiveSamplesDropped = LiveReceiver->GetOverflowCount() + LiveReceiver->GetMalformedCount() + LiveOutOfOrderCount;
+
+	if (TrajectorySamples.Num() != OldCount)
+	{
+		OnTrajectoryGrown();
+	}
 }
 
-void ATrajectoryReplayActor::UpdateActorPosition()
+void ATrajectoryReplayActor::LaunchTailRead()
 {
-	FVector NewPosition = CalculatePositionAtTime(CurrentPlaybackTime);
-	SetActorLocation(NewPosition);
+	// La tche garde le lecteur en vie mme si l'acteur l'abandonne entre-temps
+	TSharedPtr<FTrajectoryCsvTailReader> Reader = TailReader;
+	TailReadTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Reader]()
+		{
+			return Reader->ReadNewLines();
+		},
+		UE::Tasks::ETaskPriority::BackgroundNormal);
 }
 
-// ========== CONTRLES DE LECTURE ==========
+UTrajectoryReplaySubsystem* ATrajectoryReplayActor::GetSharedGeoOriginSubsystem() const
+{
+	if (bUseGeoOrigin || !bShareGeoOrigin)
+	{
+		return nullptr;
+	}
+	const UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<UTrajectoryReplaySubsystem>() : nullptr;
+}
 
-void ATrajectoryReplayActor::Play()
+void ATrajectoryReplayActor::PumpTailReader()
 {
-	if (WaypointCount == 0)
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Load);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+	using EReadResult = FTrajectoryCsvTailReader::EReadResult;
+
+	if (TailReadTask.IsValid())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[TrajectoryReplay] Cannot play - no trajectory data loaded"));
-		return;
+		if (!TailReadTask.IsCompleted())
+		{
+			return;
+		}
+
+		const EReadResult Result = TailReadTask.GetResult();
+		TailReadTask = UE::Tasks::TTask<EReadResult>();
+		LastTailPollTime = FPlatformTime::Seconds();
+
+		switch (Result)
+		{
+		case EReadResult::Appended:
+		{
+			// Seuls les nouveaux chantillons et la fentre de tri sont touchs
+			FTrajectorySampleBuffer NewSamples;
+			TailReader->TakeSamples(NewSamples);
+
+			// Journal GPS encore vide au chargement : le repre est celui que le lecteur vient de rsoudre
+			if (!GeoReference.IsValid() && TailReader->GetGeoReference().IsValid())
+			{
+				GeoReference = TailReader->GetGeoReference();
+				if (UTrajectoryReplaySubsystem* GeoSubsystem = GetSharedGeoOriginSubsystem())
+				{
+					GeoSubsystem->ShareGeoReference(GeoReference);
+				}
+			}
+			WatchSamplesDropped += TrajectorySamples.AppendWithReorderWindow(NewSamples, WatchReorderWindow);
+			TrajectoryDataRevision++;
+			if (!IsTrajectoryLoading())
+			{
+				OnTrajectoryGrown();
+			}
+			break;
+		}
+
+		case EReadResult::Truncated:
+			// Fichier remplac ou tronqu : tout relire
+			UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] %s shrank, reading it again"), *TailReader->GetFilePath());
+			TailReader->Restart();
+			TrajectorySamples.Reset();
+			CachedSegmentIndex = 0;
+			RefreshTrajectoryStats();
+			ClampCurrentTime();
+			LastTailPollTime = 0.0;
+			break;
+
+		case EReadResult::Failed:
+			if (IsTrajectoryLoading())
+			{
+				TailReader.Reset();
+				FinishLoad(false);
+				return;
+			}
+			// Fichier momentanment indisponible : nouvel essai au prochain intervalle
+			break;
+
+		case EReadResult::NoChange:
+		default:
+			break;
+		}
+
+		// La premire lecture termine le chargement
+		if (IsTrajectoryLoading())
+		{
+			FinishLoad(true);
+			if (bPlayWhenReady)
+			{
+				bPlayWhenReady = false;
+				Play();
+			}
+		}
 	}
 
-	bIsPlaying = true;
-	UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Playback started at time %.2f"), CurrentPlaybackTime);
+	if (FPlatformTime::Seconds() - LastTailPollTime >= WatchPollInterval)
+	{
+		LaunchTailRead();
+	}
 }
 
-void ATrajectoryReplayActor::Pause()
+void ATrajectoryReplayActor::StopGrowingSources()
 {
-	bIsPlaying = false;
-	UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Playback paused at time %.2f"), CurrentPlaybackTime);
+	LiveReceiver.Reset();
+	TailReader.Reset();
+	TailReadTask = UE::Tasks::TTask<FTrajectoryCsvTailReader::EReadResult>();
 }
 
-void ATrajectoryReplayActor::Stop()
+bool ATrajectoryReplayActor::IsTrajectoryGrowing() const
 {
-	bIsPlaying = false;
-	CurrentPlaybackTime = 0.0f;
+	return LiveReceiver.IsValid() || TailReader.IsValid();
+}
 
-	if (WaypointCount > 0)
+void ATrajectoryReplayActor::OnTrajectoryGrown()
+{
+	// Statistiques mises  jour  chaque ajout, gomtrie reconstruite au plus toutes les LiveRefreshInterval secondes
+	TrajectoryDataRevision++;
+	WaypointCount = TrajectorySamples.Num();
+	TotalDuration = TrajectorySamples.GetEndTime();
+	ReportResidentSamples(TrajectorySamples.Num());
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastGrowthRefreshTime >= LiveRefreshInterval)
 	{
-		UpdateActorPosition();
+		bTrajectoryPathDirty = true;
+		bWaypointMarkersDirty = true;
+		bKinematicsDirty = true;
+		LastGrowthRefreshTime = Now;
 	}
-
-	UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Playback stopped and reset"));
 }
 
-void ATrajectoryReplayActor::SeekToTime(float TimeInSeconds)
+void ATrajectoryReplayActor::FinishLoad(bool bSucceeded)
 {
-	CurrentPlaybackTime = FMath::Clamp(TimeInSeconds, 0.0f, TotalDuration);
-	UpdateActorPosition();
+	if (!bSucceeded)
+	{
+		TrajectorySamples.Reset();
+		TrajectoryChannels.Reset();
+		TelemetryChannels.Reset();
+		RefreshTrajectoryStats();
+		LoadState = ETrajectoryLoadState::Failed;
+		LoadProgress = 0.0f;
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryReplay] Failed to load trajectory data"));
+		OnDataReloaded.Broadcast();
+		return;
+	}
+
+	RefreshTrajectoryStats();
+	OpenTrajectoryChannels();
+	LoadState = ETrajectoryLoadState::Loaded;
+	LoadProgress = 1.0f;
 
-	UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Seeked to time %.2f seconds"), CurrentPlaybackTime);
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Trajectory ready: %d waypoints in %.2f ms (%.1f KB resident)"),
+		WaypointCount, (FPlatformTime::Seconds() - LoadStartTime) * 1000.0, TrajectorySamples.GetAllocatedSize() / 1024.0);
+	OnDataReloaded.Broadcast();
 }
 
-void ATrajectoryReplayActor::SeekToProgress(float Progress)
+void ATrajectoryReplayActor::OpenTrajectoryChannels()
 {
-	Progress = FMath::Clamp(Progress, 0.0f, 1.0f);
-	CurrentPlaybackTime = Progress * TotalDuration;
-	UpdateActorPosition();
+	TrajectoryChannels.Reset();
 
-	UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Seeked to %.1f%% progress"), Progress * 100.0f);
+	// Direct et fichier suivi : pas de canaux ; le chargeur n'en trouve pas non plus dans un fichier pagin
+	FTrajectoryLoadRequest Request;
+	if (!IsTrajectoryGrowing() && MakeLoadRequest(Request))
+	{
+		FTrajectoryLoader::OpenChannels(Request, TrajectorySamples.Num(), TrajectoryChannels);
+	}
+	TrajectoryChannels.GetChannelNames(TelemetryChannels);
 }
 
-float ATrajectoryReplayActor::GetPlaybackProgress() const
+void ATrajectoryReplayActor::RefreshTrajectoryStats()
 {
-	if (TotalDuration > 0.0f)
+	// Calculer les statistiques
+	if (PagedSource.IsValid())
 	{
-		return CurrentPlaybackTime / TotalDuration;
+		WaypointCount = PagedSource->GetTotalSampleCount();
+		TotalDuration = PagedSource->GetEndTime();
 	}
-	return 0.0f;
+	else
+	{
+		WaypointCount = TrajectorySamples.Num();
+		TotalDuration = (WaypointCount > 0) ? TrajectorySamples.GetEndTime() : 0.0f;
+	}
+	ReportResidentSamples(GetResidentSampleCount());
+	TrajectoryDataRevision++;
+
+	// La gomtrie affiche et la courbe seront reconstruites
+	bTrajectoryPathDirty = true;
+	bWaypointMarkersDirty = true;
+	bInterpolationCurveDirty = true;
+	bResampleCacheDirty = true;
+	bKinematicsDirty = true;
+	bChannelLocationValid = false;
 }
 
-void ATrajectoryReplayActor::ClampCurrentTime()
+int64 ATrajectoryReplayActor::GetResidentSampleCount() const
 {
-	CurrentPlaybackTime = FMath::Clamp(CurrentPlaybackTime, 0.0f, TotalDuration);
+	// Source pagine : chantillons des tronons rsidents (quatre floats chacun)
+	const int64 PagedSamples = PagedSource.IsValid() ? PagedSource->GetResidentBytes() / (4 * sizeof(float)) : 0;
+	return TrajectorySamples.Num() + PagedSamples;
 }
 
-// ========== VISUALISATION DE LA TRAJECTOIRE ==========
-
-void ATrajectoryReplayActor::ToggleTrajectoryVisualization()
+void ATrajectoryReplayActor::ReportResidentSamples(int64 ResidentSamples)
 {
-	bShowTrajectory = !bShowTrajectory;
+	const int64 Delta = ResidentSamples - ReportedResidentSamples;
+	if (Delta == 0)
+	{
+		return;
+	}
 
-	if (bShowTrajectory)
+	if (Delta > 0)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Trajectory visualization enabled"));
+		INC_DWORD_STAT_BY(STAT_DataReplay_SamplesResident, Delta);
 	}
 	else
 	{
-		UE_LOG(LogTemp, Log, TEXT("[TrajectoryReplay] Trajectory visualization disabled"));
+		DEC_DWORD_STAT_BY(STAT_DataReplay_SamplesResident, -Delta);
 	}
+	TRACE_COUNTER_ADD(DataReplay_SamplesResident, Delta);
+	ReportedResidentSamples = ResidentSamples;
 }
 
-void ATrajectoryReplayActor::DrawTrajectoryVisualization()
+bool ATrajectoryReplayActor::IsTrajectoryLoading() const
+{
+	return LoadState == ETrajectoryLoadState::Loading;
+}
+
+bool ATrajectoryReplayActor::IsLive() const
+{
+	return LiveReceiver.IsValid();
+}
+
+void ATrajectoryReplayActor::FollowLiveHead()
 {
-	if (WaypointCount < 2 || !GetWorld())
+	if (LiveReceiver.IsValid())
 	{
-		return;
+		bFollowLiveHead = true;
 	}
+}
 
-	// Dessiner des lignes entre chaque paire de waypoints
-	for (int32 i = 0; i < WaypointCount - 1; i++)
-	{
-		FDroneWaypointRow* CurrentPoint = TrajectoryPoints[i];
-		FDroneWaypointRow* NextPoint = TrajectoryPoints[i + 1];
+void ATrajectoryReplayActor::SetUseReplaySubsystem(bool bUseSubsystem)
+{
+	bUseReplaySubsystem = bUseSubsystem;
 
-		FVector StartPos(CurrentPoint->X, CurrentPoint->Y, CurrentPoint->Z);
-		FVector EndPos(NextPoint->X, NextPoint->Y, NextPoint->Z);
+	UWorld* World = GetWorld();
+	UTrajectoryReplaySubsystem* Subsystem = World ? World->GetSubsystem<UTrajectoryReplaySubsystem>() : nullptr;
 
-		// Dessiner la ligne
-		DrawDebugLine(
-			GetWorld(),
-			StartPos,
-			EndPos,
-			TrajectoryColor.ToFColor(true),
-			false,  // Persistent (false = une frame seulement)
-			-1.0f,  // Lifetime
-			0,      // Depth priority
-			TrajectoryThickness
-		);
+	// Sans sous-systme (monde d'diteur, avant BeginPlay), l'acteur garde son propre Tick
+	const bool bRegister = bUseSubsystem && Subsystem && (HasActorBegunPlay() || IsActorBeginningPlay());
+	if (bRegister == bRegisteredWithSubsystem)
+	{
+		return;
 	}
 
-	// Dessiner des sphres aux waypoints si activ
-	if (bShowWaypoints)
+	if (bRegister)
 	{
-		for (int32 i = 0; i < WaypointCount; i++)
-		{
-			FDroneWaypointRow* Point = TrajectoryPoints[i];
-			FVector Position(Point->X, Point->Y, Point->Z);
-
-			DrawDebugSphere(
-				GetWorld(),
-				Position,
-				WaypointRadius,
-				12,  // Segments
-				TrajectoryColor.ToFColor(true),
-				false,
-				-1.0f,
-				0,
-				1.0f
-			);
-		}
+		Subsystem->RegisterActor(this);
+	}
+	else if (Subsystem)
+	{
+		Subsystem->UnregisterActor(this);
 	}
-}
\ No newline at end of file
+
+	bRegisteredWithSubsystem = bRegister;
+	SetActorTickEnabled(!bRegister);
+}
+
+void ATrajectoryReplayActor::SetTrajectorySamples(FTrajectorySampleBuffer&& InSamples)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Load);
+	LLM_SCOPE_BYTAG(DataReplay_Samples);
+
+	CancelAsyncLoad();
+	PagedSource.Reset();
+	StopGrowingSources();
+
+	TrajectorySamples = MoveTemp(InSamples);
+	TrajectorySamples.RemoveInvalidSamples();
+	TrajectorySamples.SortByTime();
+	TrajectoryChannels.Reset();
+	TelemetryChannels.Reset();
+	CachedSegmentIndex = 0;
+	bPlayWhenReady = false;
+
+	RefreshTrajectoryStats();
+	ClampCurrentTime();
+	LoadState = ETrajectoryLoadState::Loaded;
+	LoadProgress = 1.0f;
+	OnDataReloaded.Broadcast();
+}
+
+bool ATrajectoryReplayActor::CanStartStreamingPlayback() const
+{
+	return WaypointCount >= 2 && (TotalDuration - TrajectorySamples.GetStartTime()) >= StreamingStartDuration;
+}
+
+void ATrajectoryReplayActor::ReloadTrajectoryData()
+{
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Reloading trajectory data..."));
+
+	bool bWasPlaying = bIsPlaying;
+	Stop();
+
+	LoadTrajectoryPoints();
+
+	if (bWasPlaying && bAutoPlay)
+	{
+		Play();
+	}
+}
+
+void ATrajectoryReplayActor::LoadTrajectoryFromFile(const FString& FilePath)
+{
+	// Les fichiers .dtraj sont lus par tronons, les autres comme des CSV
+	if (FPaths::GetExtension(FilePath).Equals(TEXT("dtraj"), ESearchCase::IgnoreCase))
+	{
+		TrajectorySource = ETrajectorySourceType::PagedFile;
+		PagedFilePath.FilePath = FilePath;
+	}
+	else
+	{
+		TrajectorySource = ETrajectorySourceType::CsvFile;
+		TrajectoryFilePath.FilePath = FilePath;
+	}
+	ReloadTrajectoryData();
+}
+
+bool ATrajectoryReplayActor::ExportPagedTrajectory(const FString& FilePath, float ChunkDuration)
+{
+	if (TrajectorySamples.Num() == 0)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryReplay] Cannot export - no trajectory data in memory"));
+		return false;
+	}
+
+	return FTrajectoryPagedSource::WriteFile(ResolveProjectPath(FilePath), TrajectorySamples, ChunkDuration);
+}
+
+// ========== CALCUL DE POSITION ==========
+
+FVector ATrajectoryReplayActor::CalculatePositionAtTime(float Time) const
+{
+	// Source pagine : interpolation linaire dans le tronon prpar par UpdatePagedSource
+	if (PagedSource.IsValid())
+	{
+		return PagedSource->EvaluatePosition(Time, CachedSegmentIndex);
+	}
+
+	// Direct, fichier suivi ou chargement en cours : le buffer grandit  chaque frame, seule l'interpolation linaire suit sans reconstruction
+	if (IsTrajectoryGrowing() || IsTrajectoryLoading())
+	{
+		return TrajectorySamples.EvaluatePosition(Time, CachedSegmentIndex);
+	}
+
+	// Vitesse constante : le temps est converti en distance parcourue le long de la courbe
+	if (bConstantSpeed && InterpolationCurve.HasArcLengthTable())
+	{
+		const float StartTime = TrajectorySamples.GetStartTime();
+		const float Duration = TotalDuration - StartTime;
+		const float Alpha = Duration > 0.0f ? FMath::Clamp((Time - StartTime) / Duration, 0.0f, 1.0f) : 0.0f;
+		return InterpolationCurve.EvaluateAtDistance(Alpha * InterpolationCurve.GetTotalLength(), CachedArcStepIndex);
+	}
+
+	// Grille rgulire : ni recherche ni division
+	if (!ResampleCache.IsEmpty())
+	{
+		return ResampleCache.EvaluatePosition(Time);
+	}
+
+	// Courbe prcalcule, en repartant du dernier segment utilis
+	if (InterpolationMode != ETrajectoryInterpolationMode::Linear && !InterpolationCurve.IsEmpty())
+	{
+		return InterpolationCurve.EvaluatePosition(TrajectorySamples, Time, CachedSegmentIndex);
+	}
+
+	// Interpolation linaire dans le buffer, en repartant du dernier segment utilis
+	return TrajectorySamples.EvaluatePosition(Time, CachedSegmentIndex);
+}
+
+void ATrajectoryReplayActor::UpdateInterpolationCurve()
+{
+	LLM_SCOPE_BYTAG(DataReplay_Derived);
+
+	// La courbe n'est utile qu'en dehors de la lecture linaire simple ; pendant un chargement, construite une seule fois  la fin
+	if ((InterpolationMode == ETrajectoryInterpolationMode::Linear && !bConstantSpeed) || IsTrajectoryLoading())
+	{
+		if (!InterpolationCurve.IsEmpty())
+		{
+			InterpolationCurve.Reset();
+		}
+		return;
+	}
+
+	if (!bInterpolationCurveDirty && !InterpolationCurve.IsEmpty()
+		&& InterpolationCurve.GetMode() == InterpolationMode && InterpolationCurve.HasArcLengthTable() == bConstantSpeed)
+	{
+		return;
+	}
+
+	InterpolationCurve.Build(TrajectorySamples, InterpolationMode);
+	if (bConstantSpeed)
+	{
+		InterpolationCurve.BuildArcLengthTable();
+	}
+	bInterpolationCurveDirty = false;
+	CachedArcStepIndex = 0;
+}
+
+float ATrajectoryReplayActor::GetEffectiveResampleRate() const
+{
+	if (TrajectorySource == ETrajectorySourceType::Asset && TrajectoryAsset && TrajectoryAsset->ResampleRate > 0.0f)
+	{
+		return TrajectoryAsset->ResampleRate;
+	}
+	return ResampleRate;
+}
+
+void ATrajectoryReplayActor::UpdateResampleCache()
+{
+	LLM_SCOPE_BYTAG(DataReplay_Derived);
+
+	// La vitesse constante a sa propre paramtrisation : la grille n'est pas utilise
+	const float Rate = bConstantSpeed ? 0.0f : GetEffectiveResampleRate();
+
+	// Pendant un chargement, la grille n'est construite qu'une fois, sur la trajectoire complte (FinishLoad)
+	if (IsTrajectoryLoading())
+	{
+		if (!ResampleCache.IsEmpty())
+		{
+			ResampleCache.Reset();
+		}
+		return;
+	}
+
+	if (!bResampleCacheDirty && AppliedResampleRate == Rate && AppliedResampleMode == InterpolationMode)
+	{
+		return;
+	}
+
+	bResampleCacheDirty = false;
+	AppliedResampleRate = Rate;
+	AppliedResampleMode = InterpolationMode;
+	ResampleMaxError = 0.0f;
+	ResampleMemoryKB = 0.0f;
+
+	if (Rate <= 0.0f)
+	{
+		ResampleCache.Reset();
+		return;
+	}
+
+	// La grille suit la courbe choisie (UpdateInterpolationCurve est appel avant)
+	const FTrajectoryCurve* Curve = InterpolationMode != ETrajectoryInterpolationMode::Linear ? &InterpolationCurve : nullptr;
+	if (!ResampleCache.Build(TrajectorySamples, Rate, Curve))
+	{
+		return;
+	}
+
+	const FTrajectoryResampleStats Stats = ResampleCache.ComputeStats(TrajectorySamples);
+	ResampleMaxError = Stats.MaxError;
+	ResampleMemoryKB = Stats.MemoryBytes / 1024.0f;
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Resampled at %.1f Hz: %d points, %.1f KB (source %.1f KB), max error %.3f, RMS error %.3f"),
+		Stats.Rate, Stats.GridSampleCount, Stats.MemoryBytes / 1024.0, Stats.SourceMemoryBytes / 1024.0, Stats.MaxError, Stats.RmsError);
+}
+
+void ATrajectoryReplayActor::ReportResampleTradeoff() const
+{
+	const FTrajectoryCurve* Curve = InterpolationMode != ETrajectoryInterpolationMode::Linear && !InterpolationCurve.IsEmpty() ? &InterpolationCurve : nullptr;
+	FTrajectoryResampleCache::LogRateTradeoff(TrajectorySamples, Curve, FTrajectoryResampleCache::GetDefaultTradeoffRates(), GetName());
+}
+
+void ATrajectoryReplayActor::UpdatePagedSource()
+{
+	if (!PagedSource.IsValid())
+	{
+		return;
+	}
+
+	// Prchargement dans le sens et  la vitesse de lecture ; rien  prcharger  l'arrt
+	const float SignedSpeed = bIsPlaying ? (bReversePlayback ? -PlaybackSpeed : PlaybackSpeed) : 0.0f;
+	PagedSource->SetMemoryBudget(static_cast<int64>(PagingMemoryBudgetMB * 1024.0 * 1024.0));
+	PagedSource->Update(CurrentPlaybackTime, SignedSpeed, PagingPrefetchSeconds);
+
+	PagingHits = PagedSource->GetHitCount();
+	PagingMisses = PagedSource->GetMissCount();
+	PagingResidentMB = PagedSource->GetResidentBytes() / (1024.0f * 1024.0f);
+	ReportResidentSamples(GetResidentSampleCount());
+}
+
+void ATrajectoryReplayActor::UpdateActorPosition()
+{
+	UpdateInterpolationCurve();
+	UpdateResampleCache();
+	UpdatePagedSource();
+
+	FVector NewPosition;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_DataReplay_Evaluate);
+		NewPosition = CalculatePositionAtTime(CurrentPlaybackTime);
+	}
+	ApplyPosition(NewPosition);
+}
+
+void ATrajectoryReplayActor::UpdateKinematics()
+{
+	LLM_SCOPE_BYTAG(DataReplay_Derived);
+
+	if (!bComputeKinematics)
+	{
+		if (!Kinematics.IsEmpty())
+		{
+			Kinematics.Reset();
+			CurrentSpeed = CurrentAcceleration = CurrentHeading = CurrentPitch = DistanceTravelled = 0.0f;
+		}
+		return;
+	}
+
+	if (!bKinematicsDirty && AppliedKinematicSmoothing == KinematicSmoothingWindow)
+	{
+		return;
+	}
+
+	// Direct, fichier suivi et chargement en cours : recalculs au rythme de la gomtrie (LiveRefreshInterval), borns au dernier chantillon calcul entre-temps
+	Kinematics.Build(TrajectorySamples, KinematicSmoothingWindow);
+	bKinematicsDirty = false;
+	AppliedKinematicSmoothing = KinematicSmoothingWindow;
+	CachedKinematicIndex = 0;
+}
+
+void ATrajectoryReplayActor::ApplyPosition(const FVector& Position)
+{
+	UpdateKinematics();
+	if (Kinematics.IsEmpty())
+	{
+		SetActorLocation(Position);
+		return;
+	}
+
+	// Vitesse constante : les canaux sont lus  la distance parcourue qui correspond au temps actuel
+	float ChannelTime = CurrentPlaybackTime;
+	float ConstantSpeed = -1.0f;
+	if (bConstantSpeed && InterpolationCurve.HasArcLengthTable())
+	{
+		const float StartTime = TrajectorySamples.GetStartTime();
+		const float Duration = TotalDuration - StartTime;
+		const float Alpha = Duration > 0.0f ? FMath::Clamp((CurrentPlaybackTime - StartTime) / Duration, 0.0f, 1.0f) : 0.0f;
+		ChannelTime = Kinematics.FindTimeAtDistance(TrajectorySamples, Alpha * Kinematics.GetTotalDistance());
+		ConstantSpeed = Duration > 0.0f ? InterpolationCurve.GetTotalLength() / Duration : 0.0f;
+	}
+
+	const FTrajectoryKinematicState State = Kinematics.Evaluate(TrajectorySamples, ChannelTime, CachedKinematicIndex);
+	CurrentSpeed = ConstantSpeed >= 0.0f ? ConstantSpeed : State.Speed;
+	CurrentAcceleration = ConstantSpeed >= 0.0f ? 0.0f : static_cast<float>(State.Acceleration.Size());
+	CurrentHeading = State.Heading;
+	CurrentPitch = State.Pitch;
+	DistanceTravelled = State.Distance;
+
+	// Une seule mise  jour de la transformation
+	if (bOrientAlongPath)
+	{
+		SetActorLocationAndRotation(Position, State.GetRotation());
+	}
+	else
+	{
+		SetActorLocation(Position);
+	}
+}
+
+FTrajectoryKinematicState ATrajectoryReplayActor::GetKinematicStateAtTime(float Time) const
+{
+	int32 Cursor = CachedKinematicIndex;
+	return Kinematics.Evaluate(TrajectorySamples, Time, Cursor);
+}
+
+// ========== CANAUX DE TLMTRIE ==========
+
+bool ATrajectoryReplayActor::LocateChannelSample(float Time, FTrajectorySampleLocation& OutLocation) const
+{
+	if (TrajectorySamples.IsEmpty())
+	{
+		return false;
+	}
+
+	// Plusieurs canaux lus au mme temps : une seule recherche. Sinon mme curseur que la position,
+	// dj sur le bon segment pendant la lecture
+	if (!bChannelLocationValid || Time != CachedChannelTime)
+	{
+		CachedChannelLocation = TrajectorySamples.Locate(Time, CachedSegmentIndex);
+		CachedChannelTime = Time;
+		bChannelLocationValid = true;
+	}
+	OutLocation = CachedChannelLocation;
+	return true;
+}
+
+bool ATrajectoryReplayActor::EvaluateChannel(FName Channel, double& Value) const
+{
+	return EvaluateChannelAtTime(Channel, CurrentPlaybackTime, Value);
+}
+
+bool ATrajectoryReplayActor::EvaluateChannelAtTime(FName Channel, float Time, double& Value) const
+{
+	const int32 ChannelIndex = TrajectoryChannels.FindChannel(Channel);
+	FTrajectorySampleLocation Location;
+	return ChannelIndex != INDEX_NONE && LocateChannelSample(Time, Location) && TrajectoryChannels.Evaluate(ChannelIndex, Location, Value);
+}
+
+bool ATrajectoryReplayActor::EvaluateEnumChannelAtTime(FName Channel, float Time, FName& Value) const
+{
+	const int32 ChannelIndex = TrajectoryChannels.FindChannel(Channel);
+	FTrajectorySampleLocation Location;
+	return ChannelIndex != INDEX_NONE && LocateChannelSample(Time, Location) && TrajectoryChannels.EvaluateEnum(ChannelIndex, Location, Value);
+}
+
+bool ATrajectoryReplayActor::GetChannelType(FName Channel, ETrajectoryChannelType& Type) const
+{
+	const int32 ChannelIndex = TrajectoryChannels.FindChannel(Channel);
+	if (ChannelIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Type = TrajectoryChannels.GetChannel(ChannelIndex).Type;
+	return true;
+}
+
+bool ATrajectoryReplayActor::PrefetchChannels(const TArray<FName>& Channels)
+{
+	bool bAllFound = true;
+	TArray<int32> ChannelIndices;
+	for (const FName Channel : Channels)
+	{
+		const int32 ChannelIndex = TrajectoryChannels.FindChannel(Channel);
+		if (ChannelIndex == INDEX_NONE)
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryReplay] Unknown telemetry channel: %s"), *Channel.ToString());
+			bAllFound = false;
+			continue;
+		}
+		ChannelIndices.Add(ChannelIndex);
+	}
+
+	return TrajectoryChannels.DecodeAsync(ChannelIndices) && bAllFound;
+}
+
+bool ATrajectoryReplayActor::IsChannelReady(FName Channel) const
+{
+	const int32 ChannelIndex = TrajectoryChannels.FindChannel(Channel);
+	return ChannelIndex != INDEX_NONE && TrajectoryChannels.GetColumn(ChannelIndex) != nullptr;
+}
+
+void ATrajectoryReplayActor::ReleaseChannels()
+{
+	TrajectoryChannels.ReleaseDecoded();
+}
+
+// ========== POSITIONS GODSIQUES ==========
+
+bool ATrajectoryReplayActor::IsGeoreferenced() const
+{
+	return GeoReference.IsValid();
+}
+
+bool ATrajectoryReplayActor::GetGeoOrigin(FTrajectoryGeoPosition& OutOrigin) const
+{
+	if (!GeoReference.IsValid())
+	{
+		return false;
+	}
+	OutOrigin = GeoReference.GetOrigin();
+	return true;
+}
+
+bool ATrajectoryReplayActor::LocationToGeo(const FVector& Location, FTrajectoryGeoPosition& OutPosition) const
+{
+	if (!GeoReference.IsValid())
+	{
+		return false;
+	}
+	OutPosition = GeoReference.LocalToGeo(Location);
+	return true;
+}
+
+bool ATrajectoryReplayActor::GeoToLocation(const FTrajectoryGeoPosition& Position, FVector& OutLocation) const
+{
+	if (!GeoReference.IsValid())
+	{
+		return false;
+	}
+	OutLocation = GeoReference.GeoToLocal(Position);
+	return true;
+}
+
+bool ATrajectoryReplayActor::GetCurrentGeoPosition(FTrajectoryGeoPosition& OutPosition) const
+{
+	return LocationToGeo(GetActorLocation(), OutPosition);
+}
+
+// ========== CONTRLES DE LECTURE ==========
+
+void ATrajectoryReplayActor::Play()
+{
+	// Pendant un chargement, attendre que le dbut de la trajectoire soit disponible
+	if (IsTrajectoryLoading() && !CanStartStreamingPlayback())
+	{
+		bPlayWhenReady = true;
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Playback will start once %.1f seconds of trajectory are loaded"), StreamingStartDuration);
+		return;
+	}
+
+	if (WaypointCount == 0)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryReplay] Cannot play - no trajectory data loaded"));
+		return;
+	}
+
+	bIsPlaying = true;
+	BroadcastStateChanges();
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Playback started at time %.2f"), CurrentPlaybackTime);
+}
+
+void ATrajectoryReplayActor::Pause()
+{
+	bIsPlaying = false;
+	bPlayWhenReady = false;
+	BroadcastStateChanges();
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Playback paused at time %.2f"), CurrentPlaybackTime);
+}
+
+void ATrajectoryReplayActor::Stop()
+{
+	bIsPlaying = false;
+	bPlayWhenReady = false;
+	CurrentPlaybackTime = 0.0f;
+
+	if (WaypointCount > 0)
+	{
+		UpdateActorPosition();
+	}
+	BroadcastStateChanges();
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Playback stopped and reset"));
+}
+
+void ATrajectoryReplayActor::SeekToTime(float TimeInSeconds)
+{
+	// Un dplacement manuel quitte le direct pour l'historique
+	if (LiveReceiver.IsValid())
+	{
+		bFollowLiveHead = false;
+	}
+	CurrentPlaybackTime = FMath::Clamp(TimeInSeconds, 0.0f, TotalDuration);
+	UpdateActorPosition();
+	TrajectoryReplayStats::CountSeeks(1);
+	BroadcastStateChanges();
+
+	// Appel  chaque mouvement du curseur de la timeline
+	UE_LOG(LogDataReplay, Verbose, TEXT("[TrajectoryReplay] Seeked to time %.2f seconds"), CurrentPlaybackTime);
+}
+
+void ATrajectoryReplayActor::SeekToProgress(float Progress)
+{
+	Progress = FMath::Clamp(Progress, 0.0f, 1.0f);
+	if (LiveReceiver.IsValid())
+	{
+		bFollowLiveHead = false;
+	}
+	CurrentPlaybackTime = Progress * TotalDuration;
+	UpdateActorPosition();
+	TrajectoryReplayStats::CountSeeks(1);
+	BroadcastStateChanges();
+
+	UE_LOG(LogDataReplay, Verbose, TEXT("[TrajectoryReplay] Seeked to %.1f%% progress"), Progress * 100.0f);
+}
+
+void ATrajectoryReplayActor::BeginScrub()
+{
+	if (bIsScrubbing)
+	{
+		return;
+	}
+
+	// Le temps n'avance plus jusqu' EndScrub ; bIsPlaying est conserv pour reprendre la lecture ensuite
+	if (LiveReceiver.IsValid())
+	{
+		bFollowLiveHead = false;
+	}
+	bIsScrubbing = true;
+	bScrubTargetPending = false;
+	bScrubPreviewShown = false;
+}
+
+void ATrajectoryReplayActor::ScrubToProgress(float Progress)
+{
+	if (!bIsScrubbing)
+	{
+		SeekToProgress(Progress);
+		return;
+	}
+
+	// Applique par UpdateScrub  la prochaine frame : les cibles intermdiaires sont ignores
+	ScrubTargetTime = FMath::Clamp(Progress, 0.0f, 1.0f) * TotalDuration;
+	bScrubTargetPending = true;
+	LastScrubInputTime = FPlatformTime::Seconds();
+}
+
+void ATrajectoryReplayActor::EndScrub()
+{
+	if (!bIsScrubbing)
+	{
+		return;
+	}
+
+	bIsScrubbing = false;
+
+	// Position exacte  la dernire cible
+	if (bScrubTargetPending)
+	{
+		CurrentPlaybackTime = FMath::Clamp(ScrubTargetTime, 0.0f, TotalDuration);
+		TrajectoryReplayStats::CountSeeks(1);
+	}
+	if ((bScrubTargetPending || bScrubPreviewShown) && WaypointCount > 0)
+	{
+		UpdateActorPosition();
+	}
+	bScrubTargetPending = false;
+	bScrubPreviewShown = false;
+	BroadcastStateChanges();
+
+	UE_LOG(LogDataReplay, Verbose, TEXT("[TrajectoryReplay] Scrub ended at time %.2f seconds"), CurrentPlaybackTime);
+}
+
+void ATrajectoryReplayActor::UpdateScrub()
+{
+	if (WaypointCount == 0)
+	{
+		return;
+	}
+
+	if (bScrubTargetPending)
+	{
+		bScrubTargetPending = false;
+		CurrentPlaybackTime = FMath::Clamp(ScrubTargetTime, 0.0f, TotalDuration);
+		TrajectoryReplayStats::CountSeeks(1);
+
+		// Source pagine : aperu sans lecture disque bloquante ; sinon l'valuation exacte est dj bon march
+		if (PagedSource.IsValid())
+		{
+			SCOPE_CYCLE_COUNTER(STAT_DataReplay_Evaluate);
+			ApplyPosition(PagedSource->EvaluatePreviewPosition(CurrentPlaybackTime));
+			bScrubPreviewShown = true;
+		}
+		else
+		{
+			UpdateActorPosition();
+		}
+		return;
+	}
+
+	// Curseur immobile depuis ScrubSettleDelay : remplacer l'aperu par la position exacte
+	if (bScrubPreviewShown && FPlatformTime::Seconds() - LastScrubInputTime >= ScrubSettleDelay)
+	{
+		UpdateActorPosition();
+		bScrubPreviewShown = false;
+	}
+}
+
+float ATrajectoryReplayActor::GetPlaybackProgress() const
+{
+	if (TotalDuration > 0.0f)
+	{
+		return CurrentPlaybackTime / TotalDuration;
+	}
+	return 0.0f;
+}
+
+void ATrajectoryReplayActor::ClampCurrentTime()
+{
+	CurrentPlaybackTime = FMath::Clamp(CurrentPlaybackTime, 0.0f, TotalDuration);
+}
+
+// ========== VISUALISATION DE LA TRAJECTOIRE ==========
+
+void ATrajectoryReplayActor::BroadcastStateChanges()
+{
+	// Comparaison avec le dernier tat diffus : couvre aussi les proprits modifies directement depuis un Blueprint
+	if (bIsPlaying != bBroadcastIsPlaying)
+	{
+		bBroadcastIsPlaying = bIsPlaying;
+		OnPlayStateChanged.Broadcast(bIsPlaying);
+	}
+
+	if (bShowTrajectory != bBroadcastShowTrajectory)
+	{
+		bBroadcastShowTrajectory = bShowTrajectory;
+		OnVisibilityChanged.Broadcast(bShowTrajectory);
+	}
+
+	if (CurrentPlaybackTime != BroadcastPlaybackTime || TotalDuration != BroadcastTotalDuration)
+	{
+		BroadcastPlaybackTime = CurrentPlaybackTime;
+		BroadcastTotalDuration = TotalDuration;
+		OnPlaybackTimeChanged.Broadcast(CurrentPlaybackTime, TotalDuration);
+	}
+}
+
+void ATrajectoryReplayActor::ToggleTrajectoryVisualization()
+{
+	bShowTrajectory = !bShowTrajectory;
+	UpdateTrajectoryVisualization();
+	BroadcastStateChanges();
+
+	if (bShowTrajectory)
+	{
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Trajectory visualization enabled"));
+	}
+	else
+	{
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplay] Trajectory visualization disabled"));
+	}
+}
+
+void ATrajectoryReplayActor::DrawTrajectoryVisualization()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Draw);
+
+	if (!TrajectoryPathComponent)
+	{
+		return;
+	}
+
+	// Construire la gomtrie une seule fois ; le composant la conserve pour les frames suivantes
+	// (une source pagine n'a pas la trajectoire complte en mmoire)
+	if (TrajectorySamples.Num() < 2)
+	{
+		TrajectoryPathComponent->ClearPath();
+	}
+	else
+	{
+		TrajectoryPathComponent->SetPathPoints(TrajectorySamples);
+	}
+
+	TrajectoryPathComponent->SetLineStyle(TrajectoryColor, TrajectoryThickness);
+	AppliedTrajectoryColor = TrajectoryColor;
+	AppliedTrajectoryThickness = TrajectoryThickness;
+	bTrajectoryPathDirty = false;
+}
+
+void ATrajectoryReplayActor::UpdateTrajectoryVisualization()
+{
+	if (!TrajectoryPathComponent)
+	{
+		return;
+	}
+
+	const bool bVisible = bShowTrajectory && WaypointCount >= 2;
+
+	if (bVisible)
+	{
+		// Reconstruire uniquement si les donnes ont chang
+		if (bTrajectoryPathDirty)
+		{
+			DrawTrajectoryVisualization();
+		}
+		else if (!AppliedTrajectoryColor.Equals(TrajectoryColor) || AppliedTrajectoryThickness != TrajectoryThickness)
+		{
+			TrajectoryPathComponent->SetLineStyle(TrajectoryColor, TrajectoryThickness);
+			AppliedTrajectoryColor = TrajectoryColor;
+			AppliedTrajectoryThickness = TrajectoryThickness;
+		}
+	}
+
+	if (TrajectoryPathComponent->IsVisible() != bVisible)
+	{
+		TrajectoryPathComponent->SetVisibility(bVisible);
+	}
+
+	if (!WaypointMarkers)
+	{
+		return;
+	}
+
+	// Sphres des waypoints : instances recres au chargement, mises  jour seulement si le rayon ou les couleurs changent
+	const bool bMarkersVisible = bVisible && bShowWaypoints;
+
+	if (bMarkersVisible)
+	{
+		UMaterialInterface* MarkerMaterial = GetWaypointMarkerMaterial();
+		if (MarkerMaterial && WaypointMarkers->GetMaterial(0) != MarkerMaterial)
+		{
+			WaypointMarkers->SetMaterial(0, MarkerMaterial);
+		}
+
+		if (bWaypointMarkersDirty)
+		{
+			RebuildWaypointMarkers();
+		}
+		else
+		{
+			if (AppliedWaypointRadius != WaypointRadius)
+			{
+				UpdateWaypointMarkerTransforms();
+			}
+			if (!AppliedWaypointStartColor.Equals(TrajectoryColor) || bAppliedColorWaypointsByTime != bColorWaypointsByTime
+				|| (bColorWaypointsByTime && !AppliedWaypointEndColor.Equals(WaypointEndColor)))
+			{
+				UpdateWaypointMarkerColors();
+			}
+		}
+	}
+
+	if (WaypointMarkers->IsVisible() != bMarkersVisible)
+	{
+		WaypointMarkers->SetVisibility(bMarkersVisible);
+	}
+}
+
+UMaterialInterface* ATrajectoryReplayActor::GetWaypointMarkerMaterial()
+{
+	if (WaypointMaterial)
+	{
+		return WaypointMaterial;
+	}
+
+	if (!WaypointFallbackMaterial)
+	{
+		// Le matriau de la sphre du moteur (BasicShapeMaterial) expose un paramtre Color
+		const UStaticMesh* Mesh = WaypointMarkers->GetStaticMesh();
+		UMaterialInterface* BaseMaterial = Mesh ? Mesh->GetMaterial(0) : nullptr;
+		if (!BaseMaterial)
+		{
+			return nullptr;
+		}
+
+		WaypointFallbackMaterial = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+		WaypointFallbackMaterial->SetVectorParameterValue(WaypointColorParameterName, TrajectoryColor);
+		if (bColorWaypointsByTime)
+		{
+			UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryReplay] %s: Color Waypoints By Time needs a Waypoint Material reading PerInstanceCustomData; waypoints use Trajectory Color"), *GetName());
+		}
+	}
+	return WaypointFallbackMaterial;
+}
+
+FTransform ATrajectoryReplayActor::GetWaypointMarkerTransform(int32 Index) const
+{
+	// La sphre de base du moteur a un rayon de 50 units
+	return FTransform(FQuat::Identity, TrajectorySamples.GetPosition(Index), FVector(WaypointRadius / 50.0f));
+}
+
+void ATrajectoryReplayActor::RebuildWaypointMarkers()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Draw);
+	LLM_SCOPE_BYTAG(DataReplay_Geometry);
+
+	// Une source pagine n'a pas d'chantillons en mmoire : aucune sphre
+	const int32 SampleCount = TrajectorySamples.Num();
+
+	TArray<FTransform> Transforms;
+	Transforms.SetNumUninitialized(SampleCount);
+	for (int32 i = 0; i < SampleCount; i++)
+	{
+		Transforms[i] = GetWaypointMarkerTransform(i);
+	}
+
+	// Un seul ajout group pour toutes les instances
+	WaypointMarkers->ClearInstances();
+	WaypointMarkers->AddInstances(Transforms, false, true, false);
+	AppliedWaypointRadius = WaypointRadius;
+	bWaypointMarkersDirty = false;
+
+	UpdateWaypointMarkerColors();
+}
+
+void ATrajectoryReplayActor::UpdateWaypointMarkerTransforms()
+{
+	const int32 InstanceCount = WaypointMarkers->GetInstanceCount();
+
+	TArray<FTransform> Transforms;
+	Transforms.SetNumUninitialized(InstanceCount);
+	for (int32 i = 0; i < InstanceCount; i++)
+	{
+		Transforms[i] = GetWaypointMarkerTransform(i);
+	}
+
+	WaypointMarkers->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+	AppliedWaypointRadius = WaypointRadius;
+}
+
+void ATrajectoryReplayActor::UpdateWaypointMarkerColors()
+{
+	const int32 InstanceCount = WaypointMarkers->GetInstanceCount();
+	const float StartTime = TrajectorySamples.GetStartTime();
+	const float Duration = TotalDuration - StartTime;
+
+	for (int32 i = 0; i < InstanceCount; i++)
+	{
+		FLinearColor Color = TrajectoryColor;
+		if (bColorWaypointsByTime && Duration > 0.0f)
+		{
+			Color = FLinearColor::LerpUsingHSV(TrajectoryColor, WaypointEndColor, (TrajectorySamples.Times[i] - StartTime) / Duration);
+		}
+
+		const float CustomData[3] = { Color.R, Color.G, Color.B };
+		WaypointMarkers->SetCustomData(i, MakeArrayView(CustomData, 3), false);
+	}
+
+	// Sans WaypointMaterial, la couleur passe par l'instance dynamique
+	if (WaypointFallbackMaterial && !WaypointMaterial)
+	{
+		WaypointFallbackMaterial->SetVectorParameterValue(WaypointColorParameterName, TrajectoryColor);
+	}
+
+	// Un seul rafrachissement du rendu pour toutes les instances
+	WaypointMarkers->MarkRenderStateDirty();
+	AppliedWaypointStartColor = TrajectoryColor;
+	AppliedWaypointEndColor = WaypointEndColor;
+	bAppliedColorWaypointsByTime = bColorWaypointsByTime;
+}
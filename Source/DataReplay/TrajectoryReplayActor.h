@@ -6,8 +6,37 @@
 #include "GameFramework/Actor.h"
 #include "Engine/DataTable.h"
 #include "DroneWaypointStruct.h"
+#include "TrajectorySampleBuffer.h"
+#include "TrajectoryLoader.h"
+#include "TrajectoryCsvLoader.h"
+#include "TrajectoryCurve.h"
+#include "TrajectoryResampleCache.h"
+#include "TrajectoryKinematics.h"
+#include "TrajectoryChannels.h"
+#include "TrajectoryGeodetic.h"
 #include "TrajectoryReplayActor.generated.h"
 
+class UTrajectoryAsset;
+class UTrajectoryPathComponent;
+class UInstancedStaticMeshComponent;
+class UMaterialInterface;
+class UMaterialInstanceDynamic;
+class UTrajectoryReplaySubsystem;
+class FTrajectoryPagedSource;
+class FTrajectoryLiveReceiver;
+
+// Temps de lecture ou dure totale modifis (lecture, dplacement, trajectoire qui grandit)
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnReplayTimeChanged, float, CurrentTime, float, TotalDuration);
+
+// Lecture dmarre ou arrte
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnReplayPlayStateChanged, bool, bIsPlaying);
+
+// Ligne de trajectoire affiche ou cache
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnReplayVisibilityChanged, bool, bShowTrajectory);
+
+// Chargement dmarr ou termin (LoadState indique lequel), ou chantillons remplacs
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnReplayDataReloaded);
+
 UCLASS()
 class DATAREPLAY_API ATrajectoryReplayActor : public AActor
 {
@@ -19,16 +48,99 @@ public:
 
 	// ========== CONFIGURATION DE LA TRAJECTOIRE ==========
 
-	// DataTable contenant les points de la trajectoire
+	// Source utilise au chargement
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data")
+	ETrajectorySourceType TrajectorySource;
+
+	// DataTable contenant les points de la trajectoire
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (EditCondition = "TrajectorySource == ETrajectorySourceType::DataTable"))
 	UDataTable* TrajectoryData;
 
+	// Fichier CSV (Time,X,Y,Z avec ou sans en-tte, ou Time,Latitude,Longitude,Altitude) ; chemin absolu ou relatif au dossier du projet
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (FilePathFilter = "csv", EditCondition = "TrajectorySource == ETrajectorySourceType::CsvFile"))
+	FFilePath TrajectoryFilePath;
+
+	// Suivre les lignes ajoutes au fichier CSV pendant la lecture (journal en cours d'criture)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (EditCondition = "TrajectorySource == ETrajectorySourceType::CsvFile"))
+	bool bWatchFile;
+
+	// Intervalle entre deux vrifications de la taille du fichier suivi (secondes)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (ClampMin = "0.0", EditCondition = "TrajectorySource == ETrajectorySourceType::CsvFile && bWatchFile"))
+	float WatchPollInterval;
+
+	// Derniers chantillons re-tris avec les lignes ajoutes ; une ligne plus ancienne que cette fentre est ignore
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (ClampMin = "0", EditCondition = "TrajectorySource == ETrajectorySourceType::CsvFile && bWatchFile"))
+	int32 WatchReorderWindow;
+
+	// Fichier GPS (latitude, longitude, altitude) : convertir autour de GeoOrigin plutt qu'autour du premier chantillon
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (EditCondition = "TrajectorySource == ETrajectorySourceType::CsvFile"))
+	bool bUseGeoOrigin;
+
+	// Position WGS84 place  l'origine du monde (axes : X = Est, Y = Sud, Z = Haut)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (EditCondition = "TrajectorySource == ETrajectorySourceType::CsvFile && bUseGeoOrigin"))
+	FTrajectoryGeoPosition GeoOrigin;
+
+	// Fichier GPS sans GeoOrigin : reprendre le repre commun des acteurs du monde (fix par le premier fichier GPS charg),
+	// comme l'acteur de flotte ; dcoch, la trajectoire est centre sur son propre premier chantillon
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (EditCondition = "TrajectorySource == ETrajectorySourceType::CsvFile && !bUseGeoOrigin"))
+	bool bShareGeoOrigin;
+
+	// Asset binaire contenant les chantillons
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (EditCondition = "TrajectorySource == ETrajectorySourceType::Asset"))
+	UTrajectoryAsset* TrajectoryAsset;
+
+	// Fichier pagin (.dtraj, voir ExportPagedTrajectory) ; chemin absolu ou relatif au dossier du projet
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (FilePathFilter = "dtraj", EditCondition = "TrajectorySource == ETrajectorySourceType::PagedFile"))
+	FFilePath PagedFilePath;
+
+	// Mmoire maximale des tronons rsidents d'un fichier pagin (Mo)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (ClampMin = "1.0", EditCondition = "TrajectorySource == ETrajectorySourceType::PagedFile"))
+	float PagingMemoryBudgetMB;
+
+	// Dure de trajectoire prcharge en avance, dans le sens de lecture (secondes)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (ClampMin = "0.0", EditCondition = "TrajectorySource == ETrajectorySourceType::PagedFile"))
+	float PagingPrefetchSeconds;
+
+	// Port UDP local sur lequel la tlmtrie en direct est reue (lignes "Time,X,Y,Z")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (ClampMin = "1", ClampMax = "65535", EditCondition = "TrajectorySource == ETrajectorySourceType::LiveUdp"))
+	int32 LivePort;
+
+	// chantillons que la file de rception peut retenir entre deux frames
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (ClampMin = "256", EditCondition = "TrajectorySource == ETrajectorySourceType::LiveUdp"))
+	int32 LiveQueueCapacity;
+
+	// Intervalle minimal entre deux reconstructions de la ligne et des waypoints pendant le direct, le suivi d'un fichier
+	// ou un chargement en arrire-plan (secondes)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (ClampMin = "0.0", EditCondition = "TrajectorySource == ETrajectorySourceType::LiveUdp || bWatchFile || bAsyncLoading"))
+	float LiveRefreshInterval;
+
+	// Charger les donnes dans une tche de fond plutt que sur le thread de jeu
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data")
+	bool bAsyncLoading;
+
+	// Dure de trajectoire dj charge ncessaire pour dmarrer la lecture pendant le chargement (secondes)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (ClampMin = "0.0", EditCondition = "bAsyncLoading"))
+	float StreamingStartDuration;
+
+	// Charger avec les autres acteurs du monde via le sous-systme de relecture : toutes les trajectoires en parallle
+	// sous un budget mmoire commun, mais sans dmarrer la lecture avant la fin du chargement (CSV, DataTable, asset)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Data", meta = (EditCondition = "bAsyncLoading"))
+	bool bBatchLoading;
+
 	// ========== VISUALISATION ==========
 
 	// Mesh pour visualiser l'objet qui suit la trajectoire
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Visualization")
 	UStaticMeshComponent* VisualizationMesh;
 
+	// Rendu persistant de la ligne de trajectoire
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Visualization")
+	UTrajectoryPathComponent* TrajectoryPathComponent;
+
+	// Sphres des waypoints, toutes dessines par un seul composant instanci
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Visualization")
+	UInstancedStaticMeshComponent* WaypointMarkers;
+
 	// ========== CONTRLES DE LECTURE ==========
 
 	// Vitesse de lecture (1.0 = temps rel, 2.0 = 2x plus rapide, 0.5 = ralenti)
@@ -51,6 +163,48 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls")
 	bool bReversePlayback;
 
+	// Interpolation entre les chantillons (coefficients calculs une fois au chargement)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls")
+	ETrajectoryInterpolationMode InterpolationMode;
+
+	// Parcourir la trajectoire  vitesse constante (camra de survol), en conservant sa dure totale
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls")
+	bool bConstantSpeed;
+
+	// Rchantillonner la trajectoire au chargement sur une grille rgulire (Hz) : valuation sans recherche
+	// 0 : dsactiv. Le ResampleRate d'un TrajectoryAsset, s'il est renseign, est prioritaire.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls", meta = (ClampMin = "0.0", Units = "Hz"))
+	float ResampleRate;
+
+	// Prcalculer au chargement vitesse, acclration, cap, tangage et distance parcourue (40 octets par chantillon)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls")
+	bool bComputeKinematics;
+
+	// Largeur de la moyenne glissante applique aux positions avant drivation, pour les donnes GPS bruites (secondes, 0 : aucune)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls", meta = (ClampMin = "0.0", EditCondition = "bComputeKinematics"))
+	float KinematicSmoothingWindow;
+
+	// Orienter l'acteur dans le sens du dplacement (cap et tangage prcalculs)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls", meta = (EditCondition = "bComputeKinematics"))
+	bool bOrientAlongPath;
+
+	// Laisser le sous-systme de relecture faire avancer cet acteur (horloge partage, valuation groupe) au lieu de son propre Tick
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Playback Controls")
+	bool bUseReplaySubsystem;
+
+	// Suivre le dernier chantillon reu en direct ; se dplacer dans la timeline repasse dans l'historique
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls")
+	bool bFollowLiveHead;
+
+	// Retard de la tte de lecture sur le dernier chantillon reu, pour interpoler entre deux paquets (secondes)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls", meta = (ClampMin = "0.0"))
+	float LiveDelay;
+
+	// Pendant un dplacement dans la timeline, dlai sans mouvement aprs lequel la position approche
+	// d'une source pagine est remplace par la position exacte (secondes)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Playback Controls", meta = (ClampMin = "0.0"))
+	float ScrubSettleDelay;
+
 	// ========== VISUALISATION DE LA TRAJECTOIRE ==========
 
 	// Afficher la trajectoire complte
@@ -61,8 +215,8 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Visualization")
 	FLinearColor TrajectoryColor;
 
-	// paisseur de la ligne de trajectoire
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Visualization", meta = (ClampMin = "1.0", ClampMax = "20.0"))
+	// Obsolte : la ligne est dessine sur un pixel de large, la valeur ne sert plus que de marge aux bornes
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Visualization", meta = (ClampMin = "1.0", ClampMax = "20.0", DeprecatedProperty, DeprecationMessage = "The trajectory is drawn as a one-pixel GPU line list; thickness no longer changes its width."))
 	float TrajectoryThickness;
 
 	// Afficher des sphres aux points de waypoint
@@ -73,6 +227,19 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Visualization", meta = (ClampMin = "1.0", ClampMax = "50.0"))
 	float WaypointRadius;
 
+	// Colorer les waypoints selon le temps, de TrajectoryColor (dbut)  WaypointEndColor (fin)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Visualization")
+	bool bColorWaypointsByTime;
+
+	// Couleur du dernier waypoint quand bColorWaypointsByTime est activ
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Visualization", meta = (EditCondition = "bColorWaypointsByTime"))
+	FLinearColor WaypointEndColor;
+
+	// Matriau des waypoints ; la couleur de chaque instance est dans PerInstanceCustomData 0  2 (R, G, B)
+	// Sans matriau, les sphres prennent TrajectoryColor via le paramtre Color du matriau de base (pas de dgrad)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trajectory Visualization")
+	UMaterialInterface* WaypointMaterial;
+
 	// ========== INFORMATIONS D'TAT ==========
 
 	// Temps actuel dans la trajectoire (lecture seule)
@@ -83,14 +250,95 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
 	float TotalDuration;
 
+	// Vitesse actuelle en units du monde par seconde (bComputeKinematics, lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	float CurrentSpeed;
+
+	// Norme de l'acclration actuelle en units du monde par seconde (bComputeKinematics, lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	float CurrentAcceleration;
+
+	// Cap et tangage actuels en degrs (bComputeKinematics, lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	float CurrentHeading;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	float CurrentPitch;
+
+	// Distance parcourue depuis le dbut de la trajectoire (bComputeKinematics, lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	float DistanceTravelled;
+
 	// Nombre de points dans la trajectoire (lecture seule)
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
 	int32 WaypointCount;
 
+	// Canaux de tlmtrie de la source charge, dcods au premier accs (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	TArray<FName> TelemetryChannels;
+
+	// tat du chargement des donnes (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	ETrajectoryLoadState LoadState;
+
+	// Progression du chargement de 0.0  1.0 (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	float LoadProgress;
+
+	// cart maximal entre la grille rchantillonne et les chantillons d'origine (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	float ResampleMaxError;
+
+	// Mmoire de la grille rchantillonne en Ko (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	float ResampleMemoryKB;
+
+	// Changements de tronon servis par le prchargement (fichier pagin, lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	int32 PagingHits;
+
+	// Changements de tronon qui ont attendu une lecture disque (fichier pagin, lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	int32 PagingMisses;
+
+	// Mmoire des tronons rsidents en Mo (fichier pagin, lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	float PagingResidentMB;
+
+	// chantillons reus en direct (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	int32 LiveSamplesReceived;
+
+	// chantillons en direct perdus : file pleine, ligne invalide ou temps dj dpass (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	int32 LiveSamplesDropped;
+
+	// Lignes ajoutes au fichier suivi puis ignores : plus anciennes que la fentre de tri ou non finies (lecture seule)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Playback Info")
+	int32 WatchSamplesDropped;
+
+	// ========== VNEMENTS ==========
+	// Diffuss une fois par frame au plus, uniquement quand l'tat a chang
+
+	UPROPERTY(BlueprintAssignable, Category = "Trajectory Playback")
+	FOnReplayTimeChanged OnPlaybackTimeChanged;
+
+	UPROPERTY(BlueprintAssignable, Category = "Trajectory Playback")
+	FOnReplayPlayStateChanged OnPlayStateChanged;
+
+	UPROPERTY(BlueprintAssignable, Category = "Trajectory Playback")
+	FOnReplayVisibilityChanged OnVisibilityChanged;
+
+	UPROPERTY(BlueprintAssignable, Category = "Trajectory Playback")
+	FOnReplayDataReloaded OnDataReloaded;
+
 protected:
 	// Appel quand le jeu commence
 	virtual void BeginPlay() override;
 
+	// Appel quand l'acteur quitte le jeu
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 	// Appel  chaque frame
 	virtual void Tick(float DeltaTime) override;
@@ -117,39 +365,382 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
 	void SeekToProgress(float Progress);
 
+	// Commencer un dplacement continu dans la timeline (curseur saisi) : la lecture est suspendue
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void BeginScrub();
+
+	// Cible du dplacement en cours (0.0  1.0) ; seule la dernire cible de la frame est applique
+	// En dehors d'un dplacement, quivaut  SeekToProgress
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void ScrubToProgress(float Progress);
+
+	// Terminer le dplacement : position exacte  la dernire cible, puis reprise de la lecture
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void EndScrub();
+
+	// Vrai entre BeginScrub et EndScrub
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	bool IsScrubbing() const { return bIsScrubbing; }
+
 	// Obtenir le pourcentage actuel de progression (0.0  1.0)
 	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
 	float GetPlaybackProgress() const;
 
-	// Recharger les donnes depuis le DataTable
+	// Vitesse, acclration, orientation et distance  un temps donn (canaux prcalculs, trajectoire en mmoire)
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	FTrajectoryKinematicState GetKinematicStateAtTime(float Time) const;
+
+	// ========== CANAUX DE TLMTRIE ==========
+
+	// Valeur d'un canal au temps actuel (Float, Double : interpole ; Int, Enum : dernier chantillon atteint)
+	// false si le canal n'existe pas ou, pour un fichier CSV, tant que son dcodage en tche de fond n'est pas termin
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Channels")
+	bool EvaluateChannel(FName Channel, double& Value) const;
+
+	// Valeur d'un canal  un temps donn
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Channels")
+	bool EvaluateChannelAtTime(FName Channel, float Time, double& Value) const;
+
+	// Nom de la valeur d'un canal Enum  un temps donn
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Channels")
+	bool EvaluateEnumChannelAtTime(FName Channel, float Time, FName& Value) const;
+
+	// Type des valeurs d'un canal ; false si le canal n'existe pas
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Channels")
+	bool GetChannelType(FName Channel, ETrajectoryChannelType& Type) const;
+
+	// Lancer le dcodage de plusieurs canaux en une seule lecture de la source, en tche de fond pour un fichier CSV
+	// (sinon chacun est dcod  son premier accs)
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Channels")
+	bool PrefetchChannels(const TArray<FName>& Channels);
+
+	// Vrai si le canal est dcod et peut tre valu ; lance son dcodage sinon
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Channels")
+	bool IsChannelReady(FName Channel) const;
+
+	// Librer les canaux dcods ; ils seront relus depuis la source au prochain accs
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Channels")
+	void ReleaseChannels();
+
+	const FTrajectoryChannelSet& GetTrajectoryChannels() const { return TrajectoryChannels; }
+
+	// ========== POSITIONS GODSIQUES ==========
+
+	// Vrai si la trajectoire vient d'un fichier GPS et que son repre local est connu
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Geodetic")
+	bool IsGeoreferenced() const;
+
+	// Position WGS84 de l'origine du monde ; false si la trajectoire n'est pas gorfrence
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Geodetic")
+	bool GetGeoOrigin(FTrajectoryGeoPosition& OutOrigin) const;
+
+	// Position WGS84 d'un point du monde
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Geodetic")
+	bool LocationToGeo(const FVector& Location, FTrajectoryGeoPosition& OutPosition) const;
+
+	// Point du monde d'une position WGS84
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Geodetic")
+	bool GeoToLocation(const FTrajectoryGeoPosition& Position, FVector& OutLocation) const;
+
+	// Position WGS84 actuelle de l'acteur
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Geodetic")
+	bool GetCurrentGeoPosition(FTrajectoryGeoPosition& OutPosition) const;
+
+	const FTrajectoryGeoReference& GetGeoReference() const { return GeoReference; }
+
+	// Recharger les donnes depuis la source configure
 	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
 	void ReloadTrajectoryData();
 
+	// Charger la trajectoire depuis un fichier CSV  l'excution
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void LoadTrajectoryFromFile(const FString& FilePath);
+
+	// Vrai tant que le chargement en arrire-plan n'est pas termin
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	bool IsTrajectoryLoading() const;
+
+	// Vrai si la trajectoire est reue en direct
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	bool IsLive() const;
+
+	// Revenir au dernier chantillon reu en direct aprs un dplacement dans l'historique
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void FollowLiveHead();
+
+	// crire dans le log la mmoire et l'erreur de rchantillonnage pour plusieurs frquences
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void ReportResampleTradeoff() const;
+
+	// crire la trajectoire charge dans un fichier pagin, en tronons de ChunkDuration secondes
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	bool ExportPagedTrajectory(const FString& FilePath, float ChunkDuration = 60.0f);
+
+	// Passer du Tick de l'acteur au sous-systme de relecture, ou l'inverse
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Playback")
+	void SetUseReplaySubsystem(bool bUseSubsystem);
+
+	// Remplacer la trajectoire par des chantillons dj en mmoire (valids et tris ici)
+	// Appel avant BeginPlay, la source configure n'est pas charge
+	void SetTrajectorySamples(FTrajectorySampleBuffer&& InSamples);
+
 	// Afficher/Cacher la visualisation de la trajectoire
 	UFUNCTION(BlueprintCallable, Category = "Trajectory Visualization")
 	void ToggleTrajectoryVisualization();
 
-	// Dessiner la trajectoire
+	// Reconstruire la gomtrie persistante de la trajectoire (affiche selon bShowTrajectory)
 	UFUNCTION(BlueprintCallable, Category = "Trajectory Visualization")
 	void DrawTrajectoryVisualization();
 
 private:
+	// Le sous-systme avance le temps et value la position des acteurs enregistrs
+	friend class UTrajectoryReplaySubsystem;
+
+	// Mesures de performance (TrajectoryReplayPerfTests.cpp)
+	friend class FTrajectoryReplayPerfRunner;
+
 	// ========== DONNES INTERNES ==========
 
-	// Tableau contenant tous les points de trajectoire
-	TArray<FDroneWaypointRow*> TrajectoryPoints;
+	// chantillons de la trajectoire (copie contigu, trie par temps)
+	FTrajectorySampleBuffer TrajectorySamples;
+
+	// Curseur de lecture : index du dernier segment trouv par CalculatePositionAtTime
+	mutable int32 CachedSegmentIndex;
+
+	// Coefficients de la courbe (modes autres que Linear, ou vitesse constante)
+	FTrajectoryCurve InterpolationCurve;
+
+	// Les chantillons ont chang depuis la construction de la courbe
+	bool bInterpolationCurveDirty;
+
+	// Curseur dans la table d'abscisse curviligne (vitesse constante)
+	mutable int32 CachedArcStepIndex;
+
+	// Canaux cinmatiques des chantillons (bComputeKinematics)
+	FTrajectoryKinematics Kinematics;
+
+	// Les chantillons ont chang depuis le calcul des canaux
+	bool bKinematicsDirty;
+
+	// Fentre de lissage utilise pour les canaux actuels
+	float AppliedKinematicSmoothing;
+
+	// Curseur de segment des canaux
+	int32 CachedKinematicIndex;
+
+	// Canaux de tlmtrie de la source (trajectoires en mmoire hors direct et fichier suivi)
+	FTrajectoryChannelSet TrajectoryChannels;
+
+	// Dernier emplacement calcul pour les canaux : plusieurs canaux lus au mme temps partagent une seule recherche
+	mutable FTrajectorySampleLocation CachedChannelLocation;
+	mutable float CachedChannelTime;
+	mutable bool bChannelLocationValid;
+
+	// Grille rchantillonne (ResampleRate > 0)
+	FTrajectoryResampleCache ResampleCache;
+
+	// Les chantillons ont chang depuis la construction de la grille
+	bool bResampleCacheDirty;
+
+	// Rglages utiliss pour la grille actuelle
+	float AppliedResampleRate;
+	ETrajectoryInterpolationMode AppliedResampleMode;
+
+	// Source pagine (TrajectorySamples reste vide : les positions viennent des tronons rsidents)
+	TSharedPtr<FTrajectoryPagedSource> PagedSource;
+
+	// Rception en direct (les chantillons sont ajouts  TrajectorySamples par PumpLiveSamples)
+	TSharedPtr<FTrajectoryLiveReceiver> LiveReceiver;
+
+	// Suivi d'un fichier CSV qui grandit, et sa lecture en cours en tche de fond
+	TSharedPtr<FTrajectoryCsvTailReader> TailReader;
+	UE::Tasks::TTask<FTrajectoryCsvTailReader::EReadResult> TailReadTask;
+
+	// Fin de la dernire lecture du fichier suivi (FPlatformTime::Seconds)
+	double LastTailPollTime;
+
+	// Dernire reconstruction de la ligne et des waypoints pendant le direct ou le suivi (FPlatformTime::Seconds)
+	double LastGrowthRefreshTime;
+
+	// chantillons en direct arrivs aprs un temps dj reu
+	int32 LiveOutOfOrderCount;
+
+	// Part de cet acteur dans le compteur global des chantillons rsidents
+	int64 ReportedResidentSamples;
+
+	// Incrment  chaque modification de TrajectorySamples (index spatial du sous-systme)
+	uint32 TrajectoryDataRevision;
+
+	// Dplacement dans la timeline en cours (BeginScrub/EndScrub)
+	bool bIsScrubbing;
+
+	// Dernire cible reue, pas encore applique
+	bool bScrubTargetPending;
+	float ScrubTargetTime;
+
+	// La position affiche vient de l'aperu d'une source pagine :  remplacer par la position exacte
+	bool bScrubPreviewShown;
+
+	// Dernire cible reue (FPlatformTime::Seconds)
+	double LastScrubInputTime;
+
+	// Derniers tats diffuss par les vnements
+	float BroadcastPlaybackTime;
+	float BroadcastTotalDuration;
+	bool bBroadcastIsPlaying;
+	bool bBroadcastShowTrajectory;
+
+	// Chargement en cours en arrire-plan
+	TSharedPtr<FTrajectoryLoader> ActiveLoader;
+
+	// Mission du chargement par lots du sous-systme en cours, ou INDEX_NONE
+	int32 BatchMissionIndex;
+
+	// Repre local des fichiers GPS (invalide pour les autres sources)
+	FTrajectoryGeoReference GeoReference;
+
+	// Dbut du chargement en cours (pour les statistiques)
+	double LoadStartTime;
+
+	// La lecture dmarrera ds que suffisamment de donnes seront charges
+	bool bPlayWhenReady;
+
+	// Acteur actuellement pilot par le sous-systme de relecture
+	bool bRegisteredWithSubsystem;
+
+	// Les donnes ont chang depuis la dernire construction de la gomtrie
+	bool bTrajectoryPathDirty;
+
+	// Style appliqu au composant de trajectoire
+	FLinearColor AppliedTrajectoryColor;
+	float AppliedTrajectoryThickness;
+
+	// Les donnes ont chang depuis la dernire construction des instances de waypoints
+	bool bWaypointMarkersDirty;
+
+	// Rayon et couleurs appliqus aux instances de waypoints
+	float AppliedWaypointRadius;
+	FLinearColor AppliedWaypointStartColor;
+	FLinearColor AppliedWaypointEndColor;
+	bool bAppliedColorWaypointsByTime;
+
+	// Matriau utilis quand WaypointMaterial n'est pas dfini : le matriau de base de la sphre ignore PerInstanceCustomData
+	UPROPERTY(Transient)
+	UMaterialInstanceDynamic* WaypointFallbackMaterial;
 
 	// ========== FONCTIONS INTERNES ==========
 
-	// Charger les points depuis le DataTable
+	// Charger les points depuis la source configure (en arrire-plan si bAsyncLoading)
 	void LoadTrajectoryPoints();
 
+	// Dcrire la source configure pour le loader ; faux si elle n'est pas assigne
+	bool MakeLoadRequest(FTrajectoryLoadRequest& OutRequest) const;
+
+	// Intgrer les lots dj chargs et finaliser le chargement en arrire-plan
+	void PumpAsyncLoad();
+
+	// Ajouter au buffer les chantillons reus en direct depuis la dernire frame
+	void PumpLiveSamples();
+
+	// Intgrer la dernire lecture du fichier suivi et lancer la suivante
+	void PumpTailReader();
+
+	// Lire la fin du fichier suivi en tche de fond
+	void LaunchTailRead();
+
+	// Sous-systme qui porte le repre GPS partag ; nullptr si bUseGeoOrigin ou !bShareGeoOrigin
+	UTrajectoryReplaySubsystem* GetSharedGeoOriginSubsystem() const;
+
+	// Arrter le direct et le suivi de fichier
+	void StopGrowingSources();
+
+	// Vrai pendant le direct ou le suivi d'un fichier : la trajectoire grandit  chaque frame
+	bool IsTrajectoryGrowing() const;
+
+	// Statistiques aprs un ajout d'chantillons ; gomtrie reconstruite au plus toutes les LiveRefreshInterval secondes
+	void OnTrajectoryGrown();
+
+	// Annuler le chargement en arrire-plan en cours
+	void CancelAsyncLoad();
+
+	// Recevoir le rsultat du chargement par lots (appel par le sous-systme)
+	void FinishBatchLoad(bool bSucceeded, FTrajectorySampleBuffer&& InSamples);
+
+	// Terminer un chargement : statistiques et tat
+	void FinishLoad(bool bSucceeded);
+
+	// Lister les canaux de tlmtrie de la source charge (sans dcoder leurs valeurs)
+	void OpenTrajectoryChannels();
+
+	// chantillons encadrant le temps, avec le curseur de l'valuation de position ; false sans chantillon en mmoire
+	bool LocateChannelSample(float Time, FTrajectorySampleLocation& OutLocation) const;
+
+	// Mettre  jour WaypointCount et TotalDuration depuis le buffer
+	void RefreshTrajectoryStats();
+
+	// chantillons en mmoire : buffer complet ou tronons rsidents
+	int64 GetResidentSampleCount() const;
+
+	// Mettre  jour la part de cet acteur dans "Samples Resident" (stat DataReplay et Insights)
+	void ReportResidentSamples(int64 ResidentSamples);
+
+	// Vrai si assez de donnes sont charges pour lire pendant le chargement
+	bool CanStartStreamingPlayback() const;
+
+	// Chargement, visualisation et avance du temps d'une frame ; vrai si la position doit tre mise  jour
+	bool AdvancePlayback(float DeltaTime);
+
 	// Calculer la position interpole  un temps donn
 	FVector CalculatePositionAtTime(float Time) const;
 
+	// Reconstruire la courbe si les chantillons, le mode d'interpolation ou bConstantSpeed ont chang
+	void UpdateInterpolationCurve();
+
+	// Reconstruire la grille si les chantillons, la frquence ou le mode d'interpolation ont chang
+	void UpdateResampleCache();
+
+	// Frquence de rchantillonnage en vigueur (celle de l'asset en priorit)
+	float GetEffectiveResampleRate() const;
+
+	// Prparer le tronon du temps actuel et prcharger la suite (source pagine)
+	void UpdatePagedSource();
+
+	// Rsoudre un chemin relatif depuis le dossier du projet
+	static FString ResolveProjectPath(const FString& Path);
+
 	// Mettre  jour la position de l'acteur selon le temps actuel
 	void UpdateActorPosition();
 
+	// Recalculer les canaux si les chantillons, bComputeKinematics ou la fentre de lissage ont chang
+	void UpdateKinematics();
+
+	// Placer l'acteur  la position value, avec l'orientation et les grandeurs cinmatiques du temps actuel
+	void ApplyPosition(const FVector& Position);
+
+	// Synchroniser la visualisation persistante (reconstruction uniquement si donnes ou style modifis)
+	void UpdateTrajectoryVisualization();
+
+	// Recrer une instance par waypoint (aprs un chargement)
+	void RebuildWaypointMarkers();
+
+	// Mettre  jour la taille des instances sans les recrer
+	void UpdateWaypointMarkerTransforms();
+
+	// Mettre  jour les couleurs des instances (donnes personnalises, sans draw call supplmentaire)
+	void UpdateWaypointMarkerColors();
+
+	// Matriau des sphres : WaypointMaterial, sinon une instance dynamique colore par TrajectoryColor
+	UMaterialInterface* GetWaypointMarkerMaterial();
+
+	// Transformation de l'instance d'un waypoint (sphre de rayon WaypointRadius)
+	FTransform GetWaypointMarkerTransform(int32 Index) const;
+
+	// Appliquer la dernire cible du dplacement en cours, ou la position exacte une fois le curseur immobile
+	void UpdateScrub();
+
 	// Valider et limiter le temps actuel dans les bornes valides
 	void ClampCurrentTime();
+
+	// Diffuser les vnements dont l'tat a chang depuis le dernier appel
+	void BroadcastStateChanges();
 };
\ No newline at end of file
@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryReplayBenchmark.h"
+#include "DataReplay.h"
+#include "TrajectoryReplayActor.h"
+#include "TrajectoryReplaySubsystem.h"
+#include "TrajectorySampleBuffer.h"
+#include "Engine/World.h"
+#include "RenderCore.h"
+
+ATrajectoryReplayBenchmark::ATrajectoryReplayBenchmark()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	ActorCount = 1000;
+	SamplesPerActor = 3600;
+	SampleInterval = 0.1f;
+	GridSpacing = 500.0f;
+	WarmupFrames = 60;
+	MeasuredFrames = 600;
+	bDestroyActorsWhenDone = true;
+
+	ActorTickGameThreadMs = 0.0f;
+	SubsystemGameThreadMs = 0.0f;
+	SubsystemUpdateMs = 0.0f;
+
+	Phase = EPhase::Done;
+	PhaseFrame = 0;
+	AccumulatedGameThreadMs = 0.0;
+	AccumulatedSubsystemMs = 0.0;
+}
+
+void ATrajectoryReplayBenchmark::BeginPlay()
+{
+	Super::BeginPlay();
+
+	SpawnFleet();
+	SetFleetUsesSubsystem(false);
+	EnterPhase(EPhase::ActorTickWarmup);
+
+	UE_LOG(LogDataReplay, Log, TEXT("[ReplayBenchmark] %d actors x %d samples spawned, measuring %d frames per mode"),
+		Fleet.Num(), SamplesPerActor, MeasuredFrames);
+}
+
+void ATrajectoryReplayBenchmark::SpawnFleet()
+{
+	UWorld* World = GetWorld();
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(ActorCount)));
+
+	Fleet.Reserve(ActorCount);
+	for (int32 ActorIndex = 0; ActorIndex < ActorCount; ActorIndex++)
+	{
+		// Trajectoire synthétique : orbite autour d'une case de la grille, décalée en phase
+		const FVector Center = GetActorLocation() + FVector((ActorIndex % GridSize) * GridSpacing, (ActorIndex / GridSize) * GridSpacing, 200.0f);
+		const float Radius = GridSpacing * 0.4f;
+		const float Phase0 = ActorIndex * 0.37f;
+
+		FTrajectorySampleBuffer Samples;
+		Samples.Reserve(SamplesPerActor);
+		for (int32 i = 0; i < SamplesPerActor; i++)
+		{
+			const float Time = i * SampleInterval;
+			const float Angle = Phase0 + Time * 0.5f;
+			Samples.Add(Time,
+				Center.X + Radius * FMath::Cos(Angle),
+				Center.Y + Radius * FMath::Sin(Angle),
+				Center.Z + 50.0f * FMath::Sin(Angle * 2.0f));
+		}
+
+		ATrajectoryReplayActor* Actor = World->SpawnActorDeferred<ATrajectoryReplayActor>(ATrajectoryReplayActor::StaticClass(), FTransform(Center));
+		if (!Actor)
+		{
+			continue;
+		}
+
+		Actor->bUseReplaySubsystem = false;
+		Actor->bLoopPlayback = true;
+		Actor->SetTrajectorySamples(MoveTemp(Samples));
+		Actor->FinishSpawning(FTransform(Center));
+		Actor->Play();
+		Fleet.Add(Actor);
+	}
+}
+
+void ATrajectoryReplayBenchmark::SetFleetUsesSubsystem(bool bUseSubsystem)
+{
+	for (ATrajectoryReplayActor* Actor : Fleet)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->SetUseReplaySubsystem(bUseSubsystem);
+		}
+	}
+}
+
+void ATrajectoryReplayBenchmark::EnterPhase(EPhase NewPhase)
+{
+	Phase = NewPhase;
+	PhaseFrame = 0;
+	AccumulatedGameThreadMs = 0.0;
+	AccumulatedSubsystemMs = 0.0;
+}
+
+void ATrajectoryReplayBenchmark::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Phase == EPhase::Done)
+	{
+		return;
+	}
+
+	// Temps du thread de jeu de la frame précédente (même mesure que "stat unit")
+	const double GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	const UTrajectoryReplaySubsystem* Subsystem = GetWorld()->GetSubsystem<UTrajectoryReplaySubsystem>();
+	PhaseFrame++;
+
+	switch (Phase)
+	{
+	case EPhase::ActorTickWarmup:
+		if (PhaseFrame >= WarmupFrames)
+		{
+			EnterPhase(EPhase::ActorTickMeasure);
+		}
+		break;
+
+	case EPhase::ActorTickMeasure:
+		AccumulatedGameThreadMs += GameThreadMs;
+		if (PhaseFrame >= MeasuredFrames)
+		{
+			ActorTickGameThreadMs = static_cast<float>(AccumulatedGameThreadMs / MeasuredFrames);
+			SetFleetUsesSubsystem(true);
+			EnterPhase(EPhase::SubsystemWarmup);
+		}
+		break;
+
+	case EPhase::SubsystemWarmup:
+		if (PhaseFrame >= WarmupFrames)
+		{
+			EnterPhase(EPhase::SubsystemMeasure);
+		}
+		break;
+
+	case EPhase::SubsystemMeasure:
+		AccumulatedGameThreadMs += GameThreadMs;
+		AccumulatedSubsystemMs += Subsystem ? Subsystem->GetLastUpdateMilliseconds() : 0.0f;
+		if (PhaseFrame >= MeasuredFrames)
+		{
+			SubsystemGameThreadMs = static_cast<float>(AccumulatedGameThreadMs / MeasuredFrames);
+			SubsystemUpdateMs = static_cast<float>(AccumulatedSubsystemMs / MeasuredFrames);
+			EnterPhase(EPhase::Done);
+
+			UE_LOG(LogDataReplay, Log, TEXT("[ReplayBenchmark] %d actors: actor Tick %.3f ms/frame, subsystem %.3f ms/frame (subsystem update %.3f ms)"),
+				Fleet.Num(), ActorTickGameThreadMs, SubsystemGameThreadMs, SubsystemUpdateMs);
+
+			if (bDestroyActorsWhenDone)
+			{
+				for (ATrajectoryReplayActor* Actor : Fleet)
+				{
+					if (IsValid(Actor))
+					{
+						Actor->Destroy();
+					}
+				}
+				Fleet.Reset();
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+}
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TrajectoryReplayBenchmark.generated.h"
+
+class ATrajectoryReplayActor;
+
+/**
+ * Scène de mesure : fait apparaître une flotte d'acteurs de trajectoire synthétiques,
+ * puis compare le temps du thread de jeu avec le Tick de chaque acteur et avec le sous-système de relecture.
+ * Il suffit de placer cet acteur dans un niveau vide et de lancer le jeu ; les résultats sont écrits dans le log.
+ */
+UCLASS()
+class DATAREPLAY_API ATrajectoryReplayBenchmark : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ATrajectoryReplayBenchmark();
+
+	// ========== CONFIGURATION ==========
+
+	// Nombre d'acteurs de trajectoire à faire apparaître
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "1"))
+	int32 ActorCount;
+
+	// Nombre d'échantillons par trajectoire
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "2"))
+	int32 SamplesPerActor;
+
+	// Intervalle entre deux échantillons (secondes)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "0.001"))
+	float SampleInterval;
+
+	// Espacement de la grille sur laquelle les acteurs sont répartis
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "1.0"))
+	float GridSpacing;
+
+	// Frames ignorées après chaque changement de mode
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "0"))
+	int32 WarmupFrames;
+
+	// Frames mesurées pour chaque mode
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark", meta = (ClampMin = "1"))
+	int32 MeasuredFrames;
+
+	// Détruire la flotte à la fin de la mesure
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Benchmark")
+	bool bDestroyActorsWhenDone;
+
+	// ========== RÉSULTATS ==========
+
+	// Temps moyen du thread de jeu avec le Tick de chaque acteur (millisecondes)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Benchmark Results")
+	float ActorTickGameThreadMs;
+
+	// Temps moyen du thread de jeu avec le sous-système de relecture (millisecondes)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Benchmark Results")
+	float SubsystemGameThreadMs;
+
+	// Temps moyen de la mise à jour du sous-système seule (millisecondes)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Benchmark Results")
+	float SubsystemUpdateMs;
+
+protected:
+	virtual void BeginPlay() override;
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+private:
+	enum class EPhase : uint8
+	{
+		ActorTickWarmup,
+		ActorTickMeasure,
+		SubsystemWarmup,
+		SubsystemMeasure,
+		Done
+	};
+
+	// Faire apparaître la flotte avec des trajectoires synthétiques
+	void SpawnFleet();
+
+	// Passer tous les acteurs au Tick individuel ou au sous-système
+	void SetFleetUsesSubsystem(bool bUseSubsystem);
+
+	void EnterPhase(EPhase NewPhase);
+
+	UPROPERTY(Transient)
+	TArray<ATrajectoryReplayActor*> Fleet;
+
+	EPhase Phase;
+	int32 PhaseFrame;
+	double AccumulatedGameThreadMs;
+	double AccumulatedSubsystemMs;
+};
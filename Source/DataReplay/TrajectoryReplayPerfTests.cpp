@@ -0,0 +1,773 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "DataReplay.h"
+#include "TrajectoryReplayActor.h"
+#include "TrajectoryAsset.h"
+#include "TrajectoryCompression.h"
+#include "TrajectoryPagedSource.h"
+#include "TrajectorySampleBuffer.h"
+#include "DroneWaypointStruct.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Algo/Reverse.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProperties.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/ObjectReader.h"
+#include "Serialization/ObjectWriter.h"
+#include "Engine/DataTable.h"
+
+/**
+ * Mesures de performance de la relecture, sans rendu :
+ *   UnrealEditor-Cmd DataReplay.uproject -ExecCmds="Automation RunTests DataReplay.Performance; Quit" -nullrhi -unattended
+ *
+ * Trajectoires synthétiques de 1k à 10M échantillons (vol lisse à 100 Hz). Pour chaque taille :
+ *   - chargement par LoadTrajectoryPoints depuis chaque source (CSV, asset brut, asset compressé, fichier paginé) ;
+ *   - jusqu'à 1M échantillons, DataTable contre asset : désérialisation des lignes, chargement et mémoire résidente ;
+ *   - coût d'un appel à CalculatePositionAtTime en lecture avant, en lecture arrière et en accès aléatoire ;
+ *   - coût du Tick d'un acteur en lecture ;
+ *   - coût de DrawTrajectoryVisualization.
+ * Les résultats sont écrits en JSON pour suivre les régressions d'une version à l'autre.
+ *
+ * DataReplay.Performance.Layout compare, à partir de 1M échantillons, l'ancien stockage (pointeurs vers des lignes
+ * FDroneWaypointRow allouées une à une, comme celles d'un DataTable) et FTrajectorySampleBuffer.
+ */
+
+static TAutoConsoleVariable<int32> CVarReplayBenchmarkMaxSamples(
+	TEXT("DataReplay.Benchmark.MaxSamples"),
+	10 * 1000 * 1000,
+	TEXT("Plus grande trajectoire mesurée par DataReplay.Performance (échantillons, de 1k à 10M par puissances de 10)."));
+
+static TAutoConsoleVariable<int32> CVarReplayBenchmarkEvaluations(
+	TEXT("DataReplay.Benchmark.Evaluations"),
+	1000 * 1000,
+	TEXT("Appels à CalculatePositionAtTime mesurés pour chaque parcours (avant, arrière, aléatoire)."));
+
+static TAutoConsoleVariable<FString> CVarReplayBenchmarkOutputFile(
+	TEXT("DataReplay.Benchmark.OutputFile"),
+	TEXT(""),
+	TEXT("Fichier JSON des résultats de DataReplay.Performance. Vide : Saved/Benchmarks/DataReplay-<date>.json."));
+
+/**
+ * Accès aux fonctions internes de ATrajectoryReplayActor pour la mesure (ami de la classe)
+ */
+class FTrajectoryReplayPerfRunner
+{
+public:
+	FTrajectoryReplayPerfRunner(FAutomationTestBase& InTest, UWorld* InWorld, const FString& InTempDir)
+		: Test(InTest)
+		, World(InWorld)
+		, TempDir(InTempDir)
+	{
+	}
+
+	// Mesurer une taille de trajectoire et écrire son objet JSON
+	void Run(int32 SampleCount, TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>& Json)
+	{
+		FTrajectorySampleBuffer Samples;
+		FTrajectoryCompressedSamples::MakeSyntheticFlight(SampleCount, 100.0f, SampleCount, Samples);
+
+		ATrajectoryReplayActor* Actor = World->SpawnActorDeferred<ATrajectoryReplayActor>(ATrajectoryReplayActor::StaticClass(), FTransform::Identity);
+		if (!Actor)
+		{
+			Test.AddError(TEXT("Cannot spawn ATrajectoryReplayActor"));
+			return;
+		}
+		Actor->bUseReplaySubsystem = false;
+		Actor->bAsyncLoading = false;
+		Actor->bLoopPlayback = true;
+		Actor->SetTrajectorySamples(FTrajectorySampleBuffer(Samples));
+		Actor->FinishSpawning(FTransform::Identity);
+
+		// Petites trajectoires : meilleure de plusieurs mesures ; grandes : une seule
+		const int32 Repeats = SampleCount <= 100 * 1000 ? 5 : 1;
+
+		Json.WriteObjectStart();
+		Json.WriteValue(TEXT("samples"), SampleCount);
+		Json.WriteValue(TEXT("duration_s"), Samples.GetEndTime() - Samples.GetStartTime());
+
+		Json.WriteObjectStart(TEXT("load_ms"));
+		MeasureLoads(Actor, Samples, Repeats, Json);
+		Json.WriteObjectEnd();
+
+		// Les mesures suivantes portent sur la trajectoire en mémoire
+		Actor->TrajectorySource = ETrajectorySourceType::DataTable;
+		Actor->SetTrajectorySamples(MoveTemp(Samples));
+
+		Json.WriteObjectStart(TEXT("evaluate_ns_per_call"));
+		MeasureEvaluation(Actor, Json);
+		Json.WriteObjectEnd();
+
+		Json.WriteObjectStart(TEXT("tick_us"));
+		MeasureTick(Actor, Json);
+		Json.WriteObjectEnd();
+
+		Json.WriteObjectStart(TEXT("draw_visualization_ms"));
+		MeasureDraw(Actor, Repeats, Json);
+		Json.WriteObjectEnd();
+
+		Json.WriteObjectEnd();
+
+		Actor->Destroy();
+	}
+
+private:
+	// ========== CHARGEMENT ==========
+
+	void MeasureLoads(ATrajectoryReplayActor* Actor, const FTrajectorySampleBuffer& Samples, int32 Repeats, TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>& Json)
+	{
+		const int32 SampleCount = Samples.Num();
+
+		// Fichier CSV
+		const FString CsvPath = FPaths::Combine(TempDir, FString::Printf(TEXT("Trajectory_%d.csv"), SampleCount));
+		if (WriteCsv(CsvPath, Samples))
+		{
+			Actor->TrajectorySource = ETrajectorySourceType::CsvFile;
+			Actor->TrajectoryFilePath.FilePath = CsvPath;
+			Json.WriteValue(TEXT("csv"), TimeLoad(Actor, TEXT("CSV"), SampleCount, Repeats));
+			IFileManager::Get().Delete(*CsvPath);
+		}
+
+		// DataTable de FDroneWaypointRow (une allocation et un nom par ligne), limité à 1M lignes
+		if (SampleCount <= 1000 * 1000)
+		{
+			MeasureDataTable(Actor, Samples, Repeats, Json);
+		}
+
+		// Asset brut, puis compressé
+		UTrajectoryAsset* Asset = NewObject<UTrajectoryAsset>(GetTransientPackage());
+		Actor->TrajectorySource = ETrajectorySourceType::Asset;
+		Actor->TrajectoryAsset = Asset;
+
+		Asset->CompressionErrorBound = 0.0f;
+		Asset->SetSamples(Samples);
+		Json.WriteValue(TEXT("asset_raw"), TimeLoad(Actor, TEXT("raw asset"), SampleCount, Repeats));
+
+		// Bloc bulk : la seule donnée de l'asset proportionnelle aux échantillons, libérée après la copie si l'asset vient d'un paquet
+		Json.WriteValue(TEXT("asset_raw_payload_bytes"), static_cast<int64>(SampleCount) * 4 * sizeof(float));
+
+		Asset->CompressionErrorBound = 0.5f;
+		Asset->SetSamples(Samples);
+		Json.WriteValue(TEXT("asset_compressed"), TimeLoad(Actor, TEXT("compressed asset"), SampleCount, Repeats));
+		Json.WriteValue(TEXT("asset_compression_ratio"), Asset->CompressionRatio);
+
+		Actor->TrajectoryAsset = nullptr;
+		Asset->MarkAsGarbage();
+
+		// Fichier paginé : seuls l'en-tête et le premier tronçon sont lus au chargement
+		const FString PagedPath = FPaths::Combine(TempDir, FString::Printf(TEXT("Trajectory_%d.dtraj"), SampleCount));
+		if (FTrajectoryPagedSource::WriteFile(PagedPath, Samples, 60.0f))
+		{
+			Actor->TrajectorySource = ETrajectorySourceType::PagedFile;
+			Actor->PagedFilePath.FilePath = PagedPath;
+			Json.WriteValue(TEXT("paged_open"), TimeLoad(Actor, TEXT("paged file"), INDEX_NONE, Repeats));
+			// Fermer le fichier avant de le supprimer
+			Actor->PagedSource.Reset();
+			IFileManager::Get().Delete(*PagedPath);
+		}
+		else
+		{
+			Test.AddError(FString::Printf(TEXT("Cannot write %s"), *PagedPath));
+		}
+	}
+
+	/**
+	 * Chemin DataTable : désérialisation des lignes (propriétés étiquetées, comme au chargement du paquet),
+	 * puis LoadTrajectoryPoints, et mémoire du DataTable qui reste chargé pendant toute la relecture
+	 */
+	void MeasureDataTable(ATrajectoryReplayActor* Actor, const FTrajectorySampleBuffer& Samples, int32 Repeats, TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>& Json)
+	{
+		const int32 SampleCount = Samples.Num();
+
+		UDataTable* Table = NewObject<UDataTable>(GetTransientPackage());
+		Table->RowStruct = FDroneWaypointRow::StaticStruct();
+		FDroneWaypointRow Row;
+		for (int32 i = 0; i < SampleCount; i++)
+		{
+			Row.Time = Samples.Times[i];
+			Row.X = Samples.PosX[i];
+			Row.Y = Samples.PosY[i];
+			Row.Z = Samples.PosZ[i];
+			Table->AddRow(FName(TEXT("Waypoint"), i + 1), Row);
+		}
+
+		TArray<uint8> Bytes;
+		FObjectWriter Writer(Table, Bytes);
+
+		double BestDeserializeMs = TNumericLimits<double>::Max();
+		UDataTable* LoadedTable = nullptr;
+		for (int32 Repeat = 0; Repeat < Repeats; Repeat++)
+		{
+			if (LoadedTable)
+			{
+				LoadedTable->MarkAsGarbage();
+			}
+			LoadedTable = NewObject<UDataTable>(GetTransientPackage());
+
+			const double Start = FPlatformTime::Seconds();
+			FObjectReader Reader(LoadedTable, Bytes);
+			BestDeserializeMs = FMath::Min(BestDeserializeMs, (FPlatformTime::Seconds() - Start) * 1000.0);
+		}
+		Json.WriteValue(TEXT("datatable_deserialize"), BestDeserializeMs);
+
+		Actor->TrajectorySource = ETrajectorySourceType::DataTable;
+		Actor->TrajectoryData = LoadedTable;
+		Json.WriteValue(TEXT("datatable"), TimeLoad(Actor, TEXT("DataTable"), SampleCount, Repeats));
+		Json.WriteValue(TEXT("datatable_serialized_bytes"), static_cast<int64>(Bytes.Num()));
+		Json.WriteValue(TEXT("datatable_resident_bytes"), static_cast<int64>(LoadedTable->GetResourceSizeBytes(EResourceSizeMode::Exclusive)));
+
+		UE_LOG(LogDataReplay, Log, TEXT("[ReplayBenchmark] %d rows: DataTable %.1f MB serialized, %.1f MB resident (asset payload: %.1f MB)"),
+			SampleCount, Bytes.Num() / (1024.0 * 1024.0), LoadedTable->GetResourceSizeBytes(EResourceSizeMode::Exclusive) / (1024.0 * 1024.0),
+			SampleCount * 4.0 * sizeof(float) / (1024.0 * 1024.0));
+
+		Actor->TrajectoryData = nullptr;
+		LoadedTable->MarkAsGarbage();
+		Table->MarkAsGarbage();
+	}
+
+	// Meilleure durée de LoadTrajectoryPoints (millisecondes) ; ExpectedCount : INDEX_NONE pour ne pas vérifier
+	double TimeLoad(ATrajectoryReplayActor* Actor, const TCHAR* Label, int32 ExpectedCount, int32 Repeats)
+	{
+		double BestMs = TNumericLimits<double>::Max();
+		for (int32 Repeat = 0; Repeat < Repeats; Repeat++)
+		{
+			const double Start = FPlatformTime::Seconds();
+			Actor->LoadTrajectoryPoints();
+			BestMs = FMath::Min(BestMs, (FPlatformTime::Seconds() - Start) * 1000.0);
+
+			if (Actor->LoadState != ETrajectoryLoadState::Loaded || (ExpectedCount != INDEX_NONE && Actor->WaypointCount != ExpectedCount))
+			{
+				Test.AddError(FString::Printf(TEXT("%s load failed (%d samples loaded, %d expected)"), Label, Actor->WaypointCount, ExpectedCount));
+				break;
+			}
+		}
+		return BestMs;
+	}
+
+	bool WriteCsv(const FString& Path, const FTrajectorySampleBuffer& Samples)
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Path));
+		if (!Writer)
+		{
+			Test.AddError(FString::Printf(TEXT("Cannot write %s"), *Path));
+			return false;
+		}
+
+		// Écriture par blocs d'environ 1 Mo
+		TArray<ANSICHAR> Buffer;
+		Buffer.Reserve(1024 * 1024 + 256);
+		Buffer.Append("Time,X,Y,Z\n", 11);
+
+		ANSICHAR Line[128];
+		for (int32 i = 0; i < Samples.Num(); i++)
+		{
+			const int32 Length = FCStringAnsi::Snprintf(Line, UE_ARRAY_COUNT(Line), "%.4f,%.3f,%.3f,%.3f\n",
+				Samples.Times[i], Samples.PosX[i], Samples.PosY[i], Samples.PosZ[i]);
+			Buffer.Append(Line, Length);
+
+			if (Buffer.Num() >= 1024 * 1024)
+			{
+				Writer->Serialize(Buffer.GetData(), Buffer.Num());
+				Buffer.Reset();
+			}
+		}
+		Writer->Serialize(Buffer.GetData(), Buffer.Num());
+		return Writer->Close();
+	}
+
+	// ========== ÉVALUATION ==========
+
+	void MeasureEvaluation(ATrajectoryReplayActor* Actor, TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>& Json)
+	{
+		// Construire la courbe et la grille éventuelles avant de mesurer
+		Actor->UpdateInterpolationCurve();
+		Actor->UpdateResampleCache();
+
+		const int32 Calls = FMath::Max(CVarReplayBenchmarkEvaluations.GetValueOnGameThread(), 1);
+		const float StartTime = Actor->TrajectorySamples.GetStartTime();
+		const float Duration = Actor->TrajectorySamples.GetEndTime() - StartTime;
+		const float Step = Duration / Calls;
+
+		TArray<float> Times;
+		Times.SetNumUninitialized(Calls);
+
+		// Lecture avant : pas réguliers couvrant toute la trajectoire
+		for (int32 i = 0; i < Calls; i++)
+		{
+			Times[i] = StartTime + i * Step;
+		}
+		Json.WriteValue(TEXT("sequential"), TimeEvaluations(Actor, Times));
+
+		// Lecture arrière
+		Algo::Reverse(Times);
+		Json.WriteValue(TEXT("reverse"), TimeEvaluations(Actor, Times));
+
+		// Déplacements aléatoires dans la timeline
+		FRandomStream Random(Calls);
+		for (float& Time : Times)
+		{
+			Time = StartTime + Random.FRand() * Duration;
+		}
+		Json.WriteValue(TEXT("random_seek"), TimeEvaluations(Actor, Times));
+	}
+
+	// Coût moyen d'un appel (nanosecondes)
+	double TimeEvaluations(ATrajectoryReplayActor* Actor, const TArray<float>& Times)
+	{
+		Actor->CachedSegmentIndex = 0;
+		Actor->CachedArcStepIndex = 0;
+
+		// La somme des positions empêche le compilateur d'écarter les appels
+		FVector Sum = FVector::ZeroVector;
+		const double Start = FPlatformTime::Seconds();
+		for (const float Time : Times)
+		{
+			Sum += Actor->CalculatePositionAtTime(Time);
+		}
+		const double Seconds = FPlatformTime::Seconds() - Start;
+
+		Test.TestFalse(TEXT("Evaluated positions are finite"), Sum.ContainsNaN());
+		return Seconds * 1.0e9 / FMath::Max(Times.Num(), 1);
+	}
+
+	// ========== TICK ET VISUALISATION ==========
+
+	void MeasureTick(ATrajectoryReplayActor* Actor, TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>& Json)
+	{
+		static constexpr int32 WarmupTicks = 60;
+		static constexpr int32 MeasuredTicks = 10000;
+		static constexpr float DeltaTime = 1.0f / 60.0f;
+
+		Actor->SeekToTime(0.0f);
+		Actor->Play();
+
+		for (int32 i = 0; i < WarmupTicks; i++)
+		{
+			Actor->Tick(DeltaTime);
+		}
+
+		TArray<double> Durations;
+		Durations.SetNumUninitialized(MeasuredTicks);
+		for (int32 i = 0; i < MeasuredTicks; i++)
+		{
+			const double Start = FPlatformTime::Seconds();
+			Actor->Tick(DeltaTime);
+			Durations[i] = (FPlatformTime::Seconds() - Start) * 1.0e6;
+		}
+		Actor->Pause();
+
+		WriteDistribution(Durations, Json);
+	}
+
+	void MeasureDraw(ATrajectoryReplayActor* Actor, int32 Repeats, TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>& Json)
+	{
+		TArray<double> Durations;
+		for (int32 Repeat = 0; Repeat < Repeats; Repeat++)
+		{
+			const double Start = FPlatformTime::Seconds();
+			Actor->DrawTrajectoryVisualization();
+			Durations.Add((FPlatformTime::Seconds() - Start) * 1000.0);
+		}
+
+		WriteDistribution(Durations, Json);
+	}
+
+	// Moyenne, médiane, 99e centile et maximum
+	static void WriteDistribution(TArray<double>& Values, TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>& Json)
+	{
+		if (Values.Num() == 0)
+		{
+			return;
+		}
+
+		Values.Sort();
+		double Total = 0.0;
+		for (const double Value : Values)
+		{
+			Total += Value;
+		}
+
+		Json.WriteValue(TEXT("mean"), Total / Values.Num());
+		Json.WriteValue(TEXT("median"), Values[Values.Num() / 2]);
+		Json.WriteValue(TEXT("p99"), Values[FMath::Min(Values.Num() - 1, (Values.Num() * 99) / 100)]);
+		Json.WriteValue(TEXT("max"), Values.Last());
+	}
+
+	FAutomationTestBase& Test;
+	UWorld* World;
+	FString TempDir;
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrajectoryReplayPerformanceTest, "DataReplay.Performance.Replay",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FTrajectoryReplayPerformanceTest::RunTest(const FString& Parameters)
+{
+	if (!GEngine)
+	{
+		AddError(TEXT("The replay benchmark needs an engine"));
+		return false;
+	}
+
+	const FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"));
+	const FString TempDir = FPaths::Combine(OutputDir, TEXT("Temp"));
+	IFileManager::Get().MakeDirectory(*TempDir, true);
+
+	// Monde de jeu isolé, sans niveau
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("DataReplayBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	FString JsonText;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Json = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&JsonText);
+
+	Json->WriteObjectStart();
+	Json->WriteValue(TEXT("benchmark"), TEXT("DataReplay.Performance.Replay"));
+	Json->WriteValue(TEXT("date"), FDateTime::UtcNow().ToIso8601());
+	Json->WriteValue(TEXT("engine_version"), FEngineVersion::Current().ToString());
+	Json->WriteValue(TEXT("build_configuration"), LexToString(FApp::GetBuildConfiguration()));
+	Json->WriteValue(TEXT("platform"), FPlatformProperties::IniPlatformName());
+	Json->WriteValue(TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+	Json->WriteValue(TEXT("cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	Json->WriteValue(TEXT("evaluations_per_pattern"), FMath::Max(CVarReplayBenchmarkEvaluations.GetValueOnGameThread(), 1));
+
+	Json->WriteArrayStart(TEXT("results"));
+	FTrajectoryReplayPerfRunner Runner(*this, World, TempDir);
+	const int32 MaxSamples = CVarReplayBenchmarkMaxSamples.GetValueOnGameThread();
+	for (int32 SampleCount = 1000; SampleCount <= MaxSamples; SampleCount *= 10)
+	{
+		UE_LOG(LogDataReplay, Log, TEXT("[ReplayBenchmark] Measuring %d samples"), SampleCount);
+		Runner.Run(SampleCount, *Json);
+
+		if (SampleCount > MAX_int32 / 10)
+		{
+			break;
+		}
+	}
+	Json->WriteArrayEnd();
+	Json->WriteObjectEnd();
+	Json->Close();
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	IFileManager::Get().DeleteDirectory(*TempDir, false, true);
+
+	FString OutputFile = CVarReplayBenchmarkOutputFile.GetValueOnGameThread();
+	if (OutputFile.IsEmpty())
+	{
+		OutputFile = FPaths::Combine(OutputDir, FString::Printf(TEXT("DataReplay-%s.json"), *FDateTime::Now().ToString()));
+	}
+
+	if (!FFileHelper::SaveStringToFile(JsonText, *OutputFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		AddError(FString::Printf(TEXT("Cannot write %s"), *OutputFile));
+		return false;
+	}
+
+	UE_LOG(LogDataReplay, Log, TEXT("[ReplayBenchmark] Results written to %s"), *FPaths::ConvertRelativePathToFull(OutputFile));
+	return true;
+}
+
+// ========== DISPOSITION MÉMOIRE ==========
+
+/**
+ * Ancien stockage contre structure de tableaux, avec la même recherche de segment (curseur, bonds, dichotomie)
+ * Les lignes sont allouées une à une comme celles d'un DataTable : dans l'ordre des temps (import frais),
+ * puis dans un ordre mélangé (tas fragmenté, lignes réimportées ou éditées).
+ * Les compteurs matériels ne sont pas portables : le nombre de lignes de cache distinctes lues par un parcours complet
+ * est calculé à partir des adresses, la différence de temps mesurée en donne l'effet.
+ */
+class FTrajectoryLayoutPerfRunner
+{
+public:
+	explicit FTrajectoryLayoutPerfRunner(FAutomationTestBase& InTest)
+		: Test(InTest)
+	{
+	}
+
+	void Run(int32 SampleCount, TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>& Json)
+	{
+		FTrajectorySampleBuffer Samples;
+		FTrajectoryCompressedSamples::MakeSyntheticFlight(SampleCount, 100.0f, SampleCount, Samples);
+
+		const int32 Calls = FMath::Max(CVarReplayBenchmarkEvaluations.GetValueOnGameThread(), 1);
+		const float StartTime = Samples.GetStartTime();
+		const float Duration = Samples.GetEndTime() - StartTime;
+
+		TArray<float> SequentialTimes;
+		TArray<float> RandomTimes;
+		SequentialTimes.SetNumUninitialized(Calls);
+		RandomTimes.SetNumUninitialized(Calls);
+		FRandomStream Random(Calls);
+		for (int32 i = 0; i < Calls; i++)
+		{
+			SequentialTimes[i] = StartTime + i * (Duration / Calls);
+			RandomTimes[i] = StartTime + Random.FRand() * Duration;
+		}
+
+		Json.WriteObjectStart();
+		Json.WriteValue(TEXT("samples"), SampleCount);
+
+		// Structure de tableaux
+		{
+			Json.WriteObjectStart(TEXT("soa"));
+			int32 Cursor = 0;
+			Json.WriteValue(TEXT("sequential_ns_per_call"), TimeCalls(SequentialTimes, [&Samples, &Cursor](float Time) { return Samples.EvaluatePosition(Time, Cursor); }));
+			Cursor = 0;
+			Json.WriteValue(TEXT("random_seek_ns_per_call"), TimeCalls(RandomTimes, [&Samples, &Cursor](float Time) { return Samples.EvaluatePosition(Time, Cursor); }));
+			Json.WriteValue(TEXT("full_scan_ns_per_sample"), TimeScan(SampleCount, [&Samples](int32 Index) { return Samples.GetPosition(Index); }));
+
+			// Quatre colonnes contiguës de floats
+			const int64 CacheLines = 4 * FMath::DivideAndRoundUp<int64>(static_cast<int64>(SampleCount) * sizeof(float), PLATFORM_CACHE_LINE_SIZE);
+			Json.WriteValue(TEXT("full_scan_cache_lines"), CacheLines);
+			Json.WriteObjectEnd();
+
+			UE_LOG(LogDataReplay, Log, TEXT("[LayoutBenchmark] %d samples, SoA: %lld cache lines per full scan"), SampleCount, CacheLines);
+		}
+
+		// Lignes allouées dans l'ordre des temps, puis dans un ordre mélangé
+		for (const bool bShuffled : { false, true })
+		{
+			TArray<FDroneWaypointRow*> Rows;
+			AllocateRows(Samples, bShuffled, Rows);
+
+			Json.WriteObjectStart(bShuffled ? TEXT("rows_shuffled") : TEXT("rows"));
+			int32 Cursor = 0;
+			Json.WriteValue(TEXT("sequential_ns_per_call"), TimeCalls(SequentialTimes, [&Rows, &Cursor](float Time) { return EvaluateRows(Rows, Time, Cursor); }));
+			Cursor = 0;
+			Json.WriteValue(TEXT("random_seek_ns_per_call"), TimeCalls(RandomTimes, [&Rows, &Cursor](float Time) { return EvaluateRows(Rows, Time, Cursor); }));
+			Json.WriteValue(TEXT("full_scan_ns_per_sample"), TimeScan(SampleCount, [&Rows](int32 Index) { return FVector(Rows[Index]->X, Rows[Index]->Y, Rows[Index]->Z); }));
+
+			const int64 CacheLines = CountRowCacheLines(Rows);
+			Json.WriteValue(TEXT("full_scan_cache_lines"), CacheLines);
+			Json.WriteObjectEnd();
+
+			UE_LOG(LogDataReplay, Log, TEXT("[LayoutBenchmark] %d samples, %s rows: %lld cache lines per full scan"),
+				SampleCount, bShuffled ? TEXT("shuffled") : TEXT("ordered"), CacheLines);
+
+			FreeRows(Rows);
+		}
+
+		Json.WriteObjectEnd();
+	}
+
+private:
+	// Une allocation par ligne, comme UDataTable::AddRow
+	static void AllocateRows(const FTrajectorySampleBuffer& Samples, bool bShuffled, TArray<FDroneWaypointRow*>& OutRows)
+	{
+		const int32 Count = Samples.Num();
+		TArray<int32> AllocationOrder;
+		AllocationOrder.SetNumUninitialized(Count);
+		for (int32 i = 0; i < Count; i++)
+		{
+			AllocationOrder[i] = i;
+		}
+		if (bShuffled)
+		{
+			FRandomStream Random(Count);
+			for (int32 i = Count - 1; i > 0; i--)
+			{
+				AllocationOrder.Swap(i, Random.RandRange(0, i));
+			}
+		}
+
+		OutRows.SetNumZeroed(Count);
+		for (const int32 Index : AllocationOrder)
+		{
+			FDroneWaypointRow* Row = new (FMemory::Malloc(sizeof(FDroneWaypointRow), alignof(FDroneWaypointRow))) FDroneWaypointRow();
+			Row->Time = Samples.Times[Index];
+			Row->X = Samples.PosX[Index];
+			Row->Y = Samples.PosY[Index];
+			Row->Z = Samples.PosZ[Index];
+			OutRows[Index] = Row;
+		}
+	}
+
+	static void FreeRows(TArray<FDroneWaypointRow*>& Rows)
+	{
+		for (FDroneWaypointRow* Row : Rows)
+		{
+			Row->~FDroneWaypointRow();
+			FMemory::Free(Row);
+		}
+		Rows.Reset();
+	}
+
+	// Tableau de pointeurs et lignes distinctes touchées en lisant toutes les lignes
+	static int64 CountRowCacheLines(const TArray<FDroneWaypointRow*>& Rows)
+	{
+		TSet<UPTRINT> Lines;
+		Lines.Reserve(Rows.Num());
+		for (const FDroneWaypointRow* Row : Rows)
+		{
+			const UPTRINT First = reinterpret_cast<UPTRINT>(&Row->Time) / PLATFORM_CACHE_LINE_SIZE;
+			const UPTRINT Last = (reinterpret_cast<UPTRINT>(&Row->Z) + sizeof(float) - 1) / PLATFORM_CACHE_LINE_SIZE;
+			for (UPTRINT Line = First; Line <= Last; Line++)
+			{
+				Lines.Add(Line);
+			}
+		}
+		return Lines.Num() + FMath::DivideAndRoundUp<int64>(static_cast<int64>(Rows.Num()) * sizeof(FDroneWaypointRow*), PLATFORM_CACHE_LINE_SIZE);
+	}
+
+	// Même recherche que FTrajectorySampleBuffer::FindSegmentInRange, chaque temps lu à travers le pointeur de sa ligne
+	static FVector EvaluateRows(const TArray<FDroneWaypointRow*>& Rows, float Time, int32& InOutCursor)
+	{
+		const int32 LastIndex = Rows.Num() - 1;
+		if (Time <= Rows[0]->Time)
+		{
+			return FVector(Rows[0]->X, Rows[0]->Y, Rows[0]->Z);
+		}
+		if (Time >= Rows[LastIndex]->Time)
+		{
+			return FVector(Rows[LastIndex]->X, Rows[LastIndex]->Y, Rows[LastIndex]->Z);
+		}
+
+		int32 Low = FMath::Clamp(InOutCursor, 0, LastIndex - 1);
+		if (!(Rows[Low]->Time < Time && Time <= Rows[Low + 1]->Time))
+		{
+			int32 High;
+			int32 Step = 1;
+			if (Time > Rows[Low + 1]->Time)
+			{
+				Low = Low + 1;
+				High = FMath::Min(Low + Step, LastIndex);
+				while (Rows[High]->Time < Time)
+				{
+					Low = High;
+					Step *= 2;
+					High = FMath::Min(Low + Step, LastIndex);
+				}
+			}
+			else
+			{
+				High = Low;
+				Low = FMath::Max(High - Step, 0);
+				while (Rows[Low]->Time >= Time)
+				{
+					High = Low;
+					Step *= 2;
+					Low = FMath::Max(High - Step, 0);
+				}
+			}
+
+			while (High - Low > 1)
+			{
+				const int32 Mid = Low + (High - Low) / 2;
+				if (Rows[Mid]->Time < Time)
+				{
+					Low = Mid;
+				}
+				else
+				{
+					High = Mid;
+				}
+			}
+		}
+		InOutCursor = Low;
+
+		const FDroneWaypointRow* A = Rows[Low];
+		const FDroneWaypointRow* B = Rows[Low + 1];
+		const float TimeDelta = B->Time - A->Time;
+		const float Alpha = TimeDelta > 0.0f ? (Time - A->Time) / TimeDelta : 0.0f;
+		return FMath::Lerp(FVector(A->X, A->Y, A->Z), FVector(B->X, B->Y, B->Z), Alpha);
+	}
+
+	// Coût moyen d'une évaluation (nanosecondes)
+	template <typename FEvaluate>
+	double TimeCalls(const TArray<float>& Times, FEvaluate&& Evaluate)
+	{
+		FVector Sum = FVector::ZeroVector;
+		const double Start = FPlatformTime::Seconds();
+		for (const float Time : Times)
+		{
+			Sum += Evaluate(Time);
+		}
+		const double Seconds = FPlatformTime::Seconds() - Start;
+
+		Test.TestFalse(TEXT("Evaluated positions are finite"), Sum.ContainsNaN());
+		return Seconds * 1.0e9 / FMath::Max(Times.Num(), 1);
+	}
+
+	// Lecture de toutes les positions, comme la construction de la ligne de trajectoire (nanosecondes par échantillon)
+	template <typename FGetPosition>
+	double TimeScan(int32 Count, FGetPosition&& GetPosition)
+	{
+		FVector Sum = FVector::ZeroVector;
+		const double Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Count; i++)
+		{
+			Sum += GetPosition(i);
+		}
+		const double Seconds = FPlatformTime::Seconds() - Start;
+
+		Test.TestFalse(TEXT("Scanned positions are finite"), Sum.ContainsNaN());
+		return Seconds * 1.0e9 / FMath::Max(Count, 1);
+	}
+
+	FAutomationTestBase& Test;
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrajectoryLayoutPerformanceTest, "DataReplay.Performance.Layout",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FTrajectoryLayoutPerformanceTest::RunTest(const FString& Parameters)
+{
+	FString JsonText;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Json = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&JsonText);
+
+	Json->WriteObjectStart();
+	Json->WriteValue(TEXT("benchmark"), TEXT("DataReplay.Performance.Layout"));
+	Json->WriteValue(TEXT("date"), FDateTime::UtcNow().ToIso8601());
+	Json->WriteValue(TEXT("build_configuration"), LexToString(FApp::GetBuildConfiguration()));
+	Json->WriteValue(TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+	Json->WriteValue(TEXT("evaluations_per_pattern"), FMath::Max(CVarReplayBenchmarkEvaluations.GetValueOnGameThread(), 1));
+
+	// De 1M échantillons jusqu'à DataReplay.Benchmark.MaxSamples (au moins 1M)
+	Json->WriteArrayStart(TEXT("results"));
+	FTrajectoryLayoutPerfRunner Runner(*this);
+	const int32 MaxSamples = FMath::Max(CVarReplayBenchmarkMaxSamples.GetValueOnGameThread(), 1000 * 1000);
+	for (int32 SampleCount = 1000 * 1000; SampleCount <= MaxSamples; SampleCount *= 10)
+	{
+		UE_LOG(LogDataReplay, Log, TEXT("[LayoutBenchmark] Measuring %d samples"), SampleCount);
+		Runner.Run(SampleCount, *Json);
+
+		if (SampleCount > MAX_int32 / 10)
+		{
+			break;
+		}
+	}
+	Json->WriteArrayEnd();
+	Json->WriteObjectEnd();
+	Json->Close();
+
+	FString OutputFile = CVarReplayBenchmarkOutputFile.GetValueOnGameThread();
+	OutputFile = OutputFile.IsEmpty()
+		? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), FString::Printf(TEXT("DataReplayLayout-%s.json"), *FDateTime::Now().ToString()))
+		: FPaths::Combine(FPaths::GetPath(OutputFile), FPaths::GetBaseFilename(OutputFile) + TEXT("-Layout.json"));
+
+	if (!FFileHelper::SaveStringToFile(JsonText, *OutputFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		AddError(FString::Printf(TEXT("Cannot write %s"), *OutputFile));
+		return false;
+	}
+
+	UE_LOG(LogDataReplay, Log, TEXT("[LayoutBenchmark] Results written to %s"), *FPaths::ConvertRelativePathToFull(OutputFile));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
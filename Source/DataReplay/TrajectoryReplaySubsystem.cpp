@@ -0,0 +1,368 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryReplaySubsystem.h"
+#include "TrajectoryReplayActor.h"
+#include "DataReplay.h"
+#include "Async/ParallelFor.h"
+#include "EngineUtils.h"
+
+namespace TrajectoryReplaySubsystem
+{
+	// En dessous, l'évaluation reste sur le thread de jeu (le coût de répartition dépasse le gain)
+	constexpr int32 MinActorsPerBatch = 64;
+}
+
+UTrajectoryReplaySubsystem::UTrajectoryReplaySubsystem()
+{
+	ClockTime = 0.0;
+	ClockRate = 1.0f;
+	bClockPaused = false;
+	LastUpdateMilliseconds = 0.0f;
+	BatchLoadMemoryBudgetMB = 1024.0f;
+}
+
+bool UTrajectoryReplaySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UTrajectoryReplaySubsystem::Deinitialize()
+{
+	// Les tâches lisent les sources des acteurs : les attendre avant que le monde ne soit détruit
+	BatchLoader.Reset();
+	BatchActors.Reset();
+
+	RegisteredActors.Reset();
+	TickedActors.Reset();
+	EvaluatedActors.Reset();
+	EvaluatedPositions.Reset();
+	SpatialIndex.Reset();
+	IndexedActors.Reset();
+	IndexedRevisions.Reset();
+	SharedGeoReference = FTrajectoryGeoReference();
+
+	Super::Deinitialize();
+}
+
+// ========== REPÈRE GÉODÉSIQUE PARTAGÉ ==========
+
+bool UTrajectoryReplaySubsystem::GetSharedGeoOrigin(FTrajectoryGeoPosition& OutOrigin) const
+{
+	if (!SharedGeoReference.IsValid())
+	{
+		return false;
+	}
+	OutOrigin = SharedGeoReference.GetOrigin();
+	return true;
+}
+
+const FTrajectoryGeoReference& UTrajectoryReplaySubsystem::ShareGeoReference(const FTrajectoryGeoReference& Candidate)
+{
+	if (!SharedGeoReference.IsValid() && Candidate.IsValid())
+	{
+		SharedGeoReference = Candidate;
+		const FTrajectoryGeoPosition& Origin = SharedGeoReference.GetOrigin();
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryReplaySubsystem] Shared geodetic origin: %.8f, %.8f, %.3f m"), Origin.Latitude, Origin.Longitude, Origin.Altitude);
+	}
+	return SharedGeoReference;
+}
+
+// ========== CHARGEMENT PAR LOTS ==========
+
+void UTrajectoryReplaySubsystem::SetBatchLoadMemoryBudget(float BudgetMB)
+{
+	BatchLoadMemoryBudgetMB = FMath::Max(BudgetMB, 16.0f);
+}
+
+float UTrajectoryReplaySubsystem::GetBatchLoadProgress() const
+{
+	return BatchLoader.IsValid() ? BatchLoader->GetProgress() : 1.0f;
+}
+
+int32 UTrajectoryReplaySubsystem::RequestBatchLoad(ATrajectoryReplayActor* Actor, const FTrajectoryLoadRequest& Request)
+{
+	// Les acteurs qui chargent pendant la même période partagent un lot (et son budget)
+	if (!BatchLoader.IsValid())
+	{
+		FTrajectoryBatchLoader::FSettings Settings;
+		Settings.MemoryBudgetBytes = static_cast<int64>(BatchLoadMemoryBudgetMB * 1024.0 * 1024.0);
+		BatchLoader = MakeUnique<FTrajectoryBatchLoader>(Settings);
+	}
+
+	const int32 MissionIndex = BatchLoader->AddMission(Request);
+	BatchActors.Add(MissionIndex, Actor);
+	return MissionIndex;
+}
+
+void UTrajectoryReplaySubsystem::CancelBatchLoad(int32 MissionIndex)
+{
+	if (BatchLoader.IsValid() && BatchActors.Remove(MissionIndex) > 0)
+	{
+		BatchLoader->CancelMission(MissionIndex);
+	}
+}
+
+void UTrajectoryReplaySubsystem::PumpBatchLoads()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Load);
+
+	FTrajectoryBatchResult Result;
+	while (BatchLoader->DequeueResult(Result))
+	{
+		TWeakObjectPtr<ATrajectoryReplayActor> Actor;
+		if (BatchActors.RemoveAndCopyValue(Result.MissionIndex, Actor) && Actor.IsValid())
+		{
+			Actor->FinishBatchLoad(Result.bSucceeded, MoveTemp(Result.Samples));
+		}
+	}
+
+	// Lot terminé : bilan, puis un nouveau lot pour les prochains chargements
+	if (BatchLoader->IsDone())
+	{
+		BatchLoader->LogSummary();
+		BatchLoader.Reset();
+		BatchActors.Reset();
+	}
+}
+
+// ========== REQUÊTES SPATIO-TEMPORELLES ==========
+
+void UTrajectoryReplaySubsystem::UpdateSpatialIndex()
+{
+	// Trajectoires en mémoire (un fichier paginé n'a que ses tronçons résidents et n'est pas indexé)
+	TArray<ATrajectoryReplayActor*> Actors;
+	for (TActorIterator<ATrajectoryReplayActor> It(GetWorld()); It; ++It)
+	{
+		if (It->TrajectorySamples.Num() >= 2)
+		{
+			Actors.Add(*It);
+		}
+	}
+
+	bool bChanged = Actors.Num() != IndexedActors.Num();
+	for (int32 Index = 0; !bChanged && Index < Actors.Num(); Index++)
+	{
+		const ATrajectoryReplayActor* Actor = Actors[Index];
+		bChanged = IndexedActors[Index].Get() != Actor || IndexedRevisions[Index] != Actor->TrajectoryDataRevision;
+	}
+
+	if (bChanged)
+	{
+		RebuildSpatialIndex();
+	}
+}
+
+void UTrajectoryReplaySubsystem::RebuildSpatialIndex()
+{
+	SpatialIndex.Reset();
+	IndexedActors.Reset();
+	IndexedRevisions.Reset();
+
+	for (TActorIterator<ATrajectoryReplayActor> It(GetWorld()); It; ++It)
+	{
+		const FTrajectorySampleBuffer& Samples = It->TrajectorySamples;
+		if (Samples.Num() >= 2)
+		{
+			SpatialIndex.AddTrajectory(Samples, 0, Samples.Num());
+			IndexedActors.Add(*It);
+			IndexedRevisions.Add(It->TrajectoryDataRevision);
+		}
+	}
+
+	SpatialIndex.Build();
+}
+
+void UTrajectoryReplaySubsystem::ResolveActors(TArray<FTrajectoryQueryHit>& Hits) const
+{
+	for (FTrajectoryQueryHit& Hit : Hits)
+	{
+		Hit.Actor = IndexedActors[Hit.TrajectoryIndex].Get();
+	}
+}
+
+void UTrajectoryReplaySubsystem::ResolveActors(TArray<FTrajectorySeparationEvent>& Events) const
+{
+	for (FTrajectorySeparationEvent& Event : Events)
+	{
+		Event.ActorA = IndexedActors[Event.TrajectoryA].Get();
+		Event.ActorB = IndexedActors[Event.TrajectoryB].Get();
+	}
+}
+
+TArray<FTrajectoryQueryHit> UTrajectoryReplaySubsystem::FindTrajectoriesNearPoint(FVector Center, float Radius, float StartTime, float EndTime)
+{
+	UpdateSpatialIndex();
+
+	TArray<FTrajectoryQueryHit> Hits;
+	SpatialIndex.QuerySphere(Center, Radius, StartTime, EndTime, Hits);
+	ResolveActors(Hits);
+	return Hits;
+}
+
+TArray<FTrajectoryQueryHit> UTrajectoryReplaySubsystem::FindTrajectoriesInBox(FBox Box, float StartTime, float EndTime)
+{
+	UpdateSpatialIndex();
+
+	TArray<FTrajectoryQueryHit> Hits;
+	SpatialIndex.QueryBox(Box, StartTime, EndTime, Hits);
+	ResolveActors(Hits);
+	return Hits;
+}
+
+TArray<FTrajectorySeparationEvent> UTrajectoryReplaySubsystem::FindSeparationViolations(float MinSeparation, float StartTime, float EndTime)
+{
+	UpdateSpatialIndex();
+
+	TArray<FTrajectorySeparationEvent> Events;
+	SpatialIndex.QuerySeparation(MinSeparation, StartTime, EndTime, Events);
+	ResolveActors(Events);
+	return Events;
+}
+
+// ========== HORLOGE PARTAGÉE ==========
+
+void UTrajectoryReplaySubsystem::SetClockRate(float InClockRate)
+{
+	ClockRate = FMath::Max(InClockRate, 0.0f);
+}
+
+void UTrajectoryReplaySubsystem::SetClockPaused(bool bPaused)
+{
+	bClockPaused = bPaused;
+}
+
+// ========== CONTRÔLE DE LA FLOTTE ==========
+
+// Les commandes diffusent les événements des acteurs : parcourir une copie de la liste
+
+void UTrajectoryReplaySubsystem::PlayAll()
+{
+	const TArray<ATrajectoryReplayActor*> Actors = RegisteredActors;
+	for (ATrajectoryReplayActor* Actor : Actors)
+	{
+		if (IsStillRegistered(Actor))
+		{
+			Actor->Play();
+		}
+	}
+}
+
+void UTrajectoryReplaySubsystem::PauseAll()
+{
+	const TArray<ATrajectoryReplayActor*> Actors = RegisteredActors;
+	for (ATrajectoryReplayActor* Actor : Actors)
+	{
+		if (IsStillRegistered(Actor))
+		{
+			Actor->Pause();
+		}
+	}
+}
+
+void UTrajectoryReplaySubsystem::SeekAllToTime(float TimeInSeconds)
+{
+	const TArray<ATrajectoryReplayActor*> Actors = RegisteredActors;
+	for (ATrajectoryReplayActor* Actor : Actors)
+	{
+		if (IsStillRegistered(Actor))
+		{
+			Actor->SeekToTime(TimeInSeconds);
+		}
+	}
+}
+
+// ========== ENREGISTREMENT ==========
+
+void UTrajectoryReplaySubsystem::RegisterActor(ATrajectoryReplayActor* Actor)
+{
+	if (Actor)
+	{
+		RegisteredActors.AddUnique(Actor);
+	}
+}
+
+void UTrajectoryReplaySubsystem::UnregisterActor(ATrajectoryReplayActor* Actor)
+{
+	RegisteredActors.RemoveSingleSwap(Actor, EAllowShrinking::No);
+}
+
+bool UTrajectoryReplaySubsystem::IsStillRegistered(const ATrajectoryReplayActor* Actor)
+{
+	// Un acteur détruit reste en mémoire jusqu'au prochain ramasse-miettes, jamais pendant le Tick
+	return IsValid(Actor) && Actor->bRegisteredWithSubsystem;
+}
+
+// ========== MISE À JOUR ==========
+
+void UTrajectoryReplaySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (BatchLoader.IsValid())
+	{
+		PumpBatchLoads();
+	}
+
+	if (RegisteredActors.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_Tick);
+	const double StartTime = FPlatformTime::Seconds();
+
+	const float ClockDelta = bClockPaused ? 0.0f : DeltaTime * ClockRate;
+	ClockTime += ClockDelta;
+
+	// Les événements diffusés pendant le Tick (pause, fin de chargement...) peuvent modifier RegisteredActors
+	TickedActors.Reset();
+	TickedActors.Append(RegisteredActors);
+
+	// Passe série : chargement, visualisation et avance du temps de chaque acteur
+	EvaluatedActors.Reset();
+	for (ATrajectoryReplayActor* Actor : TickedActors)
+	{
+		if (IsStillRegistered(Actor) && Actor->AdvancePlayback(ClockDelta))
+		{
+			EvaluatedActors.Add(Actor);
+		}
+	}
+
+	// Passe parallèle : chaque acteur n'écrit que son propre curseur de segment
+	const int32 Count = EvaluatedActors.Num();
+	EvaluatedPositions.SetNumUninitialized(Count, EAllowShrinking::No);
+	{
+		SCOPE_CYCLE_COUNTER(STAT_DataReplay_Evaluate);
+		ParallelFor(TEXT("TrajectoryReplay.Evaluate"), Count, TrajectoryReplaySubsystem::MinActorsPerBatch, [this](int32 Index)
+			{
+				const ATrajectoryReplayActor* Actor = EvaluatedActors[Index];
+				EvaluatedPositions[Index] = Actor->CalculatePositionAtTime(Actor->CurrentPlaybackTime);
+			});
+	}
+
+	// Application groupée sur le thread de jeu (un acteur retiré par un événement d'un acteur suivant n'est pas replacé)
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		if (IsStillRegistered(EvaluatedActors[Index]))
+		{
+			EvaluatedActors[Index]->ApplyPosition(EvaluatedPositions[Index]);
+		}
+	}
+
+	// Événements de temps et d'état, une fois par frame et par acteur
+	for (ATrajectoryReplayActor* Actor : TickedActors)
+	{
+		if (IsStillRegistered(Actor))
+		{
+			Actor->BroadcastStateChanges();
+		}
+	}
+	TickedActors.Reset();
+
+	LastUpdateMilliseconds = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+TStatId UTrajectoryReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTrajectoryReplaySubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TrajectorySpatialIndex.h"
+#include "TrajectoryBatchLoader.h"
+#include "TrajectoryGeodetic.h"
+#include "TrajectoryReplaySubsystem.generated.h"
+
+class ATrajectoryReplayActor;
+
+/**
+ * Sous-système de relecture : une horloge partagée pour tous les acteurs de trajectoire du monde
+ * Chaque frame, le temps de chaque acteur avance en série (chargement, boucle, fin de lecture),
+ * les positions sont évaluées en une passe ParallelFor, puis appliquées en un seul lot.
+ * Les acteurs enregistrés ne tickent plus individuellement.
+ */
+UCLASS()
+class DATAREPLAY_API UTrajectoryReplaySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UTrajectoryReplaySubsystem();
+
+	// ========== HORLOGE PARTAGÉE ==========
+
+	// Multiplicateur appliqué au temps de toutes les trajectoires (en plus de leur PlaybackSpeed)
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	void SetClockRate(float InClockRate);
+
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	float GetClockRate() const { return ClockRate; }
+
+	// Suspendre l'horloge partagée : toutes les trajectoires s'arrêtent sur place
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	void SetClockPaused(bool bPaused);
+
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	bool IsClockPaused() const { return bClockPaused; }
+
+	// Temps écoulé sur l'horloge partagée (secondes)
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	float GetClockTime() const { return static_cast<float>(ClockTime); }
+
+	// ========== CONTRÔLE DE LA FLOTTE ==========
+
+	// Démarrer la lecture de tous les acteurs enregistrés
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	void PlayAll();
+
+	// Mettre en pause tous les acteurs enregistrés
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	void PauseAll();
+
+	// Placer tous les acteurs enregistrés au même temps
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	void SeekAllToTime(float TimeInSeconds);
+
+	// ========== ENREGISTREMENT ==========
+
+	void RegisterActor(ATrajectoryReplayActor* Actor);
+	void UnregisterActor(ATrajectoryReplayActor* Actor);
+
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	int32 GetNumRegisteredActors() const { return RegisteredActors.Num(); }
+
+	// Durée de la dernière mise à jour complète de la flotte (millisecondes)
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	float GetLastUpdateMilliseconds() const { return LastUpdateMilliseconds; }
+
+	// ========== REQUÊTES SPATIO-TEMPORELLES ==========
+	// Sur les trajectoires en mémoire de tous les ATrajectoryReplayActor du monde, enregistrés ou non.
+	// Les fichiers paginés ne sont pas indexés (seuls quelques tronçons sont résidents) : ces acteurs n'apparaissent jamais.
+	// L'index lit les échantillons des acteurs sans les copier ; il est reconstruit à la première requête
+	// qui suit une modification de trajectoire (chargement, direct, fichier suivi).
+	// EndTime < StartTime : jusqu'à la fin des trajectoires
+
+	// Acteurs passés à moins de Radius de Center entre StartTime et EndTime
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Query")
+	TArray<FTrajectoryQueryHit> FindTrajectoriesNearPoint(FVector Center, float Radius, float StartTime = 0.0f, float EndTime = -1.0f);
+
+	// Acteurs entrés dans Box entre StartTime et EndTime
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Query")
+	TArray<FTrajectoryQueryHit> FindTrajectoriesInBox(FBox Box, float StartTime = 0.0f, float EndTime = -1.0f);
+
+	// Paires d'acteurs passés à moins de MinSeparation l'un de l'autre au même instant
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Query")
+	TArray<FTrajectorySeparationEvent> FindSeparationViolations(float MinSeparation, float StartTime = 0.0f, float EndTime = -1.0f);
+
+	// Reconstruire l'index maintenant (par exemple après le chargement de toutes les trajectoires)
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Query")
+	void RebuildSpatialIndex();
+
+	// ========== CHARGEMENT PAR LOTS ==========
+	// Trajectoires des acteurs dont bBatchLoading est actif : chargées ensemble sur tous les cœurs,
+	// sous un budget mémoire commun, puis remises à chaque acteur pendant le Tick du sous-système
+
+	// Mémoire maximale des chargements en cours et des résultats pas encore remis aux acteurs (Mo), à partir du prochain lot
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	void SetBatchLoadMemoryBudget(float BudgetMB);
+
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	float GetBatchLoadMemoryBudget() const { return BatchLoadMemoryBudgetMB; }
+
+	// Part des trajectoires du lot en cours déjà chargées (1 sans lot en cours)
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Replay")
+	float GetBatchLoadProgress() const;
+
+	// Ajouter le chargement de la trajectoire d'un acteur au lot en cours ; renvoie l'index de sa mission
+	int32 RequestBatchLoad(ATrajectoryReplayActor* Actor, const FTrajectoryLoadRequest& Request);
+
+	// Retirer la mission d'un acteur du lot (attend sa tâche si elle est en cours)
+	void CancelBatchLoad(int32 MissionIndex);
+
+	// ========== REPÈRE GÉODÉSIQUE PARTAGÉ ==========
+	// Fichiers GPS des acteurs sans Geo Origin : le premier repère résolu dans le monde est repris par tous les suivants,
+	// sinon chaque trajectoire serait centrée sur son propre départ
+
+	// Origine WGS84 du repère partagé ; false tant qu'aucun fichier GPS n'a été chargé
+	UFUNCTION(BlueprintCallable, Category = "Trajectory Geodetic")
+	bool GetSharedGeoOrigin(FTrajectoryGeoPosition& OutOrigin) const;
+
+	const FTrajectoryGeoReference& GetSharedGeoReference() const { return SharedGeoReference; }
+
+	// Adopter Candidate comme repère partagé s'il n'y en a pas encore ; renvoie le repère partagé
+	const FTrajectoryGeoReference& ShareGeoReference(const FTrajectoryGeoReference& Candidate);
+
+	// ========== UTICKABLEWORLDSUBSYSTEM ==========
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	// Acteurs pilotés par le sous-système
+	UPROPERTY(Transient)
+	TArray<ATrajectoryReplayActor*> RegisteredActors;
+
+	// Copie de RegisteredActors parcourue pendant le Tick : les événements diffusés peuvent désenregistrer
+	// ou détruire des acteurs (réutilisée d'une frame à l'autre)
+	TArray<ATrajectoryReplayActor*> TickedActors;
+
+	// Acteurs à replacer cette frame et leurs positions (réutilisés d'une frame à l'autre)
+	TArray<ATrajectoryReplayActor*> EvaluatedActors;
+	TArray<FVector> EvaluatedPositions;
+
+	// Index des trajectoires des acteurs du monde et révision de chaque trajectoire à sa construction
+	FTrajectorySpatialIndex SpatialIndex;
+	TArray<TWeakObjectPtr<ATrajectoryReplayActor>> IndexedActors;
+	TArray<uint32> IndexedRevisions;
+
+	// Reconstruire l'index si des acteurs ont été ajoutés, supprimés ou si leur trajectoire a changé
+	// (l'index lit TrajectorySamples : il ne doit plus être interrogé une fois l'un d'eux modifié ou détruit)
+	void UpdateSpatialIndex();
+
+	// Lot de chargement en cours et acteur de chaque mission
+	TUniquePtr<FTrajectoryBatchLoader> BatchLoader;
+	TMap<int32, TWeakObjectPtr<ATrajectoryReplayActor>> BatchActors;
+	float BatchLoadMemoryBudgetMB;
+
+	// Remettre aux acteurs les trajectoires chargées, puis terminer le lot une fois vide
+	void PumpBatchLoads();
+
+	// L'acteur d'une copie de RegisteredActors est toujours valide et piloté par le sous-système
+	static bool IsStillRegistered(const ATrajectoryReplayActor* Actor);
+
+	// Renseigner les acteurs des résultats
+	void ResolveActors(TArray<FTrajectoryQueryHit>& Hits) const;
+	void ResolveActors(TArray<FTrajectorySeparationEvent>& Events) const;
+
+	// Repère commun des fichiers GPS (invalide tant qu'aucun n'a été résolu)
+	FTrajectoryGeoReference SharedGeoReference;
+
+	double ClockTime;
+	float ClockRate;
+	bool bClockPaused;
+	float LastUpdateMilliseconds;
+};
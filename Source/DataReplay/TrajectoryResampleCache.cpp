@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectoryResampleCache.h"
+#include "DataReplay.h"
+#include "TrajectorySampleBuffer.h"
+#include "TrajectoryCurve.h"
+
+void FTrajectoryResampleCache::Reset()
+{
+	PosX.Reset();
+	PosY.Reset();
+	PosZ.Reset();
+	StartTime = 0.0f;
+	Rate = 0.0f;
+}
+
+SIZE_T FTrajectoryResampleCache::GetAllocatedSize() const
+{
+	return PosX.GetAllocatedSize() + PosY.GetAllocatedSize() + PosZ.GetAllocatedSize();
+}
+
+bool FTrajectoryResampleCache::Build(const FTrajectorySampleBuffer& Samples, float InRate, const FTrajectoryCurve* Curve)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TrajectoryResampleCache::Build);
+	Reset();
+
+	if (Samples.Num() < 2 || InRate <= 0.0f)
+	{
+		return false;
+	}
+
+	// Nombre de points couvrant [Début, Fin], calculé en double pour les longues trajectoires
+	const double Duration = static_cast<double>(Samples.GetEndTime()) - Samples.GetStartTime();
+	const double GridCount = FMath::CeilToDouble(Duration * InRate) + 1.0;
+	if (GridCount > MaxGridSamples)
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectoryResample] %.0f grid samples at %.1f Hz exceed the limit of %d, cache disabled"),
+			GridCount, InRate, MaxGridSamples);
+		return false;
+	}
+
+	const int32 Count = static_cast<int32>(GridCount);
+	StartTime = Samples.GetStartTime();
+	Rate = InRate;
+	PosX.SetNumUninitialized(Count);
+	PosY.SetNumUninitialized(Count);
+	PosZ.SetNumUninitialized(Count);
+
+	// Parcours dans l'ordre : le curseur avance d'un segment au plus à chaque point
+	const bool bUseCurve = Curve && !Curve->IsEmpty();
+	int32 Cursor = 0;
+	for (int32 i = 0; i < Count; i++)
+	{
+		const float Time = static_cast<float>(StartTime + i / static_cast<double>(Rate));
+		const FVector Position = bUseCurve ? Curve->EvaluatePosition(Samples, Time, Cursor) : Samples.EvaluatePosition(Time, Cursor);
+		PosX[i] = static_cast<float>(Position.X);
+		PosY[i] = static_cast<float>(Position.Y);
+		PosZ[i] = static_cast<float>(Position.Z);
+	}
+
+	return true;
+}
+
+FTrajectoryResampleStats FTrajectoryResampleCache::ComputeStats(const FTrajectorySampleBuffer& Samples) const
+{
+	FTrajectoryResampleStats Stats;
+	Stats.Rate = Rate;
+	Stats.GridSampleCount = Num();
+	Stats.MemoryBytes = GetAllocatedSize();
+	Stats.SourceMemoryBytes = Samples.GetAllocatedSize();
+
+	if (IsEmpty() || Samples.IsEmpty())
+	{
+		return Stats;
+	}
+
+	double SumSquared = 0.0;
+	double MaxSquared = 0.0;
+	for (int32 i = 0; i < Samples.Num(); i++)
+	{
+		const double DistanceSquared = FVector::DistSquared(EvaluatePosition(Samples.Times[i]), Samples.GetPosition(i));
+		SumSquared += DistanceSquared;
+		MaxSquared = FMath::Max(MaxSquared, DistanceSquared);
+	}
+
+	Stats.MaxError = static_cast<float>(FMath::Sqrt(MaxSquared));
+	Stats.RmsError = static_cast<float>(FMath::Sqrt(SumSquared / Samples.Num()));
+	return Stats;
+}
+
+TConstArrayView<float> FTrajectoryResampleCache::GetDefaultTradeoffRates()
+{
+	static const float Rates[] = { 10.0f, 25.0f, 50.0f, 100.0f, 200.0f, 500.0f };
+	return Rates;
+}
+
+void FTrajectoryResampleCache::LogRateTradeoff(const FTrajectorySampleBuffer& Samples, const FTrajectoryCurve* Curve, TConstArrayView<float> Rates, const FString& Label)
+{
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryResample] %s: %d samples over %.2f s, source %.1f KB"),
+		*Label, Samples.Num(), Samples.GetEndTime() - Samples.GetStartTime(), Samples.GetAllocatedSize() / 1024.0);
+
+	for (const float TestRate : Rates)
+	{
+		FTrajectoryResampleCache Cache;
+		if (!Cache.Build(Samples, TestRate, Curve))
+		{
+			continue;
+		}
+
+		const FTrajectoryResampleStats Stats = Cache.ComputeStats(Samples);
+		UE_LOG(LogDataReplay, Log, TEXT("[TrajectoryResample]   %7.1f Hz: %9d points, %10.1f KB, max error %.3f, RMS error %.3f"),
+			Stats.Rate, Stats.GridSampleCount, Stats.MemoryBytes / 1024.0, Stats.MaxError, Stats.RmsError);
+	}
+}
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FTrajectorySampleBuffer;
+struct FTrajectoryCurve;
+
+/**
+ * Bilan d'un rééchantillonnage : mémoire et erreur mesurée aux échantillons d'origine
+ */
+struct FTrajectoryResampleStats
+{
+	// Fréquence de la grille (Hz)
+	float Rate = 0.0f;
+
+	// Nombre de points de la grille
+	int32 GridSampleCount = 0;
+
+	// Mémoire de la grille et du buffer d'origine (octets)
+	SIZE_T MemoryBytes = 0;
+	SIZE_T SourceMemoryBytes = 0;
+
+	// Écart maximal et quadratique moyen aux positions d'origine (unités du monde)
+	float MaxError = 0.0f;
+	float RmsError = 0.0f;
+};
+
+/**
+ * Trajectoire rééchantillonnée sur une grille de temps régulière
+ * L'évaluation ne fait ni recherche ni division : index = (t - Début) * Fréquence, puis une interpolation linéaire.
+ * Les positions de la grille viennent de la courbe (si fournie) ou de l'interpolation linéaire des échantillons.
+ */
+struct DATAREPLAY_API FTrajectoryResampleCache
+{
+	// Tableau de floats aligné sur une ligne de cache
+	using FAlignedFloatArray = TArray<float, TAlignedHeapAllocator<64>>;
+
+	// Nombre maximal de points de la grille (12 octets par point)
+	static constexpr int32 MaxGridSamples = 16 * 1024 * 1024;
+
+	/**
+	 * Construire la grille à la fréquence donnée
+	 * Renvoie false (cache vide) si la trajectoire a moins de 2 échantillons ou si la grille dépasserait MaxGridSamples
+	 */
+	bool Build(const FTrajectorySampleBuffer& Samples, float InRate, const FTrajectoryCurve* Curve = nullptr);
+
+	void Reset();
+
+	bool IsEmpty() const { return PosX.Num() == 0; }
+	int32 Num() const { return PosX.Num(); }
+	float GetRate() const { return Rate; }
+
+	// Mémoire allouée par la grille (octets)
+	SIZE_T GetAllocatedSize() const;
+
+	// Position au temps donné, bornée aux extrémités de la grille
+	FVector EvaluatePosition(float Time) const
+	{
+		// Calcul en double : près de MaxGridSamples, un float n'a plus de partie fractionnaire
+		const double GridPosition = (static_cast<double>(Time) - StartTime) * Rate;
+		if (GridPosition <= 0.0)
+		{
+			return GetGridPosition(0);
+		}
+
+		const int32 LastIndex = PosX.Num() - 1;
+		if (GridPosition >= LastIndex)
+		{
+			return GetGridPosition(LastIndex);
+		}
+
+		const int32 Index = static_cast<int32>(GridPosition);
+		const float Alpha = static_cast<float>(GridPosition - Index);
+		return FMath::Lerp(GetGridPosition(Index), GetGridPosition(Index + 1), Alpha);
+	}
+
+	// Mesurer l'écart entre la grille et les échantillons d'origine
+	FTrajectoryResampleStats ComputeStats(const FTrajectorySampleBuffer& Samples) const;
+
+	// Fréquences comparées par défaut (Hz)
+	static TConstArrayView<float> GetDefaultTradeoffRates();
+
+	// Écrire dans le log la mémoire et l'erreur obtenues pour plusieurs fréquences
+	static void LogRateTradeoff(const FTrajectorySampleBuffer& Samples, const FTrajectoryCurve* Curve, TConstArrayView<float> Rates, const FString& Label);
+
+private:
+	FVector GetGridPosition(int32 Index) const
+	{
+		return FVector(PosX[Index], PosY[Index], PosZ[Index]);
+	}
+
+	float StartTime = 0.0f;
+	float Rate = 0.0f;
+
+	FAlignedFloatArray PosX;
+	FAlignedFloatArray PosY;
+	FAlignedFloatArray PosZ;
+};
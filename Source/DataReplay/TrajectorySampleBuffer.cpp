@@ -0,0 +1,324 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectorySampleBuffer.h"
+#include "DataReplay.h"
+#include "Algo/StableSort.h"
+#include "DroneWaypointStruct.h"
+#include "Engine/DataTable.h"
+
+// ========== CONSTRUCTION ==========
+
+SIZE_T FTrajectorySampleBuffer::GetAllocatedSize() const
+{
+	return Times.GetAllocatedSize() + PosX.GetAllocatedSize() + PosY.GetAllocatedSize() + PosZ.GetAllocatedSize();
+}
+
+void FTrajectorySampleBuffer::Reset()
+{
+	Times.Reset();
+	PosX.Reset();
+	PosY.Reset();
+	PosZ.Reset();
+}
+
+void FTrajectorySampleBuffer::Reserve(int32 Count)
+{
+	Times.Reserve(Count);
+	PosX.Reserve(Count);
+	PosY.Reserve(Count);
+	PosZ.Reserve(Count);
+}
+
+void FTrajectorySampleBuffer::Empty()
+{
+	Times.Empty();
+	PosX.Empty();
+	PosY.Empty();
+	PosZ.Empty();
+}
+
+void FTrajectorySampleBuffer::SetNumUninitialized(int32 Count)
+{
+	Times.SetNumUninitialized(Count);
+	PosX.SetNumUninitialized(Count);
+	PosY.SetNumUninitialized(Count);
+	PosZ.SetNumUninitialized(Count);
+}
+
+bool FTrajectorySampleBuffer::AppendFromDataTable(const UDataTable* DataTable)
+{
+	if (DataTable == nullptr)
+	{
+		return false;
+	}
+
+	// Vérifier que le DataTable utilise bien la structure attendue
+	const UScriptStruct* RowStruct = DataTable->GetRowStruct();
+	if (RowStruct == nullptr || !RowStruct->IsChildOf(FDroneWaypointRow::StaticStruct()))
+	{
+		UE_LOG(LogDataReplay, Warning, TEXT("[TrajectorySampleBuffer] %s does not use FDroneWaypointRow as row structure!"), *DataTable->GetName());
+		return false;
+	}
+
+	// Copier chaque ligne (parcours direct de la map, sans recherche par nom)
+	const TMap<FName, uint8*>& RowMap = DataTable->GetRowMap();
+	Reserve(Num() + RowMap.Num());
+
+	for (const TPair<FName, uint8*>& RowPair : RowMap)
+	{
+		const FDroneWaypointRow* Row = reinterpret_cast<const FDroneWaypointRow*>(RowPair.Value);
+		if (Row)
+		{
+			Add(Row->Time, Row->X, Row->Y, Row->Z);
+		}
+	}
+	return true;
+}
+
+void FTrajectorySampleBuffer::Append(const FTrajectorySampleBuffer& Other, int32 FirstIndex)
+{
+	const int32 Count = Other.Num() - FirstIndex;
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	Times.Append(Other.Times.GetData() + FirstIndex, Count);
+	PosX.Append(Other.PosX.GetData() + FirstIndex, Count);
+	PosY.Append(Other.PosY.GetData() + FirstIndex, Count);
+	PosZ.Append(Other.PosZ.GetData() + FirstIndex, Count);
+}
+
+int32 FTrajectorySampleBuffer::RemoveInvalidSamples()
+{
+	// Compactage en place : on ne conserve que les échantillons finis
+	int32 WriteIndex = 0;
+	for (int32 ReadIndex = 0; ReadIndex < Times.Num(); ReadIndex++)
+	{
+		if (FMath::IsFinite(Times[ReadIndex]) && FMath::IsFinite(PosX[ReadIndex]) && FMath::IsFinite(PosY[ReadIndex]) && FMath::IsFinite(PosZ[ReadIndex]))
+		{
+			Times[WriteIndex] = Times[ReadIndex];
+			PosX[WriteIndex] = PosX[ReadIndex];
+			PosY[WriteIndex] = PosY[ReadIndex];
+			PosZ[WriteIndex] = PosZ[ReadIndex];
+			WriteIndex++;
+		}
+	}
+
+	const int32 RemovedCount = Times.Num() - WriteIndex;
+	if (RemovedCount > 0)
+	{
+		SetNumUninitialized(WriteIndex);
+	}
+	return RemovedCount;
+}
+
+bool FTrajectorySampleBuffer::IsSortedByTime() const
+{
+	for (int32 i = 1; i < Times.Num(); i++)
+	{
+		if (Times[i] < Times[i - 1])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FTrajectorySampleBuffer::SortByTime()
+{
+	SortRangeByTime(0, Num());
+}
+
+void FTrajectorySampleBuffer::SortRangeByTime(int32 First, int32 Count)
+{
+	// Les données sources sont le plus souvent déjà triées
+	bool bSorted = true;
+	for (int32 i = First + 1; i < First + Count; i++)
+	{
+		if (Times[i] < Times[i - 1])
+		{
+			bSorted = false;
+			break;
+		}
+	}
+	if (bSorted)
+	{
+		return;
+	}
+
+	// Trier une permutation d'indices, puis réordonner chaque colonne
+	TArray<int32> Order;
+	Order.SetNumUninitialized(Count);
+	for (int32 i = 0; i < Count; i++)
+	{
+		Order[i] = First + i;
+	}
+
+	Algo::StableSort(Order, [this](int32 A, int32 B)
+		{
+			return Times[A] < Times[B];
+		});
+
+	FAlignedFloatArray Sorted;
+	Sorted.SetNumUninitialized(Count);
+	auto Gather = [&Order, &Sorted, First, Count](FAlignedFloatArray& Column)
+		{
+			for (int32 i = 0; i < Count; i++)
+			{
+				Sorted[i] = Column[Order[i]];
+			}
+			FMemory::Memcpy(Column.GetData() + First, Sorted.GetData(), Count * sizeof(float));
+		};
+
+	Gather(Times);
+	Gather(PosX);
+	Gather(PosY);
+	Gather(PosZ);
+}
+
+void FTrajectorySampleBuffer::GetLoadOrder(TArray<int32>& OutOrder) const
+{
+	OutOrder.Reset(Num());
+	for (int32 i = 0; i < Num(); i++)
+	{
+		if (FMath::IsFinite(Times[i]) && FMath::IsFinite(PosX[i]) && FMath::IsFinite(PosY[i]) && FMath::IsFinite(PosZ[i]))
+		{
+			OutOrder.Add(i);
+		}
+	}
+
+	// Même tri stable que SortByTime : les temps égaux gardent l'ordre de la source
+	Algo::StableSort(OutOrder, [this](int32 A, int32 B)
+		{
+			return Times[A] < Times[B];
+		});
+}
+
+int32 FTrajectorySampleBuffer::AppendWithReorderWindow(const FTrajectorySampleBuffer& Batch, int32 ReorderWindow)
+{
+	const int32 OldCount = Num();
+	const int32 WindowFirst = FMath::Max(0, OldCount - FMath::Max(ReorderWindow, 0));
+
+	// Un échantillon plus ancien que la fenêtre ne peut plus être placé sans tout décaler : il est ignoré
+	// Fenêtre nulle : WindowFirst == OldCount, la borne est alors le dernier échantillon conservé
+	const float MinTime = (OldCount > 0) ? Times[FMath::Min(WindowFirst, OldCount - 1)] : -MAX_flt;
+
+	int32 DroppedCount = 0;
+	for (int32 i = 0; i < Batch.Num(); i++)
+	{
+		const float Time = Batch.Times[i];
+		const bool bFinite = FMath::IsFinite(Time) && FMath::IsFinite(Batch.PosX[i]) && FMath::IsFinite(Batch.PosY[i]) && FMath::IsFinite(Batch.PosZ[i]);
+		if (!bFinite || Time < MinTime)
+		{
+			DroppedCount++;
+			continue;
+		}
+		Add(Time, Batch.PosX[i], Batch.PosY[i], Batch.PosZ[i]);
+	}
+
+	// Seuls la fenêtre et les nouveaux échantillons peuvent être désordonnés
+	SortRangeByTime(WindowFirst, Num() - WindowFirst);
+	return DroppedCount;
+}
+
+// ========== ÉVALUATION ==========
+
+int32 FTrajectorySampleBuffer::FindSegmentInRange(float Time, int32 First, int32 Count, int32& InOutCursor) const
+{
+	const int32 LastIndex = First + Count - 1;
+	const int32 Cursor = FMath::Clamp(InOutCursor, First, LastIndex - 1);
+	const float* TimeData = Times.GetData();
+
+	// Cas le plus fréquent en lecture : le temps est toujours dans le même segment
+	if (TimeData[Cursor] < Time && Time <= TimeData[Cursor + 1])
+	{
+		return InOutCursor = Cursor;
+	}
+
+	// Encadrer le temps par bonds exponentiels depuis le curseur, dans le sens du déplacement.
+	// Invariant : Time(Low) < Time <= Time(High)
+	int32 Low;
+	int32 High;
+	int32 Step = 1;
+
+	if (Time > TimeData[Cursor + 1])
+	{
+		// Lecture avant (ou saut vers la fin)
+		Low = Cursor + 1;
+		High = FMath::Min(Low + Step, LastIndex);
+		while (TimeData[High] < Time)
+		{
+			Low = High;
+			Step *= 2;
+			High = FMath::Min(Low + Step, LastIndex);
+		}
+	}
+	else
+	{
+		// Lecture inverse, retour au début d'une boucle ou saut en arrière
+		High = Cursor;
+		Low = FMath::Max(High - Step, First);
+		while (TimeData[Low] >= Time)
+		{
+			High = Low;
+			Step *= 2;
+			Low = FMath::Max(High - Step, First);
+		}
+	}
+
+	// Recherche dichotomique dans l'intervalle encadré
+	while (High - Low > 1)
+	{
+		const int32 Mid = Low + (High - Low) / 2;
+		if (TimeData[Mid] < Time)
+		{
+			Low = Mid;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+
+	return InOutCursor = Low;
+}
+
+FTrajectorySampleLocation FTrajectorySampleBuffer::Locate(float Time, int32& InOutCursor) const
+{
+	const int32 Count = Times.Num();
+	FTrajectorySampleLocation Location;
+
+	// Un seul point, ou temps hors de la trajectoire : bornée aux extrémités
+	if (Count <= 1 || Time <= Times[0])
+	{
+		return Location;
+	}
+	if (Time >= Times[Count - 1])
+	{
+		Location.Lower = Location.Upper = Count - 1;
+		return Location;
+	}
+
+	// Trouver les deux points entre lesquels interpoler
+	Location.Lower = FindSegment(Time, InOutCursor);
+	Location.Upper = Location.Lower + 1;
+
+	// Calculer le facteur d'interpolation linéaire (0.0 à 1.0)
+	const float TimeDelta = Times[Location.Upper] - Times[Location.Lower];
+	Location.Alpha = (TimeDelta > 0.0f) ? (Time - Times[Location.Lower]) / TimeDelta : 0.0f;
+	return Location;
+}
+
+FVector FTrajectorySampleBuffer::EvaluatePosition(float Time, int32& InOutCursor) const
+{
+	// Si aucun point n'est chargé
+	if (Times.Num() == 0)
+	{
+		return FVector::ZeroVector;
+	}
+
+	// Interpolation linéaire entre les deux points encadrants
+	const FTrajectorySampleLocation Location = Locate(Time, InOutCursor);
+	return FMath::Lerp(GetPosition(Location.Lower), GetPosition(Location.Upper), Location.Alpha);
+}
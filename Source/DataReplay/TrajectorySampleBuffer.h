@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UDataTable;
+
+/**
+ * Emplacement d'un temps entre deux échantillons : valeur = Lerp(Lower, Upper, Alpha)
+ * Calculé une fois, il sert à la position comme aux canaux de télémétrie (FTrajectoryChannelSet)
+ */
+struct FTrajectorySampleLocation
+{
+	int32 Lower = 0;
+	int32 Upper = 0;
+	float Alpha = 0.0f;
+};
+
+/**
+ * Stockage contigu des échantillons d'une trajectoire, en structure de tableaux (Time / X / Y / Z)
+ * Les données sont copiées depuis la source et appartiennent au buffer : aucune indirection
+ * vers les lignes du DataTable, et aucun pointeur invalide après un réimport
+ */
+struct DATAREPLAY_API FTrajectorySampleBuffer
+{
+	// Tableau de floats aligné sur une ligne de cache
+	using FAlignedFloatArray = TArray<float, TAlignedHeapAllocator<64>>;
+
+	// Temps en secondes, triés par ordre croissant
+	FAlignedFloatArray Times;
+
+	// Colonnes de position
+	FAlignedFloatArray PosX;
+	FAlignedFloatArray PosY;
+	FAlignedFloatArray PosZ;
+
+	// ========== ACCÈS ==========
+
+	int32 Num() const { return Times.Num(); }
+	bool IsEmpty() const { return Times.Num() == 0; }
+
+	FVector GetPosition(int32 Index) const
+	{
+		return FVector(PosX[Index], PosY[Index], PosZ[Index]);
+	}
+
+	float GetStartTime() const { return Times.Num() > 0 ? Times[0] : 0.0f; }
+	float GetEndTime() const { return Times.Num() > 0 ? Times.Last() : 0.0f; }
+
+	// Mémoire allouée par les colonnes (octets)
+	SIZE_T GetAllocatedSize() const;
+
+	// ========== CONSTRUCTION ==========
+
+	void Reset();
+	void Reserve(int32 Count);
+	void Empty();
+
+	// Redimensionner toutes les colonnes sans initialiser les nouvelles valeurs
+	void SetNumUninitialized(int32 Count);
+
+	void Add(float Time, float X, float Y, float Z)
+	{
+		Times.Add(Time);
+		PosX.Add(X);
+		PosY.Add(Y);
+		PosZ.Add(Z);
+	}
+
+	// Ajouter les lignes d'un DataTable de FDroneWaypointRow (sans tri)
+	bool AppendFromDataTable(const UDataTable* DataTable);
+
+	// Ajouter une plage d'échantillons d'un autre buffer
+	void Append(const FTrajectorySampleBuffer& Other, int32 FirstIndex = 0);
+
+	// Supprimer les échantillons dont le temps ou la position n'est pas fini ; renvoie le nombre supprimé
+	int32 RemoveInvalidSamples();
+
+	// Vérifier que les temps sont croissants
+	bool IsSortedByTime() const;
+
+	// Trier les échantillons par temps croissant (tri stable)
+	void SortByTime();
+
+	// Trier seulement les échantillons [First, First + Count)
+	void SortRangeByTime(int32 First, int32 Count);
+
+	/**
+	 * Ajouter des échantillons qui peuvent arriver légèrement en désordre, en O(nouveaux + fenêtre)
+	 * Seuls les ReorderWindow derniers échantillons existants sont re-triés avec les nouveaux ; un échantillon
+	 * plus ancien que cette fenêtre, ou non fini, est ignoré. Renvoie le nombre d'échantillons ignorés.
+	 */
+	int32 AppendWithReorderWindow(const FTrajectorySampleBuffer& Batch, int32 ReorderWindow);
+
+	// Indices des échantillons conservés par RemoveInvalidSamples puis SortByTime, dans leur ordre final
+	// (pour ranger dans le même ordre des colonnes relues plus tard depuis la même source)
+	void GetLoadOrder(TArray<int32>& OutOrder) const;
+
+	// ========== ÉVALUATION ==========
+
+	/**
+	 * Trouver le segment [i, i+1] tel que Time(i) < Time <= Time(i+1)
+	 * InOutCursor sert de point de départ et reçoit le segment trouvé : la recherche est en O(1) amorti
+	 * pendant la lecture (avant ou inverse) et en O(log n) pour un saut quelconque
+	 * Précondition : au moins 2 échantillons et Time(0) < Time < Time(N-1)
+	 */
+	int32 FindSegment(float Time, int32& InOutCursor) const
+	{
+		return FindSegmentInRange(Time, 0, Times.Num(), InOutCursor);
+	}
+
+	// Même recherche limitée aux échantillons [First, First + Count) (plusieurs trajectoires dans un même buffer)
+	int32 FindSegmentInRange(float Time, int32 First, int32 Count, int32& InOutCursor) const;
+
+	// Échantillons encadrant le temps donné (bornés aux extrémités) ; au moins un échantillon
+	FTrajectorySampleLocation Locate(float Time, int32& InOutCursor) const;
+
+	// Position interpolée linéairement au temps donné (bornée aux extrémités)
+	FVector EvaluatePosition(float Time, int32& InOutCursor) const;
+};
@@ -0,0 +1,608 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrajectorySpatialIndex.h"
+#include "DataReplay.h"
+#include "Async/ParallelFor.h"
+#include <algorithm>
+
+namespace TrajectorySpatial
+{
+	// Feuilles traitées par tâche pendant les tests exacts
+	static constexpr int32 LeavesPerBatch = 32;
+
+	// Portion d'un segment dans la fenêtre de temps : position = Start + Velocity * (t - Time0) sur [Time0, Time1]
+	struct FSpan
+	{
+		float Time0 = 0.0f;
+		float Time1 = 0.0f;
+		FVector Start = FVector::ZeroVector;
+		FVector Velocity = FVector::ZeroVector;
+
+		FVector GetPosition(float Time) const
+		{
+			return Start + Velocity * (Time - Time0);
+		}
+	};
+
+	// Découper le segment [Index, Index + 1] à la fenêtre ; faux s'il est entièrement en dehors
+	static bool MakeSpan(const FTrajectorySampleBuffer& Samples, int32 Index, float StartTime, float EndTime, FSpan& OutSpan)
+	{
+		const float T0 = Samples.Times[Index];
+		const float T1 = Samples.Times[Index + 1];
+		OutSpan.Time0 = FMath::Max(T0, StartTime);
+		OutSpan.Time1 = FMath::Min(T1, EndTime);
+		if (OutSpan.Time0 > OutSpan.Time1)
+		{
+			return false;
+		}
+
+		const FVector P0 = Samples.GetPosition(Index);
+		const FVector P1 = Samples.GetPosition(Index + 1);
+		OutSpan.Velocity = T1 > T0 ? (P1 - P0) / (T1 - T0) : FVector::ZeroVector;
+		OutSpan.Start = P0 + OutSpan.Velocity * (OutSpan.Time0 - T0);
+		return true;
+	}
+
+	/**
+	 * Mouvement relatif D(s) = Offset + Velocity * s pour s dans [0, Length]
+	 * Renvoie vrai si |D| passe sous Radius, avec le premier s sous Radius et le s de distance minimale
+	 */
+	static bool SolveApproach(const FVector& Offset, const FVector& Velocity, float Length, float Radius, float& OutEntry, float& OutClosest, float& OutDistance)
+	{
+		const double A = Velocity.SizeSquared();
+		const double B = FVector::DotProduct(Offset, Velocity);
+		const double C = Offset.SizeSquared() - static_cast<double>(Radius) * Radius;
+
+		const double Closest = A > 0.0 ? FMath::Clamp(-B / A, 0.0, static_cast<double>(Length)) : 0.0;
+		const double Distance = (Offset + Velocity * Closest).Size();
+		if (Distance > Radius)
+		{
+			return false;
+		}
+
+		// Déjà à l'intérieur au début, sinon première racine de |D|² = Radius²
+		double Entry = 0.0;
+		if (C > 0.0 && A > 0.0)
+		{
+			Entry = FMath::Clamp((-B - FMath::Sqrt(FMath::Max(B * B - A * C, 0.0))) / A, 0.0, Closest);
+		}
+
+		OutEntry = static_cast<float>(Entry);
+		OutClosest = static_cast<float>(Closest);
+		OutDistance = static_cast<float>(Distance);
+		return true;
+	}
+
+	// Premier instant de la portion dans la boîte (méthode des dalles) ; faux si elle n'y entre pas
+	static bool ClipToBox(const FSpan& Span, const FBox& Box, float& OutEntryTime)
+	{
+		double Lo = 0.0;
+		double Hi = Span.Time1 - Span.Time0;
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			const double Start = Span.Start[Axis];
+			const double Velocity = Span.Velocity[Axis];
+			if (FMath::IsNearlyZero(Velocity))
+			{
+				if (Start < Box.Min[Axis] || Start > Box.Max[Axis])
+				{
+					return false;
+				}
+				continue;
+			}
+
+			double Near = (Box.Min[Axis] - Start) / Velocity;
+			double Far = (Box.Max[Axis] - Start) / Velocity;
+			if (Near > Far)
+			{
+				Swap(Near, Far);
+			}
+			Lo = FMath::Max(Lo, Near);
+			Hi = FMath::Min(Hi, Far);
+			if (Lo > Hi)
+			{
+				return false;
+			}
+		}
+
+		OutEntryTime = Span.Time0 + static_cast<float>(Lo);
+		return true;
+	}
+
+	static float GetWindowEnd(float StartTime, float EndTime)
+	{
+		return EndTime < StartTime ? MAX_flt : EndTime;
+	}
+
+	static uint64 MakePairKey(int32 TrajectoryA, int32 TrajectoryB)
+	{
+		return (static_cast<uint64>(TrajectoryA) << 32) | static_cast<uint32>(TrajectoryB);
+	}
+
+	// Garder l'entrée la plus tôt et l'approche la plus proche d'une même trajectoire
+	static void MergeHit(TMap<int32, FTrajectoryQueryHit>& Hits, const FTrajectoryQueryHit& Hit)
+	{
+		FTrajectoryQueryHit* Existing = Hits.Find(Hit.TrajectoryIndex);
+		if (Existing == nullptr)
+		{
+			Hits.Add(Hit.TrajectoryIndex, Hit);
+			return;
+		}
+
+		Existing->EntryTime = FMath::Min(Existing->EntryTime, Hit.EntryTime);
+		if (Hit.ClosestDistance < Existing->ClosestDistance)
+		{
+			Existing->ClosestDistance = Hit.ClosestDistance;
+			Existing->ClosestTime = Hit.ClosestTime;
+		}
+	}
+
+	static void MergeEvent(TMap<uint64, FTrajectorySeparationEvent>& Events, const FTrajectorySeparationEvent& Event)
+	{
+		const uint64 Key = MakePairKey(Event.TrajectoryA, Event.TrajectoryB);
+		FTrajectorySeparationEvent* Existing = Events.Find(Key);
+		if (Existing == nullptr)
+		{
+			Events.Add(Key, Event);
+			return;
+		}
+
+		Existing->StartTime = FMath::Min(Existing->StartTime, Event.StartTime);
+		if (Event.ClosestDistance < Existing->ClosestDistance)
+		{
+			Existing->ClosestDistance = Event.ClosestDistance;
+			Existing->ClosestTime = Event.ClosestTime;
+		}
+	}
+}
+
+// ========== BOÎTES ==========
+
+void FTrajectorySpatialIndex::FBounds::Init()
+{
+	Min = FVector3f(MAX_flt);
+	Max = FVector3f(-MAX_flt);
+	TimeMin = MAX_flt;
+	TimeMax = -MAX_flt;
+}
+
+void FTrajectorySpatialIndex::FBounds::Add(const FBounds& Other)
+{
+	Min = FVector3f::Min(Min, Other.Min);
+	Max = FVector3f::Max(Max, Other.Max);
+	TimeMin = FMath::Min(TimeMin, Other.TimeMin);
+	TimeMax = FMath::Max(TimeMax, Other.TimeMax);
+}
+
+bool FTrajectorySpatialIndex::FBounds::Overlaps(const FBounds& Other) const
+{
+	return TimeMin <= Other.TimeMax && TimeMax >= Other.TimeMin
+		&& Min.X <= Other.Max.X && Max.X >= Other.Min.X
+		&& Min.Y <= Other.Max.Y && Max.Y >= Other.Min.Y
+		&& Min.Z <= Other.Max.Z && Max.Z >= Other.Min.Z;
+}
+
+// ========== CONSTRUCTION ==========
+
+int32 FTrajectorySpatialIndex::AddTrajectory(const FTrajectorySampleBuffer& Samples, int32 First, int32 Count)
+{
+	LLM_SCOPE_BYTAG(DataReplay_Derived);
+
+	check(First >= 0 && First + Count <= Samples.Num());
+
+	const int32 TrajectoryIndex = TrajectorySources.Add(&Samples);
+	for (int32 i = First; i < First + Count - 1; i++)
+	{
+		SegmentFirstSample.Add(i);
+		SegmentTrajectory.Add(TrajectoryIndex);
+	}
+
+	// Un nouvel ajout invalide le BVH jusqu'au prochain Build
+	Nodes.Reset();
+	return TrajectoryIndex;
+}
+
+void FTrajectorySpatialIndex::Reset()
+{
+	TrajectorySources.Empty();
+	SegmentFirstSample.Empty();
+	SegmentTrajectory.Empty();
+	Nodes.Empty();
+	TimeScale = 1.0f;
+}
+
+SIZE_T FTrajectorySpatialIndex::GetAllocatedSize() const
+{
+	return TrajectorySources.GetAllocatedSize()
+		+ SegmentFirstSample.GetAllocatedSize() + SegmentTrajectory.GetAllocatedSize() + Nodes.GetAllocatedSize();
+}
+
+FTrajectorySpatialIndex::FBounds FTrajectorySpatialIndex::GetSegmentBounds(int32 Trajectory, int32 FirstSample) const
+{
+	const FTrajectorySampleBuffer& Samples = *TrajectorySources[Trajectory];
+	const FVector3f P0(Samples.PosX[FirstSample], Samples.PosY[FirstSample], Samples.PosZ[FirstSample]);
+	const FVector3f P1(Samples.PosX[FirstSample + 1], Samples.PosY[FirstSample + 1], Samples.PosZ[FirstSample + 1]);
+
+	FBounds Bounds;
+	Bounds.Min = FVector3f::Min(P0, P1);
+	Bounds.Max = FVector3f::Max(P0, P1);
+	Bounds.TimeMin = Samples.Times[FirstSample];
+	Bounds.TimeMax = Samples.Times[FirstSample + 1];
+	return Bounds;
+}
+
+void FTrajectorySpatialIndex::Build()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_SpatialBuild);
+	LLM_SCOPE_BYTAG(DataReplay_Derived);
+
+	Nodes.Reset();
+	const int32 Count = SegmentFirstSample.Num();
+	if (Count == 0)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<FBuildSegment> Segments;
+	Segments.SetNumUninitialized(Count);
+	ParallelFor(TEXT("TrajectorySpatialIndex.Bounds"), Count, 4096, [this, &Segments](int32 Index)
+		{
+			FBuildSegment& Segment = Segments[Index];
+			Segment.FirstSample = SegmentFirstSample[Index];
+			Segment.Trajectory = SegmentTrajectory[Index];
+			Segment.Bounds = GetSegmentBounds(Segment.Trajectory, Segment.FirstSample);
+		});
+
+	// Vitesse moyenne : une seconde compte comme la distance parcourue en une seconde
+	double TotalLength = 0.0;
+	double TotalDuration = 0.0;
+	for (const FBuildSegment& Segment : Segments)
+	{
+		TotalLength += (Segment.Bounds.Max - Segment.Bounds.Min).Size();
+		TotalDuration += Segment.Bounds.TimeMax - Segment.Bounds.TimeMin;
+	}
+	TimeScale = TotalLength > 0.0 && TotalDuration > 0.0 ? static_cast<float>(TotalLength / TotalDuration) : 1.0f;
+
+	Nodes.Reserve(2 * FMath::DivideAndRoundUp(Count, MaxLeafSegments));
+	BuildNode(Segments, 0, Count);
+
+	// Segments dans l'ordre des feuilles
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		SegmentFirstSample[Index] = Segments[Index].FirstSample;
+		SegmentTrajectory[Index] = Segments[Index].Trajectory;
+	}
+
+	UE_LOG(LogDataReplay, Log, TEXT("[TrajectorySpatialIndex] Indexed %d segments of %d trajectories in %.1f ms (%d nodes, %.1f MB)"),
+		Count, GetNumTrajectories(), (FPlatformTime::Seconds() - StartTime) * 1000.0, Nodes.Num(), GetAllocatedSize() / (1024.0 * 1024.0));
+}
+
+int32 FTrajectorySpatialIndex::BuildNode(TArray<FBuildSegment>& Segments, int32 Begin, int32 End)
+{
+	const int32 NodeIndex = Nodes.AddDefaulted();
+
+	// Boîte du nœud et étendue des centres (le temps ramené à une distance par TimeScale)
+	FBounds Bounds;
+	Bounds.Init();
+	FVector4f CenterMin(MAX_flt, MAX_flt, MAX_flt, MAX_flt);
+	FVector4f CenterMax(-MAX_flt, -MAX_flt, -MAX_flt, -MAX_flt);
+	for (int32 i = Begin; i < End; i++)
+	{
+		const FBounds& SegmentBounds = Segments[i].Bounds;
+		Bounds.Add(SegmentBounds);
+
+		const FVector3f Center = (SegmentBounds.Min + SegmentBounds.Max) * 0.5f;
+		const FVector4f Center4(Center.X, Center.Y, Center.Z, (SegmentBounds.TimeMin + SegmentBounds.TimeMax) * 0.5f * TimeScale);
+		for (int32 Axis = 0; Axis < 4; Axis++)
+		{
+			CenterMin[Axis] = FMath::Min(CenterMin[Axis], Center4[Axis]);
+			CenterMax[Axis] = FMath::Max(CenterMax[Axis], Center4[Axis]);
+		}
+	}
+	Nodes[NodeIndex].Bounds = Bounds;
+
+	const int32 Count = End - Begin;
+	if (Count <= MaxLeafSegments)
+	{
+		Nodes[NodeIndex].FirstOrRight = Begin;
+		Nodes[NodeIndex].SegmentCount = Count;
+		return NodeIndex;
+	}
+
+	// Découpe à la médiane le long de l'axe le plus étendu
+	int32 SplitAxis = 0;
+	for (int32 Axis = 1; Axis < 4; Axis++)
+	{
+		if (CenterMax[Axis] - CenterMin[Axis] > CenterMax[SplitAxis] - CenterMin[SplitAxis])
+		{
+			SplitAxis = Axis;
+		}
+	}
+
+	const float Scale = TimeScale;
+	auto GetCenter = [SplitAxis, Scale](const FBuildSegment& Segment)
+		{
+			return SplitAxis < 3
+				? Segment.Bounds.Min[SplitAxis] + Segment.Bounds.Max[SplitAxis]
+				: (Segment.Bounds.TimeMin + Segment.Bounds.TimeMax) * Scale;
+		};
+
+	const int32 Mid = Begin + Count / 2;
+	FBuildSegment* Data = Segments.GetData();
+	std::nth_element(Data + Begin, Data + Mid, Data + End, [&GetCenter](const FBuildSegment& A, const FBuildSegment& B)
+		{
+			return GetCenter(A) < GetCenter(B);
+		});
+
+	BuildNode(Segments, Begin, Mid);
+	const int32 RightIndex = BuildNode(Segments, Mid, End);
+	Nodes[NodeIndex].FirstOrRight = RightIndex;
+	return NodeIndex;
+}
+
+void FTrajectorySpatialIndex::CollectLeaves(const FBounds& QueryBounds, TArray<int32>& OutLeaves) const
+{
+	if (Nodes.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<int32, TInlineAllocator<64>> Stack;
+	Stack.Push(0);
+	while (Stack.Num() > 0)
+	{
+		const int32 NodeIndex = Stack.Pop(EAllowShrinking::No);
+		const FNode& Node = Nodes[NodeIndex];
+		if (!Node.Bounds.Overlaps(QueryBounds))
+		{
+			continue;
+		}
+
+		if (Node.SegmentCount > 0)
+		{
+			OutLeaves.Add(NodeIndex);
+		}
+		else
+		{
+			Stack.Push(Node.FirstOrRight);
+			Stack.Push(NodeIndex + 1);
+		}
+	}
+}
+
+// ========== REQUÊTES ==========
+
+void FTrajectorySpatialIndex::QuerySphere(const FVector& Center, float Radius, float StartTime, float EndTime, TArray<FTrajectoryQueryHit>& OutHits) const
+{
+	using namespace TrajectorySpatial;
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_SpatialQuery);
+
+	OutHits.Reset();
+	EndTime = GetWindowEnd(StartTime, EndTime);
+
+	FBounds QueryBounds;
+	QueryBounds.Min = FVector3f(Center - FVector(Radius));
+	QueryBounds.Max = FVector3f(Center + FVector(Radius));
+	QueryBounds.TimeMin = StartTime;
+	QueryBounds.TimeMax = EndTime;
+
+	TArray<int32> Leaves;
+	CollectLeaves(QueryBounds, Leaves);
+
+	// Tests exacts par lots de feuilles, résultats par lot puis fusionnés
+	const int32 BatchCount = FMath::DivideAndRoundUp(Leaves.Num(), LeavesPerBatch);
+	TArray<TArray<FTrajectoryQueryHit>> BatchHits;
+	BatchHits.SetNum(BatchCount);
+	ParallelFor(TEXT("TrajectorySpatialIndex.Sphere"), BatchCount, 1, [&](int32 BatchIndex)
+		{
+			const int32 LeafEnd = FMath::Min((BatchIndex + 1) * LeavesPerBatch, Leaves.Num());
+			for (int32 LeafIndex = BatchIndex * LeavesPerBatch; LeafIndex < LeafEnd; LeafIndex++)
+			{
+				const FNode& Leaf = Nodes[Leaves[LeafIndex]];
+				for (int32 Segment = Leaf.FirstOrRight; Segment < Leaf.FirstOrRight + Leaf.SegmentCount; Segment++)
+				{
+					FSpan Span;
+					if (!MakeSpan(GetSegmentSamples(Segment), SegmentFirstSample[Segment], StartTime, EndTime, Span))
+					{
+						continue;
+					}
+
+					float Entry, Closest, Distance;
+					if (SolveApproach(Span.Start - Center, Span.Velocity, Span.Time1 - Span.Time0, Radius, Entry, Closest, Distance))
+					{
+						FTrajectoryQueryHit& Hit = BatchHits[BatchIndex].AddDefaulted_GetRef();
+						Hit.TrajectoryIndex = SegmentTrajectory[Segment];
+						Hit.EntryTime = Span.Time0 + Entry;
+						Hit.ClosestTime = Span.Time0 + Closest;
+						Hit.ClosestDistance = Distance;
+					}
+				}
+			}
+		});
+
+	TMap<int32, FTrajectoryQueryHit> Hits;
+	for (const TArray<FTrajectoryQueryHit>& Batch : BatchHits)
+	{
+		for (const FTrajectoryQueryHit& Hit : Batch)
+		{
+			MergeHit(Hits, Hit);
+		}
+	}
+
+	Hits.GenerateValueArray(OutHits);
+	OutHits.Sort([](const FTrajectoryQueryHit& A, const FTrajectoryQueryHit& B) { return A.EntryTime < B.EntryTime; });
+}
+
+void FTrajectorySpatialIndex::QueryBox(const FBox& Box, float StartTime, float EndTime, TArray<FTrajectoryQueryHit>& OutHits) const
+{
+	using namespace TrajectorySpatial;
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_SpatialQuery);
+
+	OutHits.Reset();
+	EndTime = GetWindowEnd(StartTime, EndTime);
+
+	FBounds QueryBounds;
+	QueryBounds.Min = FVector3f(Box.Min);
+	QueryBounds.Max = FVector3f(Box.Max);
+	QueryBounds.TimeMin = StartTime;
+	QueryBounds.TimeMax = EndTime;
+
+	TArray<int32> Leaves;
+	CollectLeaves(QueryBounds, Leaves);
+
+	const int32 BatchCount = FMath::DivideAndRoundUp(Leaves.Num(), LeavesPerBatch);
+	TArray<TArray<FTrajectoryQueryHit>> BatchHits;
+	BatchHits.SetNum(BatchCount);
+	ParallelFor(TEXT("TrajectorySpatialIndex.Box"), BatchCount, 1, [&](int32 BatchIndex)
+		{
+			const int32 LeafEnd = FMath::Min((BatchIndex + 1) * LeavesPerBatch, Leaves.Num());
+			for (int32 LeafIndex = BatchIndex * LeavesPerBatch; LeafIndex < LeafEnd; LeafIndex++)
+			{
+				const FNode& Leaf = Nodes[Leaves[LeafIndex]];
+				for (int32 Segment = Leaf.FirstOrRight; Segment < Leaf.FirstOrRight + Leaf.SegmentCount; Segment++)
+				{
+					FSpan Span;
+					float EntryTime;
+					if (MakeSpan(GetSegmentSamples(Segment), SegmentFirstSample[Segment], StartTime, EndTime, Span) && ClipToBox(Span, Box, EntryTime))
+					{
+						FTrajectoryQueryHit& Hit = BatchHits[BatchIndex].AddDefaulted_GetRef();
+						Hit.TrajectoryIndex = SegmentTrajectory[Segment];
+						Hit.EntryTime = EntryTime;
+						Hit.ClosestTime = EntryTime;
+						Hit.ClosestDistance = 0.0f;
+					}
+				}
+			}
+		});
+
+	TMap<int32, FTrajectoryQueryHit> Hits;
+	for (const TArray<FTrajectoryQueryHit>& Batch : BatchHits)
+	{
+		for (const FTrajectoryQueryHit& Hit : Batch)
+		{
+			MergeHit(Hits, Hit);
+		}
+	}
+
+	// L'instant d'entrée est aussi l'instant retenu pour la boîte
+	for (TPair<int32, FTrajectoryQueryHit>& Hit : Hits)
+	{
+		Hit.Value.ClosestTime = Hit.Value.EntryTime;
+	}
+
+	Hits.GenerateValueArray(OutHits);
+	OutHits.Sort([](const FTrajectoryQueryHit& A, const FTrajectoryQueryHit& B) { return A.EntryTime < B.EntryTime; });
+}
+
+void FTrajectorySpatialIndex::QuerySeparation(float MinSeparation, float StartTime, float EndTime, TArray<FTrajectorySeparationEvent>& OutEvents) const
+{
+	using namespace TrajectorySpatial;
+	SCOPE_CYCLE_COUNTER(STAT_DataReplay_SpatialQuery);
+
+	OutEvents.Reset();
+	EndTime = GetWindowEnd(StartTime, EndTime);
+
+	// Toutes les feuilles de la fenêtre de temps
+	FBounds WindowBounds;
+	WindowBounds.Min = FVector3f(-MAX_flt);
+	WindowBounds.Max = FVector3f(MAX_flt);
+	WindowBounds.TimeMin = StartTime;
+	WindowBounds.TimeMax = EndTime;
+
+	TArray<int32> Leaves;
+	CollectLeaves(WindowBounds, Leaves);
+
+	// Chaque feuille cherche ses voisines (boîte élargie de MinSeparation) ; une paire de feuilles n'est testée qu'une fois
+	const int32 BatchCount = FMath::DivideAndRoundUp(Leaves.Num(), LeavesPerBatch);
+	TArray<TMap<uint64, FTrajectorySeparationEvent>> BatchEvents;
+	BatchEvents.SetNum(BatchCount);
+	ParallelFor(TEXT("TrajectorySpatialIndex.Separation"), BatchCount, 1, [&](int32 BatchIndex)
+		{
+			TArray<int32> Neighbours;
+			const int32 LeafEnd = FMath::Min((BatchIndex + 1) * LeavesPerBatch, Leaves.Num());
+			for (int32 LeafIndex = BatchIndex * LeavesPerBatch; LeafIndex < LeafEnd; LeafIndex++)
+			{
+				const int32 LeafNode = Leaves[LeafIndex];
+				const FNode& Leaf = Nodes[LeafNode];
+
+				FBounds QueryBounds = Leaf.Bounds;
+				QueryBounds.Min -= FVector3f(MinSeparation);
+				QueryBounds.Max += FVector3f(MinSeparation);
+				QueryBounds.TimeMin = FMath::Max(QueryBounds.TimeMin, StartTime);
+				QueryBounds.TimeMax = FMath::Min(QueryBounds.TimeMax, EndTime);
+
+				Neighbours.Reset();
+				CollectLeaves(QueryBounds, Neighbours);
+
+				for (const int32 NeighbourNode : Neighbours)
+				{
+					if (NeighbourNode < LeafNode)
+					{
+						continue;
+					}
+					const FNode& Neighbour = Nodes[NeighbourNode];
+
+					for (int32 SegmentA = Leaf.FirstOrRight; SegmentA < Leaf.FirstOrRight + Leaf.SegmentCount; SegmentA++)
+					{
+						FSpan SpanA;
+						if (!MakeSpan(GetSegmentSamples(SegmentA), SegmentFirstSample[SegmentA], StartTime, EndTime, SpanA))
+						{
+							continue;
+						}
+
+						// Dans une même feuille, chaque paire de segments une seule fois
+						const int32 FirstB = NeighbourNode == LeafNode ? SegmentA + 1 : Neighbour.FirstOrRight;
+						for (int32 SegmentB = FirstB; SegmentB < Neighbour.FirstOrRight + Neighbour.SegmentCount; SegmentB++)
+						{
+							const int32 TrajectoryA = SegmentTrajectory[SegmentA];
+							const int32 TrajectoryB = SegmentTrajectory[SegmentB];
+							if (TrajectoryA == TrajectoryB)
+							{
+								continue;
+							}
+
+							FSpan SpanB;
+							if (!MakeSpan(GetSegmentSamples(SegmentB), SegmentFirstSample[SegmentB], StartTime, EndTime, SpanB))
+							{
+								continue;
+							}
+
+							// Intervalle de temps commun, sur lequel l'écart entre les deux positions est linéaire
+							const float Time0 = FMath::Max(SpanA.Time0, SpanB.Time0);
+							const float Time1 = FMath::Min(SpanA.Time1, SpanB.Time1);
+							if (Time0 > Time1)
+							{
+								continue;
+							}
+
+							float Entry, Closest, Distance;
+							if (SolveApproach(SpanA.GetPosition(Time0) - SpanB.GetPosition(Time0), SpanA.Velocity - SpanB.Velocity, Time1 - Time0, MinSeparation, Entry, Closest, Distance))
+							{
+								FTrajectorySeparationEvent Event;
+								Event.TrajectoryA = FMath::Min(TrajectoryA, TrajectoryB);
+								Event.TrajectoryB = FMath::Max(TrajectoryA, TrajectoryB);
+								Event.StartTime = Time0 + Entry;
+								Event.ClosestTime = Time0 + Closest;
+								Event.ClosestDistance = Distance;
+								MergeEvent(BatchEvents[BatchIndex], Event);
+							}
+						}
+					}
+				}
+			}
+		});
+
+	TMap<uint64, FTrajectorySeparationEvent> Events;
+	for (const TMap<uint64, FTrajectorySeparationEvent>& Batch : BatchEvents)
+	{
+		for (const TPair<uint64, FTrajectorySeparationEvent>& Event : Batch)
+		{
+			MergeEvent(Events, Event.Value);
+		}
+	}
+
+	Events.GenerateValueArray(OutEvents);
+	OutEvents.Sort([](const FTrajectorySeparationEvent& A, const FTrajectorySeparationEvent& B) { return A.StartTime < B.StartTime; });
+}
@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrajectorySampleBuffer.h"
+#include "TrajectorySpatialIndex.generated.h"
+
+class ATrajectoryReplayActor;
+
+/**
+ * Passage d'une trajectoire dans une zone (sphère ou boîte) pendant la fenêtre de temps demandée
+ */
+USTRUCT(BlueprintType)
+struct FTrajectoryQueryHit
+{
+	GENERATED_BODY()
+
+	// Acteur de la trajectoire (requêtes du sous-système ; nul pour une flotte)
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	ATrajectoryReplayActor* Actor = nullptr;
+
+	// Index de la trajectoire dans l'index (ou dans la flotte)
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	int32 TrajectoryIndex = INDEX_NONE;
+
+	// Premier instant dans la zone
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	float EntryTime = 0.0f;
+
+	// Instant et distance de l'approche la plus proche du centre (0 pour une boîte : instant d'entrée)
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	float ClosestTime = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	float ClosestDistance = 0.0f;
+};
+
+/**
+ * Deux trajectoires passées à moins de la séparation minimale l'une de l'autre au même instant
+ */
+USTRUCT(BlueprintType)
+struct FTrajectorySeparationEvent
+{
+	GENERATED_BODY()
+
+	// Acteurs des deux trajectoires (requêtes du sous-système ; nuls pour une flotte)
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	ATrajectoryReplayActor* ActorA = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	ATrajectoryReplayActor* ActorB = nullptr;
+
+	// Index des deux trajectoires (TrajectoryA < TrajectoryB)
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	int32 TrajectoryA = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	int32 TrajectoryB = INDEX_NONE;
+
+	// Premier instant sous la séparation minimale
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	float StartTime = 0.0f;
+
+	// Instant et distance de l'approche la plus proche
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	float ClosestTime = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Trajectory Query")
+	float ClosestDistance = 0.0f;
+};
+
+/**
+ * Index spatio-temporel des segments de plusieurs trajectoires
+ * Chaque segment entre deux échantillons consécutifs est borné par une boîte d'espace-temps (X, Y, Z, temps) ;
+ * un BVH de ces boîtes répond aux requêtes de proximité sans évaluer chaque trajectoire.
+ * Les tests exacts suivent l'interpolation linéaire entre échantillons et sont faits en parallèle.
+ * Les échantillons ne sont pas copiés : l'index lit les buffers passés à AddTrajectory, qui doivent rester en vie
+ * et inchangés jusqu'au prochain Reset (ou être réindexés après chaque modification).
+ */
+struct DATAREPLAY_API FTrajectorySpatialIndex
+{
+	// Segments par feuille du BVH
+	static constexpr int32 MaxLeafSegments = 8;
+
+	// ========== CONSTRUCTION ==========
+
+	// Indexer les échantillons [First, First + Count) d'un buffer trié, sans les copier ; renvoie l'index de la trajectoire
+	// Une trajectoire de moins de 2 échantillons est comptée mais n'a aucun segment
+	int32 AddTrajectory(const FTrajectorySampleBuffer& Samples, int32 First, int32 Count);
+
+	// Construire le BVH des trajectoires ajoutées
+	void Build();
+
+	void Reset();
+
+	bool IsEmpty() const { return Nodes.Num() == 0; }
+	int32 GetNumTrajectories() const { return TrajectorySources.Num(); }
+	int32 GetNumSegments() const { return SegmentFirstSample.Num(); }
+
+	// Mémoire allouée par les segments et le BVH, sans les échantillons indexés (octets)
+	SIZE_T GetAllocatedSize() const;
+
+	// ========== REQUÊTES ==========
+	// Fenêtre de temps [StartTime, EndTime] sur les temps des échantillons ; EndTime < StartTime : jusqu'à la fin
+
+	// Trajectoires passées à moins de Radius de Center entre StartTime et EndTime (une entrée par trajectoire)
+	void QuerySphere(const FVector& Center, float Radius, float StartTime, float EndTime, TArray<FTrajectoryQueryHit>& OutHits) const;
+
+	// Trajectoires entrées dans Box entre StartTime et EndTime (une entrée par trajectoire)
+	void QueryBox(const FBox& Box, float StartTime, float EndTime, TArray<FTrajectoryQueryHit>& OutHits) const;
+
+	// Paires de trajectoires passées à moins de MinSeparation l'une de l'autre au même instant (une entrée par paire)
+	void QuerySeparation(float MinSeparation, float StartTime, float EndTime, TArray<FTrajectorySeparationEvent>& OutEvents) const;
+
+private:
+	// Boîte d'espace-temps
+	struct FBounds
+	{
+		FVector3f Min;
+		float TimeMin;
+		FVector3f Max;
+		float TimeMax;
+
+		void Init();
+		void Add(const FBounds& Other);
+		bool Overlaps(const FBounds& Other) const;
+	};
+
+	// Nœud du BVH, rangé en profondeur d'abord : l'enfant gauche suit son parent
+	struct FNode
+	{
+		FBounds Bounds;
+
+		// Feuille : premier segment dans SegmentFirstSample ; nœud interne : index de l'enfant droit
+		int32 FirstOrRight = 0;
+
+		// Nombre de segments d'une feuille (0 pour un nœud interne)
+		int32 SegmentCount = 0;
+	};
+
+	// Segment en cours de construction, réordonné avec sa boîte
+	struct FBuildSegment
+	{
+		FBounds Bounds;
+		int32 FirstSample = 0;
+		int32 Trajectory = 0;
+	};
+
+	// Buffer de la trajectoire d'un segment
+	const FTrajectorySampleBuffer& GetSegmentSamples(int32 Segment) const { return *TrajectorySources[SegmentTrajectory[Segment]]; }
+
+	// Boîte d'espace-temps du segment commençant à l'échantillon donné de la trajectoire
+	FBounds GetSegmentBounds(int32 Trajectory, int32 FirstSample) const;
+
+	// Construire le sous-arbre des segments [Begin, End) et renvoyer l'index de sa racine
+	int32 BuildNode(TArray<FBuildSegment>& Segments, int32 Begin, int32 End);
+
+	// Feuilles dont la boîte recoupe la boîte donnée
+	void CollectLeaves(const FBounds& QueryBounds, TArray<int32>& OutLeaves) const;
+
+	// Buffer de chaque trajectoire (appartient à l'appelant)
+	TArray<const FTrajectorySampleBuffer*> TrajectorySources;
+
+	// Premier échantillon (dans le buffer de sa trajectoire) et trajectoire de chaque segment, dans l'ordre des feuilles après Build
+	TArray<int32> SegmentFirstSample;
+	TArray<int32> SegmentTrajectory;
+
+	TArray<FNode> Nodes;
+
+	// Vitesse (unités par seconde) qui rend le temps comparable à l'espace pour choisir l'axe de découpe
+	float TimeScale = 1.0f;
+};